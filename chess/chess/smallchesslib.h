@@ -60,6 +60,14 @@ uint32_t SCL_positionsEvaluated = 0; /**< If enabled by
                                             when AI computes its move). */
 #endif
 
+uint32_t SCL_moveStackExhausted = 0; /**< Number of positions that the last
+                                            SCL_getAIMove call had to evaluate
+                                            statically instead of searching
+                                            deeper, because the move stack (see
+                                            SCL_MOVE_STACK_SIZE) was full. Should
+                                            stay 0, else the stack is too small
+                                            for the search depth. */
+
 #ifndef SCL_CALL_WDT_RESET
 #define SCL_CALL_WDT_RESET \
     0 /**< Option that should be enabled on some
@@ -112,6 +120,41 @@ void SCL_randomBetterSeed(uint16_t seed);
 #define SCL_ALPHA_BETA 1
 #endif
 
+#ifndef SCL_BITBOARDS
+/**
+    If set, the board state additionally holds bitboards (64 bit numbers, one
+    bit per square) of white and black pieces and positions of both kings,
+    which are kept up to date by SCL_boardMakeMove and SCL_boardUndoMove. Move
+    generation and attack tests then use them together with precomputed attack
+    tables (about 5 KB of RAM), which is much faster. If you modify the board
+    array directly, call SCL_boardUpdateBitboards afterwards. Assumes a little
+    endian platform and at most one king of each color.
+  */
+#define SCL_BITBOARDS 0
+#endif
+
+#ifndef SCL_TRANSPOSITION_TABLE_SIZE
+/**
+    Number of entries (12 bytes each, must be a power of two) of the
+    transposition table in which the AI remembers values and best moves of
+    already searched positions (keyed by SCL_boardHash32). The best moves are
+    searched first when a position is seen again, which helps alpha-beta
+    pruning a lot. 0 turns the table off.
+  */
+#define SCL_TRANSPOSITION_TABLE_SIZE 0
+#endif
+
+#ifndef SCL_MOVE_STACK_SIZE
+/**
+    Number of moves (4 bytes each) AI can hold to sort them before searching
+    them, shared by all plies of the search. Must be bigger than the maximum
+    search depth in plies (including extensions). With less space the moves
+    are sorted and searched in several smaller batches, which makes pruning
+    less effective.
+  */
+#define SCL_MOVE_STACK_SIZE 256
+#endif
+
 /**
   A set of game squares as a bit array, each bit representing one game square.
   Useful for representing e.g. possible moves. To easily iterate over the set
@@ -162,7 +205,11 @@ uint8_t SCL_squareSetGetRandom(const SCL_SquareSet squareSet, SCL_RandomFunction
 #define SCL_SQUARE_SET_ITERATE(squareSet, command) \
     SCL_SQUARE_SET_ITERATE_BEGIN(squareSet){command} SCL_SQUARE_SET_ITERATE_END
 
+#if SCL_BITBOARDS
+#define SCL_BOARD_STATE_SIZE 87
+#else
 #define SCL_BOARD_STATE_SIZE 69
+#endif
 
 /**
   Represents chess board state as a string in this format:
@@ -194,7 +241,10 @@ uint8_t SCL_squareSetGetRandom(const SCL_SquareSet squareSet, SCL_RandomFunction
       the last pawn move or capture.
     - 67: Extra byte, left for storing additional info in variants. For normal
       chess this byte should always be 0.
-    - 68: The last byte is always 0 to properly terminate the string in case
+    - 68 - 85: Only present with SCL_BITBOARDS: bitboard of white pieces (8
+      bytes, little endian, bit 0 = A1), bitboard of black pieces, square of
+      white king and square of black king (255 if there is none).
+    - The last byte is always 0 to properly terminate the string in case
       someone tries to print it.
   - The state is designed so as to be simple and also print-friendly, i.e. you
     can simply print it with line break after 8 characters to get a human
@@ -213,6 +263,8 @@ typedef char SCL_Board[SCL_BOARD_STATE_SIZE];
 #define SCL_BOARD_PLY_BYTE              65
 #define SCL_BOARD_MOVE_COUNT_BYTE       66
 #define SCL_BOARD_EXTRA_BYTE            67
+#define SCL_BOARD_BITBOARDS_BYTE        68
+#define SCL_BOARD_KINGS_BYTE            84
 
 #if SCL_960_CASTLING
 #define _SCL_EXTRA_BYTE_VALUE (0 | (7 << 3)) // rooks on classic positions
@@ -220,6 +272,13 @@ typedef char SCL_Board[SCL_BOARD_STATE_SIZE];
 #define _SCL_EXTRA_BYTE_VALUE 0
 #endif
 
+#if SCL_BITBOARDS
+#define _SCL_START_STATE_BITBOARDS                                                            \
+    (char)0xff, (char)0xff, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, (char)0xff, (char)0xff, 4, 60,
+#else
+#define _SCL_START_STATE_BITBOARDS
+#endif
+
 #define SCL_BOARD_START_STATE                     \
     {82,         78,  66,  81,                    \
      75,         66,  78,  82,                    \
@@ -238,7 +297,7 @@ typedef char SCL_Board[SCL_BOARD_STATE_SIZE];
      114,        110, 98,  113,                   \
      107,        98,  110, 114,                   \
      (char)0xff, 0,   0,   _SCL_EXTRA_BYTE_VALUE, \
-     0}
+     _SCL_START_STATE_BITBOARDS 0}
 
 #define SCL_FEN_START "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1"
 
@@ -295,6 +354,14 @@ void SCL_boardDisableCastling(SCL_Board board);
 
 uint32_t SCL_boardHash32(const SCL_Board board);
 
+#if SCL_BITBOARDS
+/**
+  Recomputes the bitboards from the board array, needs to be called after the
+  array is modified other than by the library functions.
+*/
+void SCL_boardUpdateBitboards(SCL_Board board);
+#endif
+
 #define SCL_PHASE_OPENING 0
 #define SCL_PHASE_MIDGAME 1
 #define SCL_PHASE_ENDGAME 2
@@ -453,6 +520,13 @@ void SCL_boardGetPseudoMoves(
 */
 void SCL_boardGetMoves(SCL_Board board, uint8_t pieceSquare, SCL_SquareSet result);
 
+/**
+  Counts all positions reachable from given position in exactly depth plies
+  (promotions to each piece count as separate moves). Useful for testing
+  correctness and measuring speed of the move generation.
+*/
+uint32_t SCL_boardPerft(SCL_Board board, uint8_t depth);
+
 static inline uint8_t SCL_boardWhitesTurn(SCL_Board board);
 
 static inline uint8_t SCL_pieceIsWhite(char piece);
@@ -670,6 +744,21 @@ int16_t SCL_getAIMove(
     uint8_t* resultTo,
     char* resultProm);
 
+/**
+  Function that returns current time in arbitrary units (e.g. milliseconds).
+*/
+typedef uint32_t (*SCL_TimeFunction)(void);
+
+/**
+  Sets a time limit for SCL_getAIMove, with timeLimit given in units of
+  timeFunc. With a time limit set, AI searches iteratively deeper up to the
+  requested depth and when time runs out, it returns the best move of the
+  deepest finished search. Searches up to minDepth (at least 1, plus the
+  endgame extra depth in endgame) always finish regardless of the time.
+  Passing 0 as timeFunc removes the limit.
+*/
+void SCL_setAITimeLimit(SCL_TimeFunction timeFunc, uint32_t timeLimit, uint8_t minDepth);
+
 /**
   Function that prints out a single character. This is passed to printing
   functions.
@@ -919,6 +1008,10 @@ void SCL_boardInit(SCL_Board board) {
 #if SCL_960_CASTLING
     _SCL_board960RememberRookPositions(board);
 #endif
+
+#if SCL_BITBOARDS
+    SCL_boardUpdateBitboards(board);
+#endif
 }
 
 void _SCL_boardPlaceOnNthAvailable(SCL_Board board, uint8_t pos, char piece) {
@@ -992,6 +1085,10 @@ void SCL_boardInit960(SCL_Board board, uint16_t positionNumber) {
 #else
     SCL_boardDisableCastling(board);
 #endif
+
+#if SCL_BITBOARDS
+    SCL_boardUpdateBitboards(board);
+#endif
 }
 
 uint8_t SCL_boardsDiffer(SCL_Board b1, SCL_Board b2) {
@@ -1301,11 +1398,169 @@ void SCL_recordApply(const SCL_Record r, SCL_Board b, uint16_t moves) {
     }
 }
 
+#if SCL_BITBOARDS
+#include <string.h>
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#error "SCL_BITBOARDS needs a little endian platform"
+#endif
+
+#if defined(__GNUC__)
+#define _SCL_BITSCAN_LOW(b)  ((uint8_t)__builtin_ctzll(b))
+#define _SCL_BITSCAN_HIGH(b) ((uint8_t)(63 - __builtin_clzll(b)))
+#else
+uint8_t _SCL_bitScanLow(uint64_t b) {
+    uint8_t result = 0;
+
+    while(!(b & 0x01)) {
+        b >>= 1;
+        result++;
+    }
+
+    return result;
+}
+
+uint8_t _SCL_bitScanHigh(uint64_t b) {
+    uint8_t result = 63;
+
+    while(!(b & (((uint64_t)1) << 63))) {
+        b <<= 1;
+        result--;
+    }
+
+    return result;
+}
+
+#define _SCL_BITSCAN_LOW(b)  _SCL_bitScanLow(b)
+#define _SCL_BITSCAN_HIGH(b) _SCL_bitScanHigh(b)
+#endif
+
+/*
+  Attack tables: squares attacked by a knight and by a king standing on given
+  square and rays from given square to the board edge in directions N, E, NE,
+  NW (in which square numbers increase), S, W, SW and SE. Directions with bit 1
+  of the index set are diagonal.
+*/
+uint64_t _SCL_knightAttacks[SCL_BOARD_SQUARES];
+uint64_t _SCL_kingAttacks[SCL_BOARD_SQUARES];
+uint64_t _SCL_rays[8][SCL_BOARD_SQUARES];
+uint8_t _SCL_bitboardTablesReady = 0;
+
+void _SCL_bitboardTablesInit(void) {
+    const int8_t rowDirs[8] = {1, 0, 1, 1, -1, 0, -1, -1};
+    const int8_t columnDirs[8] = {0, 1, 1, -1, 0, -1, -1, 1};
+    const int8_t knightRows[8] = {1, 2, 2, 1, -1, -2, -2, -1};
+    const int8_t knightColumns[8] = {2, 1, -1, -2, -2, -1, 1, 2};
+
+    for(uint8_t square = 0; square < SCL_BOARD_SQUARES; ++square) {
+        int8_t row = square / 8, column = square % 8;
+
+        _SCL_knightAttacks[square] = 0;
+        _SCL_kingAttacks[square] = 0;
+
+        for(uint8_t d = 0; d < 8; ++d) {
+            int8_t r = row + knightRows[d], c = column + knightColumns[d];
+
+            if(r >= 0 && r < 8 && c >= 0 && c < 8)
+                _SCL_knightAttacks[square] |= ((uint64_t)1) << (r * 8 + c);
+
+            r = row + rowDirs[d];
+            c = column + columnDirs[d];
+
+            if(r >= 0 && r < 8 && c >= 0 && c < 8)
+                _SCL_kingAttacks[square] |= ((uint64_t)1) << (r * 8 + c);
+
+            _SCL_rays[d][square] = 0;
+
+            while(r >= 0 && r < 8 && c >= 0 && c < 8) {
+                _SCL_rays[d][square] |= ((uint64_t)1) << (r * 8 + c);
+                r += rowDirs[d];
+                c += columnDirs[d];
+            }
+        }
+    }
+
+    _SCL_bitboardTablesReady = 1;
+}
+
+uint64_t _SCL_boardBitboard(const SCL_Board board, uint8_t white) {
+    uint64_t result;
+
+    memcpy(&result, board + SCL_BOARD_BITBOARDS_BYTE + (white ? 0 : 8), 8);
+
+    return result;
+}
+
+/**
+  Returns squares attacked by a sliding piece on given square in directions
+  given by a bit mask (bit n = direction n in _SCL_rays).
+*/
+uint64_t _SCL_slidingAttacks(uint8_t square, uint64_t occupied, uint8_t directions) {
+    uint64_t result = 0;
+
+    for(uint8_t d = 0; d < 8; ++d, directions >>= 1)
+        if(directions & 0x01) {
+            uint64_t ray = _SCL_rays[d][square];
+            uint64_t blockers = ray & occupied;
+
+            if(blockers != 0) // cut the ray behind the first blocker
+                ray ^= _SCL_rays[d][d < 4 ? _SCL_BITSCAN_LOW(blockers) :
+                                            _SCL_BITSCAN_HIGH(blockers)];
+
+            result |= ray;
+        }
+
+    return result;
+}
+
+/**
+  Updates the bitboards and king positions after given square of the board
+  array has changed.
+*/
+void _SCL_boardUpdateSquare(SCL_Board board, uint8_t square) {
+    uint64_t bit = ((uint64_t)1) << square;
+    uint64_t white = _SCL_boardBitboard(board, 1) & ~bit;
+    uint64_t black = _SCL_boardBitboard(board, 0) & ~bit;
+    char piece = board[square];
+
+    if(piece != '.') {
+        if(SCL_pieceIsWhite(piece))
+            white |= bit;
+        else
+            black |= bit;
+    }
+
+    memcpy(board + SCL_BOARD_BITBOARDS_BYTE, &white, 8);
+    memcpy(board + SCL_BOARD_BITBOARDS_BYTE + 8, &black, 8);
+
+    for(uint8_t i = 0; i < 2; ++i) {
+        char* king = board + SCL_BOARD_KINGS_BYTE + i;
+
+        if(piece == (i ? 'k' : 'K'))
+            *king = square;
+        else if(((uint8_t)*king) == square)
+            *king = (char)255;
+    }
+}
+
+void SCL_boardUpdateBitboards(SCL_Board board) {
+    board[SCL_BOARD_KINGS_BYTE] = (char)255;
+    board[SCL_BOARD_KINGS_BYTE + 1] = (char)255;
+
+    for(uint8_t i = 0; i < SCL_BOARD_SQUARES; ++i)
+        _SCL_boardUpdateSquare(board, i);
+}
+#endif
+
 void SCL_boardUndoMove(SCL_Board board, SCL_MoveUndo moveUndo) {
 #if SCL_960_CASTLING
     char squareToNow = board[moveUndo.squareTo];
 #endif
 
+#if SCL_BITBOARDS
+    uint8_t squareFrom = moveUndo.squareFrom, squareTo = moveUndo.squareTo;
+#endif
+
     board[moveUndo.squareFrom] = board[moveUndo.squareTo];
     board[moveUndo.squareTo] = moveUndo.other & 0x7f;
     board[SCL_BOARD_PLY_BYTE]--;
@@ -1318,9 +1573,14 @@ void SCL_boardUndoMove(SCL_Board board, SCL_MoveUndo moveUndo) {
         if(moveUndo.squareTo == 0 || moveUndo.squareTo == 7)
             board[moveUndo.squareFrom] = SCL_pieceIsWhite(board[moveUndo.squareFrom]) ? 'P' : 'p';
         // ^ was promotion
-        else
+        else {
             board[(moveUndo.squareFrom / 8) * 8 + (moveUndo.enPassantCastle & 0x0f)] =
                 (board[moveUndo.squareFrom] == 'P') ? 'p' : 'P'; // was en passant
+#if SCL_BITBOARDS
+            _SCL_boardUpdateSquare(
+                board, (moveUndo.squareFrom / 8) * 8 + (moveUndo.enPassantCastle & 0x0f));
+#endif
+        }
     }
 #if !SCL_960_CASTLING
     else if(
@@ -1329,9 +1589,17 @@ void SCL_boardUndoMove(SCL_Board board, SCL_MoveUndo moveUndo) {
         if(moveUndo.squareTo == 58) {
             board[59] = '.';
             board[56] = 'r';
+#if SCL_BITBOARDS
+            _SCL_boardUpdateSquare(board, 59);
+            _SCL_boardUpdateSquare(board, 56);
+#endif
         } else if(moveUndo.squareTo == 62) {
             board[61] = '.';
             board[63] = 'r';
+#if SCL_BITBOARDS
+            _SCL_boardUpdateSquare(board, 61);
+            _SCL_boardUpdateSquare(board, 63);
+#endif
         }
     } else if(
         board[moveUndo.squareFrom] == 'K' && // white castling
@@ -1339,9 +1607,17 @@ void SCL_boardUndoMove(SCL_Board board, SCL_MoveUndo moveUndo) {
         if(moveUndo.squareTo == 2) {
             board[3] = '.';
             board[0] = 'R';
+#if SCL_BITBOARDS
+            _SCL_boardUpdateSquare(board, 3);
+            _SCL_boardUpdateSquare(board, 0);
+#endif
         } else if(moveUndo.squareTo == 6) {
             board[5] = '.';
             board[7] = 'R';
+#if SCL_BITBOARDS
+            _SCL_boardUpdateSquare(board, 5);
+            _SCL_boardUpdateSquare(board, 7);
+#endif
         }
     }
 #else // 960 castling
@@ -1353,6 +1629,11 @@ void SCL_boardUndoMove(SCL_Board board, SCL_MoveUndo moveUndo) {
 
         board[moveUndo.squareFrom] = 'k';
         board[moveUndo.squareTo] = 'r';
+
+#if SCL_BITBOARDS
+        for(uint8_t i = 58; i < 63; ++i)
+            if(i != 60) _SCL_boardUpdateSquare(board, i);
+#endif
     } else if(
         ((moveUndo.other & 0x7f) == 'R') && // white castling
         (squareToNow == '.' || SCL_pieceIsWhite(squareToNow))) {
@@ -1361,8 +1642,18 @@ void SCL_boardUndoMove(SCL_Board board, SCL_MoveUndo moveUndo) {
 
         board[moveUndo.squareFrom] = 'K';
         board[moveUndo.squareTo] = 'R';
+
+#if SCL_BITBOARDS
+        for(uint8_t i = 2; i < 7; ++i)
+            if(i != 4) _SCL_boardUpdateSquare(board, i);
+#endif
     }
 #endif
+
+#if SCL_BITBOARDS
+    _SCL_boardUpdateSquare(board, squareFrom);
+    _SCL_boardUpdateSquare(board, squareTo);
+#endif
 }
 
 /**
@@ -1435,10 +1726,18 @@ SCL_MoveUndo
             {
                 board[squareTo - 1] = rook;
                 board[squareTo + 1] = '.';
+#if SCL_BITBOARDS
+                _SCL_boardUpdateSquare(board, squareTo - 1);
+                _SCL_boardUpdateSquare(board, squareTo + 1);
+#endif
             } else if(difference == -2) // long
             {
                 board[squareTo - 2] = '.';
                 board[squareTo + 1] = rook;
+#if SCL_BITBOARDS
+                _SCL_boardUpdateSquare(board, squareTo - 2);
+                _SCL_boardUpdateSquare(board, squareTo + 1);
+#endif
             }
         }
 #else // 960 castling
@@ -1489,6 +1788,9 @@ SCL_MoveUndo
             if((columnDiff != 0) && (board[squareTo] == '.')) {
                 board[squareFrom + columnDiff] = '.';
                 moveUndo.other |= 0x80;
+#if SCL_BITBOARDS
+                _SCL_boardUpdateSquare(board, squareFrom + columnDiff);
+#endif
             }
         }
     } else if((s == 'r') || (s == 'R'))
@@ -1508,6 +1810,20 @@ SCL_MoveUndo
         board[squareFrom] = '.';
     }
 
+#if SCL_BITBOARDS
+    _SCL_boardUpdateSquare(board, squareFrom);
+    _SCL_boardUpdateSquare(board, squareTo);
+
+#if SCL_960_CASTLING
+    if(castled) {
+        uint8_t row = SCL_pieceIsWhite(s) ? 0 : 56;
+
+        for(uint8_t i = 2; i < 7; ++i)
+            if(i != 4) _SCL_boardUpdateSquare(board, row + i);
+    }
+#endif
+#endif
+
     board[SCL_BOARD_PLY_BYTE]++; // increase ply count
 
     return moveUndo;
@@ -1529,6 +1845,10 @@ void SCL_boardSetPosition(
     board[SCL_BOARD_PLY_BYTE] = ply;
     board[SCL_BOARD_MOVE_COUNT_BYTE] = moveCount;
     board[SCL_BOARD_STATE_SIZE - 1] = 0;
+
+#if SCL_BITBOARDS
+    SCL_boardUpdateBitboards(board);
+#endif
 }
 
 void SCL_squareSetAdd(SCL_SquareSet squareSet, uint8_t square) {
@@ -1588,6 +1908,58 @@ void SCL_boardCopy(const SCL_Board boardFrom, SCL_Board boardTo) {
 }
 
 uint8_t SCL_boardSquareAttacked(SCL_Board board, uint8_t square, uint8_t byWhite) {
+#if SCL_BITBOARDS
+    /* Look from the tested square for the pieces that could attack it, i.e.
+     use the attack tables in reverse. */
+
+    if(!_SCL_bitboardTablesReady) _SCL_bitboardTablesInit();
+
+    uint64_t attackers = _SCL_boardBitboard(board, byWhite);
+    uint64_t occupied = attackers | _SCL_boardBitboard(board, !byWhite);
+    uint64_t candidates = _SCL_knightAttacks[square] & attackers;
+    char piece = SCL_pieceToColor('n', byWhite);
+
+    while(candidates != 0) {
+        if(board[_SCL_BITSCAN_LOW(candidates)] == piece) return 1;
+
+        candidates &= candidates - 1;
+    }
+
+    candidates = _SCL_kingAttacks[square] & attackers;
+    piece = SCL_pieceToColor('k', byWhite);
+
+    while(candidates != 0) {
+        if(board[_SCL_BITSCAN_LOW(candidates)] == piece) return 1;
+
+        candidates &= candidates - 1;
+    }
+
+    int8_t pawnSquare = square + (byWhite ? -8 : 8);
+    uint8_t column = square % 8;
+
+    piece = SCL_pieceToColor('p', byWhite);
+
+    if(pawnSquare >= 0 && pawnSquare < SCL_BOARD_SQUARES &&
+       ((column > 0 && board[pawnSquare - 1] == piece) ||
+        (column < 7 && board[pawnSquare + 1] == piece)))
+        return 1;
+
+    char queen = SCL_pieceToColor('q', byWhite);
+    char rook = SCL_pieceToColor('r', byWhite);
+    char bishop = SCL_pieceToColor('b', byWhite);
+
+    for(uint8_t d = 0; d < 8; ++d) {
+        uint64_t blockers = _SCL_rays[d][square] & occupied;
+
+        if(blockers == 0) continue;
+
+        piece = board[d < 4 ? _SCL_BITSCAN_LOW(blockers) : _SCL_BITSCAN_HIGH(blockers)];
+
+        if(piece == queen || piece == ((d & 0x02) ? bishop : rook)) return 1;
+    }
+
+    return 0;
+#else
     const char* currentSquare = board;
 
     /* We need to place a temporary piece on the tested square in order to test if
@@ -1613,9 +1985,15 @@ uint8_t SCL_boardSquareAttacked(SCL_Board board, uint8_t square, uint8_t byWhite
 
     board[square] = previous;
     return 0;
+#endif
 }
 
 uint8_t SCL_boardCheck(SCL_Board board, uint8_t white) {
+#if SCL_BITBOARDS
+    uint8_t king = board[SCL_BOARD_KINGS_BYTE + (white ? 0 : 1)];
+
+    return king != 255 && SCL_boardSquareAttacked(board, king, !white);
+#else
     const char* square = board;
     char kingChar = white ? 'K' : 'k';
 
@@ -1623,6 +2001,7 @@ uint8_t SCL_boardCheck(SCL_Board board, uint8_t white) {
         if((*square == kingChar && SCL_boardSquareAttacked(board, i, !white))) return 1;
 
     return 0;
+#endif
 }
 
 uint8_t SCL_boardGameOver(SCL_Board board) {
@@ -1667,6 +2046,13 @@ void SCL_boardGetPseudoMoves(
     int8_t horizontalPosition = pieceSquare % 8;
     int8_t pawnOffset = -8;
 
+#if SCL_BITBOARDS
+    if(!_SCL_bitboardTablesReady) _SCL_bitboardTablesInit();
+
+    // SCL_SquareSet has the same memory layout as a little endian bitboard
+    uint64_t own = _SCL_boardBitboard(board, isWhite), attacks;
+#endif
+
     switch(piece) {
     case 'P':
         pawnOffset = 8;
@@ -1727,6 +2113,20 @@ void SCL_boardGetPseudoMoves(
     case 'B':
     case 'q': // queen
     case 'Q': {
+#if SCL_BITBOARDS
+        uint8_t directions = 0xff; // queen
+
+        if(piece == 'r' || piece == 'R')
+            directions = 0x33;
+        else if(piece == 'b' || piece == 'B')
+            directions = 0xcc;
+
+        attacks = _SCL_slidingAttacks(
+                      pieceSquare, own | _SCL_boardBitboard(board, !isWhite), directions) &
+                  ~own;
+
+        memcpy(result, &attacks, 8);
+#else
         const int8_t offsets[8] = {-8, 1, 8, -1, -7, 9, -9, 7};
         const int8_t columnDirs[8] = {0, 1, 0, -1, 1, 1, -1, -1};
 
@@ -1756,10 +2156,15 @@ void SCL_boardGetPseudoMoves(
                 }
             }
         }
+#endif
     } break;
 
     case 'n': // knight
     case 'N': {
+#if SCL_BITBOARDS
+        attacks = _SCL_knightAttacks[pieceSquare] & ~own;
+        memcpy(result, &attacks, 8);
+#else
         const int8_t offsets[4] = {6, 10, 15, 17};
         const int8_t columnsMinus[4] = {2, -2, 1, -1};
         const int8_t columnsPlus[4] = {-2, 2, -1, 1};
@@ -1782,10 +2187,15 @@ void SCL_boardGetPseudoMoves(
         checkOffsets(-, <, 0, Minus) checkOffsets(+, >=, SCL_BOARD_SQUARES, Plus)
 
 #undef checkOffsets
+#endif
     } break;
 
     case 'k': // king
     case 'K': {
+#if SCL_BITBOARDS
+        attacks = _SCL_kingAttacks[pieceSquare] & ~own;
+        memcpy(result, &attacks, 8);
+#else
         uint8_t verticalPosition = pieceSquare / 8;
 
         uint8_t u = verticalPosition != 0, d = verticalPosition != 7, l = horizontalPosition != 0,
@@ -1801,6 +2211,7 @@ void SCL_boardGetPseudoMoves(
         checkSquare(l && u, 1) checkSquare(u, 1) checkSquare(r && u, 6) checkSquare(l, 2)
             checkSquare(r, 6) checkSquare(l && d, 1) checkSquare(d, 1) checkSquare(r && d, 0)
 #undef checkSquare
+#endif
 
             // castling:
 
@@ -2003,6 +2414,42 @@ void SCL_boardGetMoves(SCL_Board board, uint8_t pieceSquare, SCL_SquareSet resul
     SCL_SQUARE_SET_ITERATE_END
 }
 
+uint32_t SCL_boardPerft(SCL_Board board, uint8_t depth) {
+    if(depth == 0) return 1;
+
+    uint32_t result = 0;
+    uint8_t white = SCL_boardWhitesTurn(board);
+
+    for(uint8_t i = 0; i < SCL_BOARD_SQUARES; ++i) {
+        char s = board[i];
+
+        if(s == '.' || SCL_pieceIsWhite(s) != white) continue;
+
+        SCL_SquareSet moves;
+
+        SCL_boardGetMoves(board, i, moves);
+
+        uint8_t promotion = (s == 'P' && i >= 48) || (s == 'p' && i < 16);
+
+        SCL_SQUARE_SET_ITERATE_BEGIN(moves)
+
+        const char* promotePiece = promotion ? "qrbn" : "q";
+
+        while(*promotePiece != 0) {
+            SCL_MoveUndo undo = SCL_boardMakeMove(board, i, iteratedSquare, *promotePiece);
+
+            result += depth == 1 ? 1 : SCL_boardPerft(board, depth - 1);
+
+            SCL_boardUndoMove(board, undo);
+            promotePiece++;
+        }
+
+        SCL_SQUARE_SET_ITERATE_END
+    }
+
+    return result;
+}
+
 uint8_t SCL_boardDead(SCL_Board board) {
     /*
     This byte represents material by bits:
@@ -2556,14 +3003,93 @@ SCL_StaticEvaluationFunction _SCL_staticEvaluationFunction;
 int16_t _SCL_currentEval;
 int8_t _SCL_depthHardLimit;
 
+SCL_TimeFunction _SCL_timeFunction = 0;
+uint32_t _SCL_timeLimit;
+uint8_t _SCL_timeMinDepth;
+uint32_t _SCL_searchStart;
+uint8_t _SCL_searchAbortable = 0;
+uint8_t _SCL_searchAborted = 0;
+uint8_t _SCL_nodeCounter = 0;
+
+void SCL_setAITimeLimit(SCL_TimeFunction timeFunc, uint32_t timeLimit, uint8_t minDepth) {
+    _SCL_timeFunction = timeFunc;
+    _SCL_timeLimit = timeLimit;
+    _SCL_timeMinDepth = minDepth;
+}
+
+/*
+  Moves waiting to be searched by _SCL_boardEvaluateDynamic, each one encoded
+  as (order score << 16) | (from square << 8) | to square. Every ply pushes its
+  moves on top of the moves of the plies above it and pops them when done, so
+  that the recursion itself doesn't need big stack frames.
+*/
+uint32_t _SCL_moveStack[SCL_MOVE_STACK_SIZE];
+uint16_t _SCL_moveStackTop = 0;
+
+#if SCL_TRANSPOSITION_TABLE_SIZE
+#define _SCL_TT_EXACT       1 ///< value is exact
+#define _SCL_TT_LOWER_BOUND 2 ///< search was cut off, value may be higher
+#define _SCL_TT_UPPER_BOUND 3 ///< no move reached alpha, value may be lower
+
+typedef struct {
+    uint32_t hash; ///< SCL_boardHash32 of the position
+    int16_t value; ///< from the point of view of the player to move
+    int8_t depth;
+    int8_t takenSquare;
+    int8_t depthHardLimit;
+    uint8_t bound; ///< 0 for an empty entry
+    uint8_t moveFrom; ///< best move found
+    uint8_t moveTo;
+} _SCL_TTEntry;
+
+_SCL_TTEntry _SCL_transpositionTable[SCL_TRANSPOSITION_TABLE_SIZE];
+
+void _SCL_transpositionTableClear(void) {
+    for(uint16_t i = 0; i < SCL_TRANSPOSITION_TABLE_SIZE; ++i)
+        _SCL_transpositionTable[i].bound = 0;
+}
+#endif
+
+/**
+  Score by which moves are ordered before being searched: captures first, most
+  valuable victims by least valuable attackers first (MVV-LVA), then queen
+  promotions, then the rest in the order of generation. If the moves lead to
+  the search horizon (horizon = 1), non-captures go first instead: they are
+  only evaluated statically, which is cheap and gives a bound by which the
+  extended search of the captures can be cut off.
+*/
+uint8_t _SCL_moveOrderScore(
+    SCL_Board board,
+    uint8_t squareFrom,
+    uint8_t squareTo,
+    uint8_t horizon) {
+    char piece = board[squareFrom];
+    uint8_t result = 0;
+
+    if(board[squareTo] != '.')
+        result = 64 + (SCL_pieceValuePositive(board[squareTo]) >> 5) -
+                 (SCL_pieceValuePositive(piece) >> 8);
+    else if(horizon)
+        return 254;
+
+    if((piece == 'P' && squareTo >= 56) || (piece == 'p' && squareTo < 8))
+        result += SCL_VALUE_QUEEN >> 5;
+
+    return result;
+}
+
 /**
   Inner recursive function for SCL_boardEvaluateDynamic. It is passed a square
   (or -1) at which last capture happened, to implement capture extension.
+  alphaBeta is the value above which the search of this position can be cut
+  off, alpha is the value the player to move already has guaranteed elsewhere
+  (both from white's point of view).
 */
 int16_t _SCL_boardEvaluateDynamic(
     SCL_Board board,
     int8_t depth,
     int16_t alphaBeta,
+    int16_t alpha,
     int8_t takenSquare) {
 #if defined(SCL_COUNT_EVALUATED_POSITIONS) && SCL_COUNT_EVALUATED_POSITIONS
     SCL_positionsEvaluated++;
@@ -2573,6 +3099,17 @@ int16_t _SCL_boardEvaluateDynamic(
     wdt_reset();
 #endif
 
+    if(_SCL_searchAbortable) {
+        /* Only check the time every few nodes, reading it may be expensive. If
+      time is up, unwind the search as fast as possible, the caller throws the
+      result away. */
+        if(!_SCL_searchAborted && (++_SCL_nodeCounter & 0x3f) == 0 &&
+           _SCL_timeFunction() - _SCL_searchStart >= _SCL_timeLimit)
+            _SCL_searchAborted = 1;
+
+        if(_SCL_searchAborted) return 0;
+    }
+
     uint8_t whitesTurn = SCL_boardWhitesTurn(board);
     int8_t valueMultiply = whitesTurn ? 1 : -1;
     int16_t bestMoveValue = -1 * SCL_EVALUATION_MAX_SCORE;
@@ -2589,104 +3126,212 @@ int16_t _SCL_boardEvaluateDynamic(
         shouldCompute = extended;
     }
 
+    /* Each ply keeps one free slot in the move stack for every ply that may
+     still follow below it, so even if the moves don't fit at once (they are
+     then sorted and searched in several batches), the search can always go
+     on. */
+    uint16_t stackBase = _SCL_moveStackTop;
+    int16_t stackCapacity = SCL_MOVE_STACK_SIZE - stackBase - (depth - 1 - _SCL_depthHardLimit);
+
 #if SCL_DEBUG_AI
     char moveStr[8];
     uint8_t debugFirst = 1;
 #endif
 
-    if(shouldCompute &&
+    if(shouldCompute && stackCapacity > 0 &&
        (positionType == SCL_POSITION_NORMAL || positionType == SCL_POSITION_CHECK)) {
+        alphaBeta *= valueMultiply;
+        alpha *= valueMultiply;
+        uint8_t end = 0; // 1: value known without search (or aborted), 2: cut off
+        uint8_t bestFrom = 0, bestTo = 0;
+        uint8_t hashFrom = 255, hashTo = 255;
+
+#if SCL_TRANSPOSITION_TABLE_SIZE
+        /* Stored values are the ones before this node's own +-1 adjustment
+         (done below, also after a table hit). The adjustments of the nodes
+         below are relative to _SCL_currentEval, which stays the same for the
+         whole life of the table (one SCL_getAIMove or SCL_boardEvaluateDynamic
+         call), so a position's value can be reused under any root move. */
+        uint32_t hash = SCL_boardHash32(board);
+        _SCL_TTEntry* entry =
+            _SCL_transpositionTable + (hash & (SCL_TRANSPOSITION_TABLE_SIZE - 1));
+
+        if(entry->bound != 0 && entry->hash == hash && entry->takenSquare == takenSquare &&
+           entry->depthHardLimit == _SCL_depthHardLimit) {
+            if(entry->depth >= depth &&
+               (entry->bound == _SCL_TT_EXACT ||
+                (entry->bound == _SCL_TT_LOWER_BOUND && entry->value > alphaBeta) ||
+                (entry->bound == _SCL_TT_UPPER_BOUND && entry->value <= alpha))) {
+                bestMoveValue = entry->value;
+                end = 1;
+            }
+
+            hashFrom = entry->moveFrom;
+            hashTo = entry->moveTo;
+        }
+#endif
+
 #if SCL_DEBUG_AI
         putchar('(');
 #endif
 
-        alphaBeta *= valueMultiply;
-        uint8_t end = 0;
-        const char* b = board;
+        int8_t depthFrom = depth;
+        SCL_SquareSet moves;
+        uint8_t movesFrom = 0;
+        uint8_t square = 0;
+
+        SCL_squareSetClear(moves);
 
         depth--;
 
-        for(uint8_t i = 0; i < SCL_BOARD_SQUARES; ++i, ++b) {
-            char s = *b;
+        while(!end) {
+            uint16_t count = 0;
+            uint32_t* batch = _SCL_moveStack + stackBase;
 
-            if(s != '.' && SCL_pieceIsWhite(s) == whitesTurn) {
-                SCL_SquareSet moves;
+            // fill the batch with as many moves as fit, in generation order
 
-                SCL_squareSetClear(moves);
+            while(count < stackCapacity) {
+                if(SCL_squareSetEmpty(moves)) {
+                    while(square < SCL_BOARD_SQUARES &&
+                          (board[square] == '.' || SCL_pieceIsWhite(board[square]) != whitesTurn))
+                        square++;
 
-                SCL_boardGetMoves(board, i, moves);
+                    if(square >= SCL_BOARD_SQUARES) break;
+
+                    movesFrom = square;
+                    SCL_boardGetMoves(board, square, moves);
+                    square++;
+                    continue;
+                }
 
-                if(!SCL_squareSetEmpty(moves)) {
-                    SCL_SQUARE_SET_ITERATE_BEGIN(moves)
+                uint8_t to = 0;
 
-                    int8_t captureExtension = -1;
+                for(uint8_t j = 0; j < 8; ++j, to += 8)
+                    if(moves[j] != 0) {
+                        uint8_t bit = 0;
 
-                    if(board[iteratedSquare] != '.' && // takes a piece
-                       (takenSquare == -1 || // extend on first taken sq.
-                        (extended && takenSquare != -1) || // ignore check extension
-                        (iteratedSquare == takenSquare))) // extend on same sq. taken
-                        captureExtension = iteratedSquare;
+                        while(!(moves[j] & (0x01 << bit))) bit++;
 
-                    SCL_MoveUndo undo = SCL_boardMakeMove(board, i, iteratedSquare, 'q');
+                        moves[j] &= ~(0x01 << bit);
+                        to += bit;
+                        break;
+                    }
+
+                uint32_t score = (movesFrom == hashFrom && to == hashTo) ?
+                                     255 :
+                                     _SCL_moveOrderScore(board, movesFrom, to, depth <= 0);
+
+                /* insertion sort by score only, so that equally scored moves
+                 stay in the order of generation */
+                uint16_t k = count;
+
+                while(k > 0 && (batch[k - 1] >> 16) < score) {
+                    batch[k] = batch[k - 1];
+                    k--;
+                }
+
+                batch[k] = (score << 16) | (((uint32_t)movesFrom) << 8) | to;
+                count++;
+            }
+
+            if(count == 0) break;
 
-                    uint8_t s0Dummy, s1Dummy;
-                    char pDummy;
+            _SCL_moveStackTop = stackBase + count;
 
-                    SCL_UNUSED(s0Dummy);
-                    SCL_UNUSED(s1Dummy);
-                    SCL_UNUSED(pDummy);
+            for(uint16_t m = 0; m < count; ++m) {
+                uint8_t from = (batch[m] >> 8) & 0xff;
+                uint8_t to = batch[m] & 0xff;
+                int8_t captureExtension = -1;
+
+                if(board[to] != '.' && // takes a piece
+                   (takenSquare == -1 || // extend on first taken sq.
+                    (extended && takenSquare != -1) || // ignore check extension
+                    (to == takenSquare))) // extend on same sq. taken
+                    captureExtension = to;
+
+                SCL_MoveUndo undo = SCL_boardMakeMove(board, from, to, 'q');
 
 #if SCL_DEBUG_AI
-                    if(debugFirst)
-                        debugFirst = 0;
-                    else
-                        putchar(',');
+                if(debugFirst)
+                    debugFirst = 0;
+                else
+                    putchar(',');
 
-                    if(extended) putchar('*');
+                if(extended) putchar('*');
 
-                    printf("%s ", SCL_moveToString(board, i, iteratedSquare, 'q', moveStr));
+                printf("%s ", SCL_moveToString(board, from, to, 'q', moveStr));
 #endif
 
-                    int16_t value = _SCL_boardEvaluateDynamic(
-                                        board,
-                                        depth, // this is depth - 1, we decremented it
+                int16_t value = _SCL_boardEvaluateDynamic(
+                                    board,
+                                    depth, // this is depth - 1, we decremented it
 #if SCL_ALPHA_BETA
-                                        valueMultiply * bestMoveValue,
+                                    valueMultiply *
+                                        (bestMoveValue > alpha ? bestMoveValue : alpha),
+                                    valueMultiply * alphaBeta,
 #else
-                                        0,
+                                    0,
+                                    0,
 #endif
-                                        captureExtension) *
-                                    valueMultiply;
+                                    captureExtension) *
+                                valueMultiply;
 
-                    SCL_boardUndoMove(board, undo);
+                SCL_boardUndoMove(board, undo);
 
-                    if(value > bestMoveValue) {
-                        bestMoveValue = value;
+                if(_SCL_searchAborted) {
+                    end = 1;
+                    break;
+                }
+
+                if(value > bestMoveValue) {
+                    bestMoveValue = value;
+                    bestFrom = from;
+                    bestTo = to;
 
 #if SCL_ALPHA_BETA
-                        // alpha-beta pruning:
+                    // alpha-beta pruning:
 
-                        if(value > alphaBeta) // no, >= can't be here
-                        {
-                            end = 1;
-                            iterationEnd = 1;
-                        }
-#endif
+                    if(value > alphaBeta) // no, >= can't be here
+                    {
+                        end = 2;
+                        break;
                     }
-
-                    SCL_SQUARE_SET_ITERATE_END
-                } // !squre set empty?
-            } // valid piece?
-
-            if(end) break;
-
-        } // for each square
+#endif
+                }
+            } // for each move in batch
+        } // while !end
+
+        _SCL_moveStackTop = stackBase;
+
+#if SCL_TRANSPOSITION_TABLE_SIZE
+        if(end != 1 &&
+           (entry->bound == 0 || entry->hash != hash || entry->depth <= depthFrom)) {
+            entry->hash = hash;
+            entry->value = bestMoveValue;
+            entry->depth = depthFrom;
+            entry->takenSquare = takenSquare;
+            entry->depthHardLimit = _SCL_depthHardLimit;
+            entry->bound = end == 2                ? _SCL_TT_LOWER_BOUND :
+                           bestMoveValue <= alpha ? _SCL_TT_UPPER_BOUND :
+                                                    _SCL_TT_EXACT;
+            entry->moveFrom = bestFrom;
+            entry->moveTo = bestTo;
+        }
+#else
+        SCL_UNUSED(bestFrom);
+        SCL_UNUSED(bestTo);
+        SCL_UNUSED(depthFrom);
+#endif
 
 #if SCL_DEBUG_AI
         putchar(')');
 #endif
     } else // don't dive recursively, evaluate statically
     {
+        if(shouldCompute && stackCapacity <= 0 &&
+           (positionType == SCL_POSITION_NORMAL || positionType == SCL_POSITION_CHECK))
+            SCL_moveStackExhausted++;
+
         bestMoveValue = valueMultiply *
 #ifndef SCL_EVALUATION_FUNCTION
                         _SCL_staticEvaluationFunction(board);
@@ -2715,21 +3360,38 @@ int16_t _SCL_boardEvaluateDynamic(
     return bestMoveValue * valueMultiply;
 }
 
-int16_t SCL_boardEvaluateDynamic(
+/*
+  SCL_boardEvaluateDynamic without setting _SCL_currentEval, for SCL_getAIMove
+  which keeps the evaluation of the root position as the reference for all
+  moves.
+*/
+int16_t _SCL_boardEvaluateDynamicFrom(
     SCL_Board board,
     uint8_t baseDepth,
     uint8_t extensionExtraDepth,
     SCL_StaticEvaluationFunction evalFunction) {
     _SCL_staticEvaluationFunction = evalFunction;
-    _SCL_currentEval = evalFunction(board);
     _SCL_depthHardLimit = 0;
     _SCL_depthHardLimit -= extensionExtraDepth;
 
-    return _SCL_boardEvaluateDynamic(
-        board,
-        baseDepth,
-        SCL_boardWhitesTurn(board) ? SCL_EVALUATION_MAX_SCORE : (-1 * SCL_EVALUATION_MAX_SCORE),
-        -1);
+    int16_t bound =
+        SCL_boardWhitesTurn(board) ? SCL_EVALUATION_MAX_SCORE : (-1 * SCL_EVALUATION_MAX_SCORE);
+
+    return _SCL_boardEvaluateDynamic(board, baseDepth, bound, -1 * bound, -1);
+}
+
+int16_t SCL_boardEvaluateDynamic(
+    SCL_Board board,
+    uint8_t baseDepth,
+    uint8_t extensionExtraDepth,
+    SCL_StaticEvaluationFunction evalFunction) {
+    _SCL_currentEval = evalFunction(board);
+
+#if SCL_TRANSPOSITION_TABLE_SIZE
+    _SCL_transpositionTableClear(); // stored values depend on _SCL_currentEval
+#endif
+
+    return _SCL_boardEvaluateDynamicFrom(board, baseDepth, extensionExtraDepth, evalFunction);
 }
 
 void SCL_boardRandomMove(
@@ -2795,8 +3457,7 @@ int16_t SCL_getAIMove(
     char* resultProm) {
 #if SCL_DEBUG_AI
     puts("===== AI debug =====");
-    putchar('(');
-    unsigned char debugFirst = 1;
+    unsigned char debugFirst;
     char moveStr[8];
 #endif
 
@@ -2809,86 +3470,140 @@ int16_t SCL_getAIMove(
 #endif
     }
 
-    if(SCL_boardEstimatePhase(board) == SCL_PHASE_ENDGAME) baseDepth += endgameExtraDepth;
+    uint8_t minDepth = _SCL_timeMinDepth;
+
+    if(SCL_boardEstimatePhase(board) == SCL_PHASE_ENDGAME) {
+        baseDepth += endgameExtraDepth;
+        minDepth += endgameExtraDepth;
+    }
 
     *resultFrom = 0;
     *resultTo = 0;
     *resultProm = 'q';
 
-    int16_t bestScore = SCL_boardWhitesTurn(board) ? -1 * SCL_EVALUATION_MAX_SCORE - 1 :
-                                                     (SCL_EVALUATION_MAX_SCORE + 1);
+    SCL_moveStackExhausted = 0;
 
-    for(uint8_t i = 0; i < SCL_BOARD_SQUARES; ++i)
-        if(board[i] != '.' && SCL_boardWhitesTurn(board) == SCL_pieceIsWhite(board[i])) {
-            SCL_SquareSet moves;
+    int16_t bestScore = 0;
 
-            SCL_squareSetClear(moves);
+    /* With a time limit search iteratively deeper, if time runs out the result
+     of the last finished iteration is used. Each iteration leaves best moves
+     in the transposition table which are then searched first by the next
+     one. */
+    uint8_t depth = baseDepth;
 
-            SCL_boardGetMoves(board, i, moves);
+#if SCL_TRANSPOSITION_TABLE_SIZE
+    _SCL_transpositionTableClear();
+#endif
+
+    /* All root moves are compared to the current position, so that the table
+     can share values between them. */
+    _SCL_currentEval = evalFunc(board);
+
+    if(_SCL_timeFunction != 0) {
+        _SCL_searchStart = _SCL_timeFunction();
+        depth = 1;
+    }
+
+    _SCL_searchAborted = 0;
+
+    for(; depth <= baseDepth; ++depth) {
+        // iterations up to minDepth (and the first one) always finish
+        _SCL_searchAbortable = _SCL_timeFunction != 0 && depth > 1 && depth > minDepth;
+
+        uint8_t iterationFrom = 0, iterationTo = 0;
+        int16_t iterationScore = SCL_boardWhitesTurn(board) ? -1 * SCL_EVALUATION_MAX_SCORE - 1 :
+                                                              (SCL_EVALUATION_MAX_SCORE + 1);
+
+#if SCL_DEBUG_AI
+        putchar('(');
+        debugFirst = 1;
+#endif
+
+        for(uint8_t i = 0; i < SCL_BOARD_SQUARES && !_SCL_searchAborted; ++i)
+            if(board[i] != '.' && SCL_boardWhitesTurn(board) == SCL_pieceIsWhite(board[i])) {
+                SCL_SquareSet moves;
+
+                SCL_squareSetClear(moves);
+
+                SCL_boardGetMoves(board, i, moves);
 
-            SCL_SQUARE_SET_ITERATE_BEGIN(moves)
+                SCL_SQUARE_SET_ITERATE_BEGIN(moves)
 
-            int16_t score = 0;
+                int16_t score = 0;
 
 #if SCL_DEBUG_AI
-            if(debugFirst)
-                debugFirst = 0;
-            else
-                putchar(',');
+                if(debugFirst)
+                    debugFirst = 0;
+                else
+                    putchar(',');
 
-            printf("%s ", SCL_moveToString(board, i, iteratedSquare, 'q', moveStr));
+                printf("%s ", SCL_moveToString(board, i, iteratedSquare, 'q', moveStr));
 
 #endif
 
-            if(i != repetitionMoveFrom || iteratedSquare != repetitionMoveTo) {
-                SCL_MoveUndo undo = SCL_boardMakeMove(board, i, iteratedSquare, 'q');
+                if(i != repetitionMoveFrom || iteratedSquare != repetitionMoveTo) {
+                    SCL_MoveUndo undo = SCL_boardMakeMove(board, i, iteratedSquare, 'q');
 
-                score =
-                    SCL_boardEvaluateDynamic(board, baseDepth - 1, extensionExtraDepth, evalFunc);
+                    score = _SCL_boardEvaluateDynamicFrom(
+                        board, depth - 1, extensionExtraDepth, evalFunc);
 
-                SCL_boardUndoMove(board, undo);
-            }
+                    SCL_boardUndoMove(board, undo);
+                }
 
-            if(randFunc != 0 && randomness > 1 && score < 16000 && score > -16000) {
-                /*^ We limit randomizing by about half the max score for two reasons:
-            to prevent over/under flows and secondly we don't want to alter
-            the highest values for checkmate -- these are modified by tiny
-            values depending on their depth so as to prevent endless loops in
-            which most moves are winning, biasing such values would completely
-            kill that algorithm */
-
-                int16_t bias = randFunc();
-                bias = (bias - 128) / 2;
-                bias *= randomness - 1;
-                score += bias;
-            }
+                if(randFunc != 0 && randomness > 1 && score < 16000 && score > -16000) {
+                    /*^ We limit randomizing by about half the max score for two reasons:
+                to prevent over/under flows and secondly we don't want to alter
+                the highest values for checkmate -- these are modified by tiny
+                values depending on their depth so as to prevent endless loops in
+                which most moves are winning, biasing such values would completely
+                kill that algorithm */
+
+                    int16_t bias = randFunc();
+                    bias = (bias - 128) / 2;
+                    bias *= randomness - 1;
+                    score += bias;
+                }
 
-            uint8_t comparison = score == bestScore;
+                uint8_t comparison = score == iterationScore;
 
-            if((comparison != 1) && ((SCL_boardWhitesTurn(board) && score > bestScore) ||
-                                     (!SCL_boardWhitesTurn(board) && score < bestScore)))
-                comparison = 2;
+                if((comparison != 1) &&
+                   ((SCL_boardWhitesTurn(board) && score > iterationScore) ||
+                    (!SCL_boardWhitesTurn(board) && score < iterationScore)))
+                    comparison = 2;
 
-            uint8_t replace = 0;
+                uint8_t replace = 0;
 
-            if(randFunc == 0)
-                replace = comparison == 2;
-            else
-                replace =
-                    (comparison == 2) ||
-                    ((comparison == 1) && (randFunc() < 160)); // not uniform distr. but simple
+                if(randFunc == 0)
+                    replace = comparison == 2;
+                else
+                    replace =
+                        (comparison == 2) ||
+                        ((comparison == 1) && (randFunc() < 160)); // not uniform distr. but simple
+
+                if(replace) {
+                    iterationFrom = i;
+                    iterationTo = iteratedSquare;
+                    iterationScore = score;
+                }
 
-            if(replace) {
-                *resultFrom = i;
-                *resultTo = iteratedSquare;
-                bestScore = score;
+                SCL_SQUARE_SET_ITERATE_END
             }
 
-            SCL_SQUARE_SET_ITERATE_END
-        }
+#if SCL_DEBUG_AI
+        printf(")%d\n", iterationScore);
+#endif
+
+        if(_SCL_searchAborted) break;
+
+        *resultFrom = iterationFrom;
+        *resultTo = iterationTo;
+        bestScore = iterationScore;
+    }
+
+    _SCL_searchAbortable = 0;
 
 #if SCL_DEBUG_AI
-    printf(")%d %s\n", bestScore, SCL_moveToString(board, *resultFrom, *resultTo, 'q', moveStr));
+    printf("%d %s\n", bestScore, SCL_moveToString(board, *resultFrom, *resultTo, 'q', moveStr));
     puts("===== AI debug end ===== ");
 #endif
 
@@ -3017,6 +3732,10 @@ uint8_t SCL_boardFromFEN(SCL_Board board, const char* string) {
         string++;
     }
 
+#if SCL_BITBOARDS
+    SCL_boardUpdateBitboards(board);
+#endif
+
 #define nextChar \
     string++;    \
     if(*string == 0) return 0;
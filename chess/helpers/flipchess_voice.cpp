@@ -3,35 +3,40 @@
 #include <furi_hal.h>
 #include "../sam/stm32_sam.h"
 STM32SAM voice;
+unsigned char voice_buffer[2048]; // PCM ring buffer played by DMA
 
 void flipchess_voice_shall_we_play() {
     if(furi_hal_speaker_is_mine() || furi_hal_speaker_acquire(1000)) {
-        voice.begin();
+        voice.beginBuffered(voice_buffer, sizeof(voice_buffer));
         voice.say("SHAAL WE PLAY AY GAME?");
+        voice.end();
         furi_hal_speaker_release();
     }
 }
 
 void flipchess_voice_which_side() {
     if(furi_hal_speaker_is_mine() || furi_hal_speaker_acquire(1000)) {
-        voice.begin();
+        voice.beginBuffered(voice_buffer, sizeof(voice_buffer));
         voice.say("WHICH SIDE DO YOU WANT?");
+        voice.end();
         furi_hal_speaker_release();
     }
 }
 
 void flipchess_voice_how_about_chess() {
     if(furi_hal_speaker_is_mine() || furi_hal_speaker_acquire(1000)) {
-        voice.begin();
+        voice.beginBuffered(voice_buffer, sizeof(voice_buffer));
         voice.say("HOW ABOUT A NICE GAME OF CHESS?");
+        voice.end();
         furi_hal_speaker_release();
     }
 }
 
 void flipchess_voice_a_strange_game() {
     if(furi_hal_speaker_is_mine() || furi_hal_speaker_acquire(1000)) {
-        voice.begin();
+        voice.beginBuffered(voice_buffer, sizeof(voice_buffer));
         voice.say("A STRANGE GAME... THE ONLY WINNING MOVE IS NOT TO PLAY.");
+        voice.end();
         furi_hal_speaker_release();
     }
 }
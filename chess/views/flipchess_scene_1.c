@@ -10,10 +10,17 @@
 #include "../helpers/flipchess_voice.h"
 #include "../helpers/flipchess_haptic.h"
 
-#define SCL_960_CASTLING        0 // setting to 1 compiles a 960 version of smolchess
-#define XBOARD_DEBUG            0 // will create files with xboard communication
-#define SCL_EVALUATION_FUNCTION SCL_boardEvaluateStatic
-#define SCL_DEBUG_AI            0
+#define SCL_960_CASTLING             0 // setting to 1 compiles a 960 version of smolchess
+#define XBOARD_DEBUG                 0 // will create files with xboard communication
+#define SCL_EVALUATION_FUNCTION      SCL_boardEvaluateStatic
+#define SCL_DEBUG_AI                 0
+#define AI_BENCHMARK                 0 // will log positions searched per second by AI
+#define SCL_TRANSPOSITION_TABLE_SIZE 512 // AI position cache, 12 bytes per entry
+#define SCL_BITBOARDS                1 // faster move generation, ~5 KB of attack tables
+
+#if AI_BENCHMARK
+#define SCL_COUNT_EVALUATED_POSITIONS 1
+#endif
 
 #include "../chess/smallchesslib.h"
 
@@ -21,6 +28,8 @@
 #define MAX_TEXT_LEN     15 // 15 = max length of text
 #define MAX_TEXT_BUF     (MAX_TEXT_LEN + 1) // max length of text + null terminator
 #define THREAD_WAIT_TIME 20 // time to wait for draw thread to finish
+#define AI_EXTRA_DEPTH   1 // AI searches this much deeper than its level...
+#define AI_TIME_LIMIT    5000 // ...while under this time (ms), level depth always finishes
 
 struct FlipChessScene1 {
     View* view;
@@ -122,9 +131,18 @@ int16_t flipchess_makeAIMove(
         }
     }
 
-    return SCL_getAIMove(
+    // the level's depth is searched fully, so the AI is never weaker than
+    // its level, the extra depth only when the time limit allows it
+    SCL_setAITimeLimit(furi_get_tick, AI_TIME_LIMIT, depth);
+
+#if AI_BENCHMARK
+    SCL_positionsEvaluated = 0;
+    uint32_t start = furi_get_tick();
+#endif
+
+    int16_t result = SCL_getAIMove(
         board,
-        depth,
+        depth + AI_EXTRA_DEPTH,
         extraDepth,
         endgameDepth,
         SCL_boardEvaluateStatic,
@@ -135,6 +153,25 @@ int16_t flipchess_makeAIMove(
         s0,
         s1,
         prom);
+
+#if AI_BENCHMARK
+    uint32_t elapsed = furi_get_tick() - start;
+    FURI_LOG_I(
+        "FlipChess",
+        "AI searched %lu positions in %lu ms (%lu/s)",
+        SCL_positionsEvaluated,
+        elapsed,
+        SCL_positionsEvaluated * 1000 / (elapsed ? elapsed : 1));
+#endif
+
+    if(SCL_moveStackExhausted) {
+        FURI_LOG_W(
+            "FlipChess",
+            "AI move stack full, %lu positions evaluated statically",
+            SCL_moveStackExhausted);
+    }
+
+    return result;
 }
 
 bool flipchess_isPlayerTurn(FlipChessScene1Model* model) {
@@ -469,6 +506,12 @@ static int flipchess_scene_1_model_init(
 
     SCL_gameInit(&(model->game), model->startState);
 
+#if AI_BENCHMARK
+    uint32_t perftStart = furi_get_tick();
+    uint32_t perft = SCL_boardPerft(model->game.board, 3);
+    FURI_LOG_I("FlipChess", "perft(3) = %lu in %lu ms", perft, furi_get_tick() - perftStart);
+#endif
+
     if(model->paramAnalyze != 255) {
         char p;
         uint8_t move[] = {0, 0};
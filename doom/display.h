@@ -3,6 +3,7 @@
 #include "constants.h"
 #include <doom_icons.h>
 #include "assets.h"
+#include "types.h"
 
 #define CHECK_BIT(var, pos) ((var) & (1 << (pos)))
 
@@ -22,7 +23,7 @@ void drawSprite(
     int16_t w,
     int16_t h,
     uint8_t sprite,
-    double distance,
+    fixed_t distance,
     Canvas* const canvas);
 void drawBitmap(
     int16_t x,
@@ -124,7 +125,8 @@ void drawTextSpace(int8_t x, int8_t y, char* txt, uint8_t space, Canvas* const c
     }
 }
 
-// Custom drawBitmap method with scale support, mask, zindex and pattern filling
+// Custom drawBitmap method with scale support, mask, zindex and pattern filling.
+// distance is Q16.16 fixed point, between 0.1 and MAX_SPRITE_DEPTH.
 void drawSprite(
     int8_t x,
     int8_t y,
@@ -133,23 +135,21 @@ void drawSprite(
     int16_t w,
     int16_t h,
     uint8_t sprite,
-    double distance,
+    fixed_t distance,
     Canvas* const canvas) {
-    uint8_t tw = (double)w / distance;
-    uint8_t th = (double)h / distance;
+    uint8_t tw = FIXED_INT(w) / distance;
+    uint8_t th = FIXED_INT(h) / distance;
     uint8_t byte_width = w / 8;
-    uint8_t pixel_size = fmax(1, (double)1.0 / (double)distance);
+    uint8_t pixel_size = FIXED_ONE / distance;
+    if(pixel_size < 1) pixel_size = 1;
     uint16_t sprite_offset = byte_width * h * sprite;
 
     bool pixel;
     bool maskPixel;
 
-    // Don't draw the whole sprite if the anchor is hidden by z buffer
-    // Not checked per pixel for performance reasons
-    if(zbuffer[(int)(fmin(fmax(x, 0), ZBUFFER_SIZE - 1) / Z_RES_DIVIDER)] <
-       distance * DISTANCE_MULTIPLIER) {
-        return;
-    }
+    // Sprite depth in z buffer units, compared against each column it covers
+    int32_t z = ((distance >> 8) * DISTANCE_MULTIPLIER) >> (FIXED_SHIFT - 8);
+    uint8_t sprite_z = z > 255 ? 255 : z;
 
     for(uint8_t ty = 0; ty < th; ty += pixel_size) {
         // Don't draw out of screen
@@ -157,10 +157,10 @@ void drawSprite(
             continue;
         }
 
-        uint8_t sy = ty * distance; // The y from the sprite
+        uint8_t sy = (ty * distance) >> FIXED_SHIFT; // The y from the sprite
 
         for(uint8_t tx = 0; tx < tw; tx += pixel_size) {
-            uint8_t sx = tx * distance; // The x from the sprite
+            uint8_t sx = (tx * distance) >> FIXED_SHIFT; // The x from the sprite
             uint16_t byte_offset = sprite_offset + sy * byte_width + sx / 8;
 
             // Don't draw out of screen
@@ -168,6 +168,11 @@ void drawSprite(
                 continue;
             }
 
+            // Don't draw the columns hidden by a closer wall
+            if(zbuffer[(x + tx) / Z_RES_DIVIDER] < sprite_z) {
+                continue;
+            }
+
             maskPixel = read_bit(pgm_read_byte(bitmap_mask + byte_offset), sx % 8);
 
             if(maskPixel) {
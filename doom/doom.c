@@ -27,6 +27,9 @@
 #define sign(a, b)          (double)(a > b ? 1 : (b > a ? -1 : 0))
 #define pgm_read_byte(addr) (*(const unsigned char*)(addr))
 
+// Camera plane x coordinate (-1 .. 1) of every rendered column
+static fixed_t camera_x_table[SCREEN_WIDTH / RES_DIVIDER];
+
 typedef enum {
     EventTypeTick,
     EventTypeKey,
@@ -467,6 +470,8 @@ void updateEntities(const uint8_t level[], Canvas* const canvas, PluginState* co
 }
 
 // The map raycaster. Based on https://lodev.org/cgtutor/raycasting.html
+// The per-column math is done in Q16.16 fixed point: the FPU of the
+// Cortex-M4 is single precision only, so double math here is emulated.
 void renderMap(
     const uint8_t level[],
     double view_height,
@@ -474,35 +479,44 @@ void renderMap(
     PluginState* const plugin_state) {
     UID last_uid = 0; // NOT SURE ?
 
+    // Convert the view once per frame
+    fixed_t pos_x = FIXED(plugin_state->player.pos.x);
+    fixed_t pos_y = FIXED(plugin_state->player.pos.y);
+    fixed_t dir_x = FIXED(plugin_state->player.dir.x);
+    fixed_t dir_y = FIXED(plugin_state->player.dir.y);
+    fixed_t plane_x = FIXED(plugin_state->player.plane.x);
+    fixed_t plane_y = FIXED(plugin_state->player.plane.y);
+    fixed_t view_height_f = FIXED(view_height);
+
     for(uint8_t x = 0; x < SCREEN_WIDTH; x += RES_DIVIDER) {
-        double camera_x = 2 * (double)x / SCREEN_WIDTH - 1;
-        double ray_x = plugin_state->player.dir.x + plugin_state->player.plane.x * camera_x;
-        double ray_y = plugin_state->player.dir.y + plugin_state->player.plane.y * camera_x;
+        fixed_t camera_x = camera_x_table[x / RES_DIVIDER];
+        fixed_t ray_x = dir_x + fixed_mul(plane_x, camera_x);
+        fixed_t ray_y = dir_y + fixed_mul(plane_y, camera_x);
         uint8_t map_x = (uint8_t)plugin_state->player.pos.x;
         uint8_t map_y = (uint8_t)plugin_state->player.pos.y;
         Coords map_coords = {plugin_state->player.pos.x, plugin_state->player.pos.y};
-        double delta_x = fabs(1 / ray_x);
-        double delta_y = fabs(1 / ray_y);
+        fixed_t delta_x = fixed_inv_abs(ray_x);
+        fixed_t delta_y = fixed_inv_abs(ray_y);
 
         int8_t step_x;
         int8_t step_y;
-        double side_x;
-        double side_y;
+        fixed_t side_x;
+        fixed_t side_y;
 
         if(ray_x < 0) {
             step_x = -1;
-            side_x = (plugin_state->player.pos.x - map_x) * delta_x;
+            side_x = fixed_mul(pos_x - FIXED_INT(map_x), delta_x);
         } else {
             step_x = 1;
-            side_x = (map_x + (double)1.0 - plugin_state->player.pos.x) * delta_x;
+            side_x = fixed_mul(FIXED_INT(map_x + 1) - pos_x, delta_x);
         }
 
         if(ray_y < 0) {
             step_y = -1;
-            side_y = (plugin_state->player.pos.y - map_y) * delta_y;
+            side_y = fixed_mul(pos_y - FIXED_INT(map_y), delta_y);
         } else {
             step_y = 1;
-            side_y = (map_y + (double)1.0 - plugin_state->player.pos.y) * delta_y;
+            side_y = fixed_mul(FIXED_INT(map_y + 1) - pos_y, delta_y);
         }
 
         // Wall detection
@@ -545,49 +559,49 @@ void renderMap(
         }
 
         if(hit) {
-            double distance;
-
-            if(side == 0) {
-                distance =
-                    fmax(1, (map_x - plugin_state->player.pos.x + (1 - step_x) / 2) / ray_x);
-            } else {
-                distance =
-                    fmax(1, (map_y - plugin_state->player.pos.y + (1 - step_y) / 2) / ray_y);
-            }
+            // Perpendicular distance: the side distance before the last step
+            fixed_t distance = side == 0 ? side_x - delta_x : side_y - delta_y;
+            if(distance < FIXED_ONE) distance = FIXED_ONE;
+            fixed_t inv_distance = fixed_inv_abs(distance);
 
             // store zbuffer value for the column
-            zbuffer[x / Z_RES_DIVIDER] = fmin(distance * DISTANCE_MULTIPLIER, 255);
+            int32_t z = ((distance >> 8) * DISTANCE_MULTIPLIER) >> (FIXED_SHIFT - 8);
+            zbuffer[x / Z_RES_DIVIDER] = z > 255 ? 255 : z;
 
             // rendered line height
-            uint8_t line_height = RENDER_HEIGHT / distance;
+            uint8_t line_height = (RENDER_HEIGHT * inv_distance) >> FIXED_SHIFT;
+            int8_t view_offset = fixed_mul(view_height_f, inv_distance) >> FIXED_SHIFT;
 
             drawVLine(
                 x,
-                view_height / distance - line_height / 2 + RENDER_HEIGHT / 2,
-                view_height / distance + line_height / 2 + RENDER_HEIGHT / 2,
-                GRADIENT_COUNT - (int)distance / MAX_RENDER_DEPTH * GRADIENT_COUNT - side * 2,
+                view_offset - line_height / 2 + RENDER_HEIGHT / 2,
+                view_offset + line_height / 2 + RENDER_HEIGHT / 2,
+                GRADIENT_COUNT - (distance >> FIXED_SHIFT) / MAX_RENDER_DEPTH * GRADIENT_COUNT -
+                    side * 2,
                 canvas);
+        } else {
+            // Nothing in range, sprites in this column are never occluded
+            zbuffer[x / Z_RES_DIVIDER] = 255;
         }
     }
 }
 
-// Sort entities from far to close
+// Sort entities from far to close. Insertion sort: there are at most
+// MAX_ENTITIES and the order barely changes between frames, so this is
+// close to a single pass. Returns true if anything moved.
 uint8_t sortEntities(PluginState* const plugin_state) {
-    uint8_t gap = plugin_state->num_entities;
     bool swapped = false;
-    while(gap > 1 || swapped) {
-        //shrink factor 1.3
-        gap = (gap * 10) / 13;
-        if(gap == 9 || gap == 10) gap = 11;
-        if(gap < 1) gap = 1;
-        swapped = false;
-        for(uint8_t i = 0; i < plugin_state->num_entities - gap; i++) {
-            uint8_t j = i + gap;
-            if(plugin_state->entity[i].distance < plugin_state->entity[j].distance) {
-                swap(plugin_state->entity[i], plugin_state->entity[j]);
-                swapped = true;
-            }
+    for(uint8_t i = 1; i < plugin_state->num_entities; i++) {
+        if(plugin_state->entity[i - 1].distance >= plugin_state->entity[i].distance) continue;
+
+        Entity moving = plugin_state->entity[i];
+        uint8_t j = i;
+        while(j > 0 && plugin_state->entity[j - 1].distance < moving.distance) {
+            plugin_state->entity[j] = plugin_state->entity[j - 1];
+            j--;
         }
+        plugin_state->entity[j] = moving;
+        swapped = true;
     }
     return swapped;
 }
@@ -610,21 +624,70 @@ Coords translateIntoView(Coords* pos, PluginState* const plugin_state) {
     return res;
 }
 
+// Same as translateIntoView, in fixed point for the renderer. inv_det is
+// 1 / det of the camera matrix, computed once per frame.
+static FixedCoords translateIntoViewFixed(
+    Coords* pos,
+    fixed_t pos_x,
+    fixed_t pos_y,
+    fixed_t dir_x,
+    fixed_t dir_y,
+    fixed_t plane_x,
+    fixed_t plane_y,
+    fixed_t inv_det) {
+    //translate sprite position to relative to camera
+    fixed_t sprite_x = FIXED(pos->x) - pos_x;
+    fixed_t sprite_y = FIXED(pos->y) - pos_y;
+
+    FixedCoords res = {
+        fixed_mul(inv_det, fixed_mul(dir_y, sprite_x) - fixed_mul(dir_x, sprite_y)),
+        fixed_mul(inv_det, fixed_mul(plane_x, sprite_y) - fixed_mul(plane_y, sprite_x)),
+    }; // y is Z in screen
+    return res;
+}
+
+// Sprite projection and scaling are done in Q16.16 fixed point, like the
+// raycaster.
 void renderEntities(double view_height, Canvas* const canvas, PluginState* const plugin_state) {
     sortEntities(plugin_state);
 
+    // Convert the view once per frame
+    fixed_t pos_x = FIXED(plugin_state->player.pos.x);
+    fixed_t pos_y = FIXED(plugin_state->player.pos.y);
+    fixed_t dir_x = FIXED(plugin_state->player.dir.x);
+    fixed_t dir_y = FIXED(plugin_state->player.dir.y);
+    fixed_t plane_x = FIXED(plugin_state->player.plane.x);
+    fixed_t plane_y = FIXED(plugin_state->player.plane.y);
+    fixed_t view_height_f = FIXED(view_height);
+    //required for correct matrix multiplication
+    fixed_t inv_det =
+        fixed_div(FIXED_ONE, fixed_mul(plane_x, dir_y) - fixed_mul(dir_x, plane_y));
+
     for(uint8_t i = 0; i < plugin_state->num_entities; i++) {
         if(plugin_state->entity[i].state == S_HIDDEN) continue;
 
-        Coords transform = translateIntoView(&(plugin_state->entity[i].pos), plugin_state);
+        FixedCoords transform = translateIntoViewFixed(
+            &(plugin_state->entity[i].pos),
+            pos_x,
+            pos_y,
+            dir_x,
+            dir_y,
+            plane_x,
+            plane_y,
+            inv_det);
 
         // don´t render if behind the player or too far away
-        if(transform.y <= (double)0.1 || transform.y > MAX_SPRITE_DEPTH) {
+        if(transform.y <= FIXED(0.1) || transform.y > FIXED_INT(MAX_SPRITE_DEPTH)) {
             continue;
         }
 
-        int16_t sprite_screen_x = HALF_WIDTH * ((double)1.0 + transform.x / transform.y);
-        int8_t sprite_screen_y = RENDER_HEIGHT / 2 + view_height / transform.y;
+        // 1 / depth, below 10.0 after the check above
+        fixed_t inv_y = fixed_div(FIXED_ONE, transform.y);
+        // tx / ty can exceed the fixed_t range for sprites far to the side
+        int16_t sprite_screen_x =
+            HALF_WIDTH + (int32_t)(((int64_t)HALF_WIDTH * transform.x) / transform.y);
+        int8_t sprite_screen_y =
+            RENDER_HEIGHT / 2 + (fixed_mul(view_height_f, inv_y) >> FIXED_SHIFT);
         uint8_t type = uid_get_type(plugin_state->entity[i].uid);
 
         // don´t try to render if outside of screen
@@ -658,8 +721,8 @@ void renderEntities(double view_height, Canvas* const canvas, PluginState* const
             }
 
             drawSprite(
-                sprite_screen_x - BMP_IMP_WIDTH * (double).5 / transform.y,
-                sprite_screen_y - 8 / transform.y,
+                sprite_screen_x - ((BMP_IMP_WIDTH / 2 * inv_y) >> FIXED_SHIFT),
+                sprite_screen_y - ((8 * inv_y) >> FIXED_SHIFT),
                 imp_inv,
                 imp_mask_inv,
                 BMP_IMP_WIDTH,
@@ -672,8 +735,8 @@ void renderEntities(double view_height, Canvas* const canvas, PluginState* const
 
         case E_FIREBALL: {
             drawSprite(
-                sprite_screen_x - BMP_FIREBALL_WIDTH / 2 / transform.y,
-                sprite_screen_y - BMP_FIREBALL_HEIGHT / 2 / transform.y,
+                sprite_screen_x - ((BMP_FIREBALL_WIDTH / 2 * inv_y) >> FIXED_SHIFT),
+                sprite_screen_y - ((BMP_FIREBALL_HEIGHT / 2 * inv_y) >> FIXED_SHIFT),
                 fireball,
                 fireball_mask,
                 BMP_FIREBALL_WIDTH,
@@ -686,8 +749,8 @@ void renderEntities(double view_height, Canvas* const canvas, PluginState* const
 
         case E_MEDIKIT: {
             drawSprite(
-                sprite_screen_x - BMP_ITEMS_WIDTH / 2 / transform.y,
-                sprite_screen_y + 5 / transform.y,
+                sprite_screen_x - ((BMP_ITEMS_WIDTH / 2 * inv_y) >> FIXED_SHIFT),
+                sprite_screen_y + ((5 * inv_y) >> FIXED_SHIFT),
                 item,
                 item_mask,
                 BMP_ITEMS_WIDTH,
@@ -700,8 +763,8 @@ void renderEntities(double view_height, Canvas* const canvas, PluginState* const
 
         case E_KEY: {
             drawSprite(
-                sprite_screen_x - BMP_ITEMS_WIDTH / 2 / transform.y,
-                sprite_screen_y + 5 / transform.y,
+                sprite_screen_x - ((BMP_ITEMS_WIDTH / 2 * inv_y) >> FIXED_SHIFT),
+                sprite_screen_y + ((5 * inv_y) >> FIXED_SHIFT),
                 item,
                 item_mask,
                 BMP_ITEMS_WIDTH,
@@ -818,6 +881,10 @@ static void doom_state_init(PluginState* const plugin_state) {
     plugin_state->right = false;
     plugin_state->fired = false;
     plugin_state->gun_fired = false;
+
+    for(uint8_t x = 0; x < SCREEN_WIDTH; x += RES_DIVIDER) {
+        camera_x_table[x / RES_DIVIDER] = FIXED(2 * (double)x / SCREEN_WIDTH - 1);
+    }
 #ifdef SOUND
 
     plugin_state->music_instance = malloc(sizeof(MusicPlayer));
@@ -28,6 +28,36 @@ typedef struct Coords {
     double y;
 } Coords;
 
+// Q16.16 fixed point used by the renderer
+typedef int32_t fixed_t;
+#define FIXED_SHIFT  16
+#define FIXED_ONE    (1 << FIXED_SHIFT)
+#define FIXED(a)     ((fixed_t)((a) * FIXED_ONE))
+#define FIXED_INT(a) ((fixed_t)(a) << FIXED_SHIFT)
+// Ray components smaller than this are clamped, keeping 1/ray below 256.0
+#define FIXED_MIN_RAY (FIXED_ONE >> 8)
+
+static inline fixed_t fixed_mul(fixed_t a, fixed_t b) {
+    return (fixed_t)(((int64_t)a * b) >> FIXED_SHIFT);
+}
+
+// |1 / a|, with a single 32 bit division
+static inline fixed_t fixed_inv_abs(fixed_t a) {
+    uint32_t abs_a = a < 0 ? -a : a;
+    if(abs_a < FIXED_MIN_RAY) abs_a = FIXED_MIN_RAY;
+    return 0xFFFFFFFFu / abs_a;
+}
+
+// a / b, b must not be 0
+static inline fixed_t fixed_div(fixed_t a, fixed_t b) {
+    return (fixed_t)(((int64_t)a << FIXED_SHIFT) / b);
+}
+
+typedef struct FixedCoords {
+    fixed_t x;
+    fixed_t y;
+} FixedCoords;
+
 UID create_uid(EType type, uint8_t x, uint8_t y);
 EType uid_get_type(UID uid);
 Coords create_coords(double x, double y);
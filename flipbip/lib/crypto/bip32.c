@@ -289,6 +289,18 @@ int hdnode_public_ckd_cp(
     uint32_t i,
     curve_point* child,
     uint8_t* child_chain_code) {
+    return hdnode_public_ckd_cp_comb(
+        curve, NULL, parent, parent_chain_code, i, child, child_chain_code);
+}
+
+int hdnode_public_ckd_cp_comb(
+    const ecdsa_curve* curve,
+    const ecdsa_comb* comb,
+    const curve_point* parent,
+    const uint8_t* parent_chain_code,
+    uint32_t i,
+    curve_point* child,
+    uint8_t* child_chain_code) {
     uint8_t data[(1 + 32) + 4] = {0};
     uint8_t I[32 + 32] = {0};
     bignum256 c = {0};
@@ -305,7 +317,11 @@ int hdnode_public_ckd_cp(
         hmac_sha512(parent_chain_code, 32, data, sizeof(data), I);
         bn_read_be(I, &c);
         if(bn_is_less(&c, &curve->order)) { // < order
-            scalar_multiply(curve, &c, child); // b = c * G
+            if(comb) {
+                scalar_multiply_comb(curve, comb, &c, child); // b = c * G
+            } else {
+                scalar_multiply(curve, &c, child); // b = c * G
+            }
             point_add(curve, parent, child); // b = a + b
             if(!point_is_infinity(child)) {
                 if(child_chain_code) {
@@ -89,6 +89,15 @@ int hdnode_public_ckd_cp(
     curve_point* child,
     uint8_t* child_chain_code);
 
+int hdnode_public_ckd_cp_comb(
+    const ecdsa_curve* curve,
+    const ecdsa_comb* comb,
+    const curve_point* parent,
+    const uint8_t* parent_chain_code,
+    uint32_t i,
+    curve_point* child,
+    uint8_t* child_chain_code);
+
 int hdnode_public_ckd(HDNode* inout, uint32_t i);
 
 void hdnode_public_ckd_address_optimized(
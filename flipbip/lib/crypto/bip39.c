@@ -186,11 +186,10 @@ int mnemonic_check(const char* mnemonic) {
 }
 
 // passphrase must be at most 256 characters otherwise it would be truncated
-void mnemonic_to_seed(
+void mnemonic_to_seed_init(
+    MNEMONIC_SEED_CTX* ctx,
     const char* mnemonic,
-    const char* passphrase,
-    uint8_t seed[512 / 8],
-    void (*progress_callback)(uint32_t current, uint32_t total)) {
+    const char* passphrase) {
     int mnemoniclen = strlen(mnemonic);
     int passphraselen = strlen(passphrase);
     if(passphraselen > 256) passphraselen = 256;
@@ -202,7 +201,9 @@ void mnemonic_to_seed(
             if(strcmp(bip39_cache[i].mnemonic, mnemonic) != 0) continue;
             if(strcmp(bip39_cache[i].passphrase, passphrase) != 0) continue;
             // found the correct entry
-            memcpy(seed, bip39_cache[i].seed, 512 / 8);
+            memzero(ctx, sizeof(MNEMONIC_SEED_CTX));
+            ctx->cached_seed = bip39_cache[i].seed;
+            ctx->rounds = BIP39_PBKDF2_ROUNDS;
             return;
         }
     }
@@ -213,18 +214,46 @@ void mnemonic_to_seed(
     static CONFIDENTIAL PBKDF2_HMAC_SHA512_CTX pctx;
     pbkdf2_hmac_sha512_Init(
         &pctx, (const uint8_t*)mnemonic, mnemoniclen, salt, passphraselen + 8, 1);
-    if(progress_callback) {
-        progress_callback(0, BIP39_PBKDF2_ROUNDS);
+    memzero(salt, sizeof(salt));
+
+    // the first block depends on both the mnemonic and the passphrase, keep
+    // the progress of a ctx that was already stretching the same ones
+    if(ctx->cached_seed || ctx->rounds == 0 || memcmp(ctx->u1, pctx.g, sizeof(ctx->u1)) != 0) {
+        memcpy(&ctx->pctx, &pctx, sizeof(pctx));
+        memcpy(ctx->u1, pctx.g, sizeof(ctx->u1));
+        ctx->rounds = 0;
+        ctx->cached_seed = NULL;
     }
-    for(int i = 0; i < 16; i++) {
-        pbkdf2_hmac_sha512_Update(&pctx, BIP39_PBKDF2_ROUNDS / 16);
-        if(progress_callback) {
-            progress_callback((i + 1) * BIP39_PBKDF2_ROUNDS / 16, BIP39_PBKDF2_ROUNDS);
-        }
+    memzero(&pctx, sizeof(pctx));
+}
+
+// returns the number of rounds done so far, BIP39_PBKDF2_ROUNDS when the seed is ready
+uint32_t mnemonic_to_seed_update(MNEMONIC_SEED_CTX* ctx, uint32_t rounds) {
+    if(rounds > BIP39_PBKDF2_ROUNDS - ctx->rounds) {
+        rounds = BIP39_PBKDF2_ROUNDS - ctx->rounds;
     }
-    pbkdf2_hmac_sha512_Final(&pctx, seed);
-    memzero(salt, sizeof(salt));
+    if(rounds > 0) {
+        pbkdf2_hmac_sha512_Update(&ctx->pctx, rounds);
+        ctx->rounds += rounds;
+    }
+    return ctx->rounds;
+}
+
+void mnemonic_to_seed_final(
+    MNEMONIC_SEED_CTX* ctx,
+    const char* mnemonic,
+    const char* passphrase,
+    uint8_t seed[512 / 8]) {
+    if(ctx->cached_seed) {
+        memcpy(seed, ctx->cached_seed, 512 / 8);
+        memzero(ctx, sizeof(MNEMONIC_SEED_CTX));
+        return;
+    }
+    pbkdf2_hmac_sha512_Final(&ctx->pctx, seed);
+    memzero(ctx, sizeof(MNEMONIC_SEED_CTX));
 #if USE_BIP39_CACHE
+    int mnemoniclen = strlen(mnemonic);
+    int passphraselen = strlen(passphrase);
     // store to cache
     if(mnemoniclen < 256 && passphraselen < 64) {
         bip39_cache[bip39_cache_index].set = true;
@@ -233,9 +262,33 @@ void mnemonic_to_seed(
         memcpy(bip39_cache[bip39_cache_index].seed, seed, 512 / 8);
         bip39_cache_index = (bip39_cache_index + 1) % BIP39_CACHE_SIZE;
     }
+#else
+    (void)mnemonic;
+    (void)passphrase;
 #endif
 }
 
+// passphrase must be at most 256 characters otherwise it would be truncated
+void mnemonic_to_seed(
+    const char* mnemonic,
+    const char* passphrase,
+    uint8_t seed[512 / 8],
+    void (*progress_callback)(uint32_t current, uint32_t total)) {
+    static CONFIDENTIAL MNEMONIC_SEED_CTX ctx;
+    memzero(&ctx, sizeof(ctx));
+    mnemonic_to_seed_init(&ctx, mnemonic, passphrase);
+    if(progress_callback) {
+        progress_callback(ctx.rounds, BIP39_PBKDF2_ROUNDS);
+    }
+    while(ctx.rounds < BIP39_PBKDF2_ROUNDS) {
+        mnemonic_to_seed_update(&ctx, BIP39_PBKDF2_ROUNDS / 16);
+        if(progress_callback) {
+            progress_callback(ctx.rounds, BIP39_PBKDF2_ROUNDS);
+        }
+    }
+    mnemonic_to_seed_final(&ctx, mnemonic, passphrase, seed);
+}
+
 // binary search for finding the word in the wordlist
 int mnemonic_find_word(const char* word) {
     int lo = 0, hi = BIP39_WORD_COUNT - 1;
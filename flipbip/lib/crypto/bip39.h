@@ -28,6 +28,7 @@
 #include <stdint.h>
 
 #include "options.h"
+#include "pbkdf2.h"
 
 #define BIP39_WORD_COUNT 2048
 #define BIP39_PBKDF2_ROUNDS 2048
@@ -46,6 +47,28 @@ int mnemonic_check(const char* mnemonic);
 
 int mnemonic_to_bits(const char* mnemonic, uint8_t* bits);
 
+// Resumable seed stretching, for callers that must not block for all rounds:
+// init, then update until it returns BIP39_PBKDF2_ROUNDS, then final. Init on
+// a ctx that was stretching the same mnemonic and passphrase keeps its progress.
+typedef struct {
+    PBKDF2_HMAC_SHA512_CTX pctx;
+    uint64_t u1[SHA512_DIGEST_LENGTH / sizeof(uint64_t)]; // first block
+    uint32_t rounds; // rounds done so far
+    const uint8_t* cached_seed;
+} MNEMONIC_SEED_CTX;
+
+// passphrase must be at most 256 characters otherwise it would be truncated
+void mnemonic_to_seed_init(
+    MNEMONIC_SEED_CTX* ctx,
+    const char* mnemonic,
+    const char* passphrase);
+uint32_t mnemonic_to_seed_update(MNEMONIC_SEED_CTX* ctx, uint32_t rounds);
+void mnemonic_to_seed_final(
+    MNEMONIC_SEED_CTX* ctx,
+    const char* mnemonic,
+    const char* passphrase,
+    uint8_t seed[512 / 8]);
+
 // passphrase must be at most 256 characters otherwise it would be truncated
 void mnemonic_to_seed(
     const char* mnemonic,
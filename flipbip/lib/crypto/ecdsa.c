@@ -630,6 +630,113 @@ int scalar_multiply(const ecdsa_curve* curve, const bignum256* k, curve_point* r
 
 #endif
 
+// number of points in a comb table with the given number of teeth
+static size_t ecdsa_comb_points(uint8_t teeth) {
+    return ((size_t)1 << teeth) - 1;
+}
+
+size_t ecdsa_comb_table_size(uint8_t teeth) {
+    return ecdsa_comb_points(teeth) * sizeof(curve_point);
+}
+
+uint8_t ecdsa_comb_teeth(size_t budget) {
+    uint8_t teeth = 0;
+    while(teeth < ECDSA_COMB_MAX_TEETH && ecdsa_comb_table_size(teeth + 1) <= budget) {
+        teeth++;
+    }
+    // a comb with a single tooth is just double-and-add
+    return teeth > 1 ? teeth : 0;
+}
+
+// Precompute table[v - 1] = sum_j bit_j(v) * 2^(j * spacing) * G for v = 1 .. 2^teeth - 1
+void ecdsa_comb_init(
+    const ecdsa_curve* curve,
+    ecdsa_comb* comb,
+    uint8_t teeth,
+    curve_point* table) {
+    assert(teeth > 1 && teeth <= ECDSA_COMB_MAX_TEETH);
+
+    jacobian_curve_point jp = {0};
+    const bignum256* prime = &curve->prime;
+
+    comb->teeth = teeth;
+    comb->spacing = (256 + teeth - 1) / teeth;
+    comb->table = table;
+
+    // the teeth themselves: table[2^j - 1] = 2^(j * spacing) * G
+    point_copy(&curve->G, &table[0]);
+    for(uint8_t j = 1; j < teeth; j++) {
+        curve_to_jacobian(&table[(1 << (j - 1)) - 1], &jp, prime);
+        for(uint8_t i = 0; i < comb->spacing; i++) {
+            point_jacobian_double(&jp, curve);
+        }
+        jacobian_to_curve(&jp, &table[(1 << j) - 1], prime);
+    }
+
+    // all other combinations: add the highest tooth to the entry without it
+    for(size_t v = 3; v <= ecdsa_comb_points(teeth); v++) {
+        size_t top = 1;
+        while((top << 1) <= v) {
+            top <<= 1;
+        }
+        if(top == v) {
+            continue;
+        }
+        point_copy(&table[v - top - 1], &table[v - 1]);
+        point_add(curve, &table[top - 1], &table[v - 1]);
+    }
+
+    memzero(&jp, sizeof(jp));
+}
+
+// res = k * G using a comb built by ecdsa_comb_init
+// This is not constant time, so k must not be a private key.
+// returns 0 on success
+int scalar_multiply_comb(
+    const ecdsa_curve* curve,
+    const ecdsa_comb* comb,
+    const bignum256* k,
+    curve_point* res) {
+    if(!bn_is_less(k, &curve->order)) {
+        return 1;
+    }
+
+    jacobian_curve_point jres = {0};
+    const bignum256* prime = &curve->prime;
+    bool started = false;
+
+    for(int i = comb->spacing - 1; i >= 0; i--) {
+        if(started) {
+            point_jacobian_double(&jres, curve);
+        }
+
+        uint32_t v = 0;
+        for(int j = comb->teeth - 1; j >= 0; j--) {
+            uint16_t bit = j * comb->spacing + i;
+            v = (v << 1) | (bit < 256 ? bn_testbit(k, bit) : 0);
+        }
+
+        if(v == 0) {
+            continue;
+        }
+        if(started) {
+            point_jacobian_add(&comb->table[v - 1], &jres, curve);
+        } else {
+            curve_to_jacobian(&comb->table[v - 1], &jres, prime);
+            started = true;
+        }
+    }
+
+    if(started) {
+        jacobian_to_curve(&jres, res, prime);
+    } else {
+        point_set_infinity(res);
+    }
+    memzero(&jres, sizeof(jres));
+
+    return 0;
+}
+
 int ecdh_multiply(
     const ecdsa_curve* curve,
     const uint8_t* priv_key,
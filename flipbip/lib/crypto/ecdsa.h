@@ -74,6 +74,29 @@ int point_is_infinity(const curve_point* p);
 int point_is_equal(const curve_point* p, const curve_point* q);
 int point_is_negative_of(const curve_point* p, const curve_point* q);
 int scalar_multiply(const ecdsa_curve* curve, const bignum256* k, curve_point* res);
+
+// Fixed-base comb for repeated scalar multiplications by G, built at runtime
+// so that its size can be chosen to fit the available RAM.
+#define ECDSA_COMB_MAX_TEETH 8
+
+typedef struct {
+    uint8_t teeth; // number of scalar bits looked up at once
+    uint8_t spacing; // distance between these bits, ceil(256 / teeth)
+    curve_point* table; // ecdsa_comb_table_size(teeth) bytes
+} ecdsa_comb;
+
+size_t ecdsa_comb_table_size(uint8_t teeth);
+uint8_t ecdsa_comb_teeth(size_t budget);
+void ecdsa_comb_init(
+    const ecdsa_curve* curve,
+    ecdsa_comb* comb,
+    uint8_t teeth,
+    curve_point* table);
+int scalar_multiply_comb(
+    const ecdsa_curve* curve,
+    const ecdsa_comb* comb,
+    const bignum256* k,
+    curve_point* res);
 int ecdh_multiply(
     const ecdsa_curve* curve,
     const uint8_t* priv_key,
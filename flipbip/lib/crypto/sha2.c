@@ -1100,6 +1100,92 @@ void sha512_Transform(const sha2_word64* state_in, const sha2_word64* data, sha2
 
 #endif /* SHA2_UNROLL_TRANSFORM */
 
+/* SHA-512 round with the message word given explicitly, for the digest transform: */
+#define ROUND512_DIGEST(a, b, c, d, e, f, g, h, w)                  \
+    T1 = (h) + Sigma1_512(e) + Ch((e), (f), (g)) + K512[j] + (w); \
+    (d) += T1;                                                    \
+    (h) = T1 + Sigma0_512(a) + Maj((a), (b), (c));                \
+    j++
+
+#define ROUND512_DIGEST_EXPAND(a, b, c, d, e, f, g, h)               \
+    s0 = W512[(j + 1) & 0x0f];                                       \
+    s0 = sigma0_512(s0);                                             \
+    s1 = W512[(j + 14) & 0x0f];                                      \
+    s1 = sigma1_512(s1);                                             \
+    ROUND512_DIGEST(                                                 \
+        a, b, c, d, e, f, g, h, W512[j & 0x0f] += s1 + W512[(j + 9) & 0x0f] + s0)
+
+/*
+ * Transform of a block that holds a 64 byte digest followed by the padding of
+ * a 192 byte message, as in HMAC-SHA512 of a digest (e.g. every PBKDF2 round).
+ * Only the first 8 words of digest_inout are read and they are replaced by the
+ * result. The rounds are unrolled and use the constant second half directly.
+ */
+void sha512_Transform_digest(const sha2_word64* state_in, sha2_word64* digest_inout) {
+    sha2_word64 a = 0, b = 0, c = 0, d = 0, e = 0, f = 0, g = 0, h = 0, s0 = 0, s1 = 0;
+    sha2_word64 T1 = 0, W512[16] = {0};
+    int j = 0;
+
+    memcpy(W512, digest_inout, SHA512_DIGEST_LENGTH);
+    W512[8] = 0x8000000000000000ULL;
+    W512[15] = (SHA512_BLOCK_LENGTH + SHA512_DIGEST_LENGTH) * 8;
+
+    /* Initialize registers with the prev. intermediate value */
+    a = state_in[0];
+    b = state_in[1];
+    c = state_in[2];
+    d = state_in[3];
+    e = state_in[4];
+    f = state_in[5];
+    g = state_in[6];
+    h = state_in[7];
+
+    /* The digest */
+    ROUND512_DIGEST(a, b, c, d, e, f, g, h, W512[0]);
+    ROUND512_DIGEST(h, a, b, c, d, e, f, g, W512[1]);
+    ROUND512_DIGEST(g, h, a, b, c, d, e, f, W512[2]);
+    ROUND512_DIGEST(f, g, h, a, b, c, d, e, W512[3]);
+    ROUND512_DIGEST(e, f, g, h, a, b, c, d, W512[4]);
+    ROUND512_DIGEST(d, e, f, g, h, a, b, c, W512[5]);
+    ROUND512_DIGEST(c, d, e, f, g, h, a, b, W512[6]);
+    ROUND512_DIGEST(b, c, d, e, f, g, h, a, W512[7]);
+
+    /* The padding and length */
+    ROUND512_DIGEST(a, b, c, d, e, f, g, h, 0x8000000000000000ULL);
+    ROUND512_DIGEST(h, a, b, c, d, e, f, g, 0);
+    ROUND512_DIGEST(g, h, a, b, c, d, e, f, 0);
+    ROUND512_DIGEST(f, g, h, a, b, c, d, e, 0);
+    ROUND512_DIGEST(e, f, g, h, a, b, c, d, 0);
+    ROUND512_DIGEST(d, e, f, g, h, a, b, c, 0);
+    ROUND512_DIGEST(c, d, e, f, g, h, a, b, 0);
+    ROUND512_DIGEST(b, c, d, e, f, g, h, a, (SHA512_BLOCK_LENGTH + SHA512_DIGEST_LENGTH) * 8);
+
+    /* Now for the remaining rounds up to 79: */
+    do {
+        ROUND512_DIGEST_EXPAND(a, b, c, d, e, f, g, h);
+        ROUND512_DIGEST_EXPAND(h, a, b, c, d, e, f, g);
+        ROUND512_DIGEST_EXPAND(g, h, a, b, c, d, e, f);
+        ROUND512_DIGEST_EXPAND(f, g, h, a, b, c, d, e);
+        ROUND512_DIGEST_EXPAND(e, f, g, h, a, b, c, d);
+        ROUND512_DIGEST_EXPAND(d, e, f, g, h, a, b, c);
+        ROUND512_DIGEST_EXPAND(c, d, e, f, g, h, a, b);
+        ROUND512_DIGEST_EXPAND(b, c, d, e, f, g, h, a);
+    } while(j < 80);
+
+    /* Compute the current intermediate hash value */
+    digest_inout[0] = state_in[0] + a;
+    digest_inout[1] = state_in[1] + b;
+    digest_inout[2] = state_in[2] + c;
+    digest_inout[3] = state_in[3] + d;
+    digest_inout[4] = state_in[4] + e;
+    digest_inout[5] = state_in[5] + f;
+    digest_inout[6] = state_in[6] + g;
+    digest_inout[7] = state_in[7] + h;
+
+    /* Clean up */
+    a = b = c = d = e = f = g = h = T1 = 0;
+}
+
 void sha512_Update(SHA512_CTX* context, const sha2_byte* data, size_t len) {
     unsigned int freespace = 0, usedspace = 0;
 
@@ -14,6 +14,8 @@
 #include <curves.h>
 #include <bip32.h>
 #include <bip39.h>
+#include <ecdsa.h>
+#include <sha3.h>
 
 #define DERIV_PURPOSE 44
 #define DERIV_ACCOUNT 0
@@ -24,6 +26,14 @@
 #define MAX_ADDR_BUF (42 + 1) // 42 = max length of address + null terminator
 #define NUM_ADDRS    6
 
+// RAM the precomputed comb for receive address derivation may use, 0 to disable it
+#define ADDR_COMB_BUDGET (2 * 1024)
+#define ADDR_BENCHMARK   0 // log addresses derived per second with the comb off and on
+#if ADDR_BENCHMARK
+#define TAG                  "FlipBIP"
+#define ADDR_BENCHMARK_COUNT 60
+#endif
+
 #define PAGE_LOADING    0
 #define PAGE_INFO       1
 #define PAGE_MNEMONIC   2
@@ -51,13 +61,24 @@ const char* TEXT_INFO = "-Scroll pages with up/down-"
 // #define TEXT_SAVE_QR "Save QR"
 #define TEXT_QRFILE_EXT ".qrcode" // 7 chars + 1 null
 
+#define WORKER_STACK_SIZE (4 * 1024)
+#define WORKER_FLAG_STOP  (1 << 0)
+// BIP39 seed stretching rounds between progress updates
+#define SEED_ROUNDS_PER_STEP (BIP39_PBKDF2_ROUNDS / 64)
+
 struct FlipBipScene1 {
     View* view;
     FlipBipScene1Callback callback;
     void* context;
+    FuriThread* worker;
+    int strength;
+    uint32_t coin_type;
+    bool overwrite;
+    const char* passphrase_text;
 };
 typedef struct {
     int page;
+    uint32_t progress;
     int strength;
     uint32_t coin_type;
     bool overwrite;
@@ -75,6 +96,8 @@ typedef struct {
 
 // Node for the receive address
 static CONFIDENTIAL HDNode* s_addr_node = NULL;
+// BIP39 seed stretching, kept when backing out so that it can be resumed
+static CONFIDENTIAL MNEMONIC_SEED_CTX* s_seed_ctx = NULL;
 // Generic display text
 static CONFIDENTIAL char* s_disp_text1 = NULL;
 static CONFIDENTIAL char* s_disp_text2 = NULL;
@@ -88,7 +111,7 @@ static const char* s_derivation_text = TEXT_DEFAULT_COIN; // TEXT_DEFAULT_DERIV;
 static bool s_warn_insecure = false;
 #define WARN_INSECURE_TEXT_1 "Recommendation:"
 #define WARN_INSECURE_TEXT_2 "Set BIP39 Passphrase"
-//static bool s_busy = false;
+static bool s_busy = false;
 
 void flipbip_scene_1_set_callback(
     FlipBipScene1* instance,
@@ -100,30 +123,26 @@ void flipbip_scene_1_set_callback(
     instance->context = context;
 }
 
-static void flipbip_scene_1_init_address(
+static void flipbip_scene_1_format_address(
     char* addr_text,
-    const HDNode* node,
-    uint32_t coin_type,
-    uint32_t addr_index) {
-    //s_busy = true;
-
+    const curve_point* pub,
+    uint32_t coin_type) {
     // buffer for address serialization
     // subtract 2 for "0x", 1 for null terminator
     const size_t buflen = MAX_ADDR_BUF - (2 + 1);
     // subtract 2 for "0x"
     char buf[MAX_ADDR_BUF - 2] = {0};
+    // uncompressed public key
+    uint8_t pubkey[65] = {0};
 
-    // Use static node for address generation
-    memcpy(s_addr_node, node, sizeof(HDNode));
     memzero(addr_text, MAX_ADDR_BUF);
 
-    hdnode_private_ckd(s_addr_node, addr_index);
-    hdnode_fill_public_key(s_addr_node);
-
     if(COIN_INFO_ARRAY[coin_type][COIN_INFO_ADDR_FMT] == CoinTypeBTC0) {
         // BTC / DOGE style address
+        pubkey[0] = 0x02 | (pub->y.val[0] & 0x01);
+        bn_write_be(&pub->x, pubkey + 1);
         ecdsa_get_address(
-            s_addr_node->public_key,
+            pubkey,
             COIN_INFO_ARRAY[coin_type][COIN_INFO_ADDR_VERS],
             HASHER_SHA2_RIPEMD,
             HASHER_SHA2D,
@@ -137,20 +156,105 @@ static void flipbip_scene_1_init_address(
         //ecdsa_get_wif(addr_node->private_key, WIF_VERSION, HASHER_SHA2D, buf, buflen);
 
     } else if(COIN_INFO_ARRAY[coin_type][COIN_INFO_ADDR_FMT] == CoinTypeETH60) {
-        // ETH style address
-        hdnode_get_ethereum_pubkeyhash(s_addr_node, (uint8_t*)buf);
+        // ETH style address, the least significant 160 bits of the keccak of x and y
+        pubkey[0] = 0x04;
+        bn_write_be(&pub->x, pubkey + 1);
+        bn_write_be(&pub->y, pubkey + 33);
+        keccak_256(pubkey + 1, 64, (uint8_t*)buf);
         addr_text[0] = '0';
         addr_text[1] = 'x';
         // Convert the hash to a hex string
-        flipbip_btox((uint8_t*)buf, 20, addr_text + 2);
+        flipbip_btox((uint8_t*)buf + 12, 20, addr_text + 2);
+    }
+
+    memzero(buf, sizeof(buf));
+}
+
+static void flipbip_scene_1_init_addresses(
+    char** addr_texts,
+    const HDNode* node,
+    uint32_t coin_type,
+    uint32_t first_index,
+    uint32_t count,
+    size_t comb_budget) {
+    //s_busy = true;
+
+    // Receive addresses only need public derivation, so the public key of
+    // the account level node is computed once and every address is then a
+    // point addition plus one multiplication by G, which uses a precomputed
+    // comb if it fits into the given RAM budget.
+    curve_point parent = {0};
+    curve_point child = {0};
+
+    // Use static node for address generation
+    memcpy(s_addr_node, node, sizeof(HDNode));
+    hdnode_fill_public_key(s_addr_node);
+    ecdsa_read_pubkey(s_addr_node->curve->params, s_addr_node->public_key, &parent);
+
+    ecdsa_comb comb = {0};
+    curve_point* comb_table = NULL;
+    uint8_t teeth = ecdsa_comb_teeth(comb_budget);
+    if(teeth > 0) {
+        comb_table = malloc(ecdsa_comb_table_size(teeth));
+        ecdsa_comb_init(s_addr_node->curve->params, &comb, teeth, comb_table);
+    }
+
+    for(uint32_t a = 0; a < count; a++) {
+        hdnode_public_ckd_cp_comb(
+            s_addr_node->curve->params,
+            comb_table ? &comb : NULL,
+            &parent,
+            s_addr_node->chain_code,
+            first_index + a,
+            &child,
+            NULL);
+        flipbip_scene_1_format_address(addr_texts[a], &child, coin_type);
+    }
+
+    if(comb_table) {
+        free(comb_table);
     }
 
     // Clear the address node
+    memzero(&parent, sizeof(parent));
+    memzero(&child, sizeof(child));
     memzero(s_addr_node, sizeof(HDNode));
 
     //s_busy = false;
 }
 
+#if ADDR_BENCHMARK
+static void flipbip_scene_1_benchmark_addresses(const HDNode* node, uint32_t coin_type) {
+    char* addr_texts[NUM_ADDRS];
+    for(uint8_t a = 0; a < NUM_ADDRS; a++) {
+        addr_texts[a] = malloc(MAX_ADDR_BUF);
+    }
+
+    for(uint8_t pass = 0; pass < 2; pass++) {
+        size_t budget = pass ? ADDR_COMB_BUDGET : 0;
+        uint32_t start = furi_get_tick();
+        for(uint32_t i = 0; i < ADDR_BENCHMARK_COUNT; i += NUM_ADDRS) {
+            flipbip_scene_1_init_addresses(addr_texts, node, coin_type, i, NUM_ADDRS, budget);
+        }
+        uint32_t elapsed = furi_get_tick() - start;
+        FURI_LOG_I(
+            TAG,
+            "Comb %s (%u teeth): %d addresses in %lu ms, %lu.%02lu addresses/s",
+            pass ? "on" : "off",
+            ecdsa_comb_teeth(budget),
+            ADDR_BENCHMARK_COUNT,
+            elapsed,
+            ADDR_BENCHMARK_COUNT * 1000 / (elapsed ? elapsed : 1),
+            (ADDR_BENCHMARK_COUNT * 100000 / (elapsed ? elapsed : 1)) % 100);
+    }
+
+    for(uint8_t a = 0; a < NUM_ADDRS; a++) {
+        memzero(addr_texts[a], MAX_ADDR_BUF);
+        free(addr_texts[a]);
+    }
+}
+#endif
+
 static void
     flipbip_scene_1_draw_generic(const char* text, const size_t line_len, const bool chunk) {
     // Split the text into parts
@@ -297,6 +401,10 @@ void flipbip_scene_1_draw(Canvas* canvas, FlipBipScene1Model* model) {
         canvas_set_font(canvas, FontPrimary);
         canvas_draw_str(canvas, 2, 10, TEXT_LOADING);
         canvas_draw_str(canvas, 7, 30, s_derivation_text);
+        if(model->progress > 0 && model->progress < BIP39_PBKDF2_ROUNDS) {
+            elements_progress_bar(
+                canvas, 2, 32, 124, (float)model->progress / BIP39_PBKDF2_ROUNDS);
+        }
         // canvas_draw_icon(canvas, 86, 22, &I_Keychain_39x36);
         canvas_set_font(canvas, FontSecondary);
         canvas_draw_str_aligned(canvas, 125, 2, AlignRight, AlignTop, FLIPBIP_VERSION);
@@ -353,9 +461,9 @@ static int flipbip_scene_1_model_init(
     FlipBipScene1Model* const model,
     const int strength,
     const uint32_t coin_type,
-    const bool overwrite,
-    const char* passphrase_text) {
+    const bool overwrite) {
     model->page = PAGE_LOADING;
+    model->progress = 0;
     model->mnemonic_only = false;
     model->strength = strength;
     model->coin_type = coin_type;
@@ -405,9 +513,11 @@ static int flipbip_scene_1_model_init(
         return FlipBipStatusReturn; // 10 = mnemonic only, return from parent
     }
 
-    // Generate a BIP39 seed from the mnemonic
-    mnemonic_to_seed(model->mnemonic, passphrase_text, model->seed, 0);
+    // 0 = success, the BIP39 seed can be generated from the mnemonic
+    return FlipBipStatusSuccess;
+}
 
+static int flipbip_scene_1_model_derive(FlipBipScene1Model* const model, const uint32_t coin_type) {
     // Generate a BIP32 root HD node from the mnemonic
     HDNode* root = malloc(sizeof(HDNode));
     hdnode_from_seed(model->seed, 64, SECP256K1_NAME, root);
@@ -471,9 +581,14 @@ static int flipbip_scene_1_model_init(
     // Initialize addresses
     for(uint8_t a = 0; a < NUM_ADDRS; a++) {
         model->recv_addresses[a] = malloc(MAX_ADDR_BUF);
-        memzero(model->recv_addresses[a], MAX_ADDR_BUF);
-        flipbip_scene_1_init_address(model->recv_addresses[a], node, coin_type, a);
+    }
+    flipbip_scene_1_init_addresses(
+        model->recv_addresses, node, coin_type, 0, NUM_ADDRS, ADDR_COMB_BUDGET);
+#if ADDR_BENCHMARK
+    flipbip_scene_1_benchmark_addresses(node, coin_type);
+#endif
 
+    for(uint8_t a = 0; a < NUM_ADDRS; a++) {
         // Save QR code file
         memzero(buf, buflen);
         strcpy(buf, COIN_TEXT_ARRAY[coin_type][COIN_TEXT_LABEL]);
@@ -487,23 +602,102 @@ static int flipbip_scene_1_model_init(
 
     model->page = PAGE_INFO;
 
-#if USE_BIP39_CACHE
-    // Clear the BIP39 cache
-    bip39_cache_clear();
-#endif
-
     // 0 = success
     return FlipBipStatusSuccess;
 }
 
+static int32_t flipbip_scene_1_worker(void* context) {
+    furi_assert(context);
+    FlipBipScene1* instance = (FlipBipScene1*)context;
+
+    int status = FlipBipStatusSuccess;
+    const char* mnemonic = NULL;
+    bool stopped = false;
+
+    with_view_model(
+        instance->view,
+        FlipBipScene1Model * model,
+        {
+            status = flipbip_scene_1_model_init(
+                model, instance->strength, instance->coin_type, instance->overwrite);
+            mnemonic = model->mnemonic;
+        },
+        false);
+
+    // Generate a BIP39 seed from the mnemonic, a few rounds at a time so that
+    // the loading page shows the progress and backing out stops it
+    if(status == FlipBipStatusSuccess) {
+        mnemonic_to_seed_init(s_seed_ctx, mnemonic, instance->passphrase_text);
+        uint32_t rounds = s_seed_ctx->rounds;
+        while(rounds < BIP39_PBKDF2_ROUNDS) {
+            if(furi_thread_flags_get() & WORKER_FLAG_STOP) {
+                stopped = true;
+                break;
+            }
+            rounds = mnemonic_to_seed_update(s_seed_ctx, SEED_ROUNDS_PER_STEP);
+            with_view_model(
+                instance->view, FlipBipScene1Model * model, { model->progress = rounds; }, true);
+        }
+    }
+
+    with_view_model(
+        instance->view,
+        FlipBipScene1Model * model,
+        {
+            if(stopped) {
+                // nothing was derived yet, only the mnemonic needs to be freed
+                memzero((void*)model->mnemonic, strlen(model->mnemonic));
+                free((void*)model->mnemonic);
+                model->mnemonic_only = true;
+            } else if(status == FlipBipStatusSuccess) {
+                mnemonic_to_seed_final(
+                    s_seed_ctx, model->mnemonic, instance->passphrase_text, model->seed);
+                status = flipbip_scene_1_model_derive(model, instance->coin_type);
+            }
+
+            // nonzero status, free the mnemonic
+            if(status != FlipBipStatusSuccess) {
+                // calling strlen on mnemonic here can cause a crash, don't.
+                // it wasn't loaded properly anyways, no need to zero the memory
+                free((void*)model->mnemonic);
+            }
+
+            // if error, set the error message
+            if(status == FlipBipStatusSaveError) {
+                model->mnemonic = "ERROR:,Save error";
+                model->page = PAGE_MNEMONIC;
+                //flipbip_play_long_bump(app);
+            } else if(status == FlipBipStatusLoadError) {
+                model->mnemonic = "ERROR:,Load error";
+                model->page = PAGE_MNEMONIC;
+                //flipbip_play_long_bump(app);
+            } else if(status == FlipBipStatusMnemonicCheckError) {
+                model->mnemonic = "ERROR:,Mnemonic check error";
+                model->page = PAGE_MNEMONIC;
+                //flipbip_play_long_bump(app);
+            }
+
+            s_busy = false;
+        },
+        true);
+
+    // if overwrite is set and mnemonic generated, return from scene immediately
+    // (outside of the model lock, so the callback never runs with the model held)
+    if(status == FlipBipStatusReturn) {
+        instance->callback(FlipBipCustomEventScene1Back, instance->context);
+    }
+
+    return 0;
+}
+
 bool flipbip_scene_1_input(InputEvent* event, void* context) {
     furi_assert(context);
     FlipBipScene1* instance = context;
 
-    // Ignore input if busy
-    // if(s_busy) {
-    //     return false;
-    // }
+    // Ignore input if busy, except for backing out
+    if(s_busy && event->key != InputKeyBack) {
+        return false;
+    }
 
     if(event->type == InputTypeRelease) {
         switch(event->key) {
@@ -571,6 +765,14 @@ void flipbip_scene_1_exit(void* context) {
     furi_assert(context);
     FlipBipScene1* instance = (FlipBipScene1*)context;
 
+    // Stop the worker if the wallet is still loading
+    if(instance->worker) {
+        furi_thread_flags_set(furi_thread_get_id(instance->worker), WORKER_FLAG_STOP);
+        furi_thread_join(instance->worker);
+        furi_thread_free(instance->worker);
+        instance->worker = NULL;
+    }
+
     with_view_model(
         instance->view,
         FlipBipScene1Model * model,
@@ -640,9 +842,6 @@ void flipbip_scene_1_enter(void* context) {
         s_derivation_text = TEXT_NEW_WALLET;
     }
 
-    // Wait a beat to allow the display time to update to the loading screen
-    furi_thread_flags_wait(0, FuriFlagWaitAny, 50);
-
     //flipbip_play_happy_bump(app);
     //notification_message(app->notification, &sequence_blink_cyan_100);
     //flipbip_led_set_rgb(app, 255, 0, 0);
@@ -651,41 +850,20 @@ void flipbip_scene_1_enter(void* context) {
         instance->view,
         FlipBipScene1Model * model,
         {
-            // s_busy = true;
-
-            const int status =
-                flipbip_scene_1_model_init(model, strength, coin_type, overwrite, passphrase_text);
-
-            // nonzero status, free the mnemonic
-            if(status != FlipBipStatusSuccess) {
-                // calling strlen on mnemonic here can cause a crash, don't.
-                // it wasn't loaded properly anyways, no need to zero the memory
-                free((void*)model->mnemonic);
-            }
-
-            // if error, set the error message
-            if(status == FlipBipStatusSaveError) {
-                model->mnemonic = "ERROR:,Save error";
-                model->page = PAGE_MNEMONIC;
-                //flipbip_play_long_bump(app);
-            } else if(status == FlipBipStatusLoadError) {
-                model->mnemonic = "ERROR:,Load error";
-                model->page = PAGE_MNEMONIC;
-                //flipbip_play_long_bump(app);
-            } else if(status == FlipBipStatusMnemonicCheckError) {
-                model->mnemonic = "ERROR:,Mnemonic check error";
-                model->page = PAGE_MNEMONIC;
-                //flipbip_play_long_bump(app);
-            }
-
-            // s_busy = false;
-
-            // if overwrite is set and mnemonic generated, return from scene immediately
-            if(status == FlipBipStatusReturn) {
-                instance->callback(FlipBipCustomEventScene1Back, instance->context);
-            }
+            model->page = PAGE_LOADING;
+            model->progress = 0;
         },
         true);
+
+    // Load the wallet on a worker, the loading page is drawn meanwhile
+    s_busy = true;
+    instance->strength = strength;
+    instance->coin_type = coin_type;
+    instance->overwrite = overwrite;
+    instance->passphrase_text = passphrase_text;
+    instance->worker = furi_thread_alloc_ex(
+        "FlipBipWorker", WORKER_STACK_SIZE, flipbip_scene_1_worker, instance);
+    furi_thread_start(instance->worker);
 }
 
 FlipBipScene1* flipbip_scene_1_alloc() {
@@ -698,8 +876,13 @@ FlipBipScene1* flipbip_scene_1_alloc() {
     view_set_enter_callback(instance->view, flipbip_scene_1_enter);
     view_set_exit_callback(instance->view, flipbip_scene_1_exit);
 
+    instance->worker = NULL;
+
     // allocate the address node
     s_addr_node = (HDNode*)malloc(sizeof(HDNode));
+    // allocate the seed stretching state
+    s_seed_ctx = (MNEMONIC_SEED_CTX*)malloc(sizeof(MNEMONIC_SEED_CTX));
+    memzero(s_seed_ctx, sizeof(MNEMONIC_SEED_CTX));
 
     // allocate the display text
     s_disp_text1 = (char*)malloc(MAX_TEXT_BUF);
@@ -720,6 +903,14 @@ void flipbip_scene_1_free(FlipBipScene1* instance) {
     // free the address node
     memzero(s_addr_node, sizeof(HDNode));
     free(s_addr_node);
+    // free the seed stretching state
+    memzero(s_seed_ctx, sizeof(MNEMONIC_SEED_CTX));
+    free(s_seed_ctx);
+
+#if USE_BIP39_CACHE
+    // Clear the BIP39 cache
+    bip39_cache_clear();
+#endif
 
     // free the display text
     flipbip_scene_1_clear_text();
@@ -25,6 +25,11 @@ void draw_callback(Canvas* canvas, void* ctx) {
         return;
     }
 
+    if(tracker->is_rendering) {
+        canvas_draw_str(canvas, 10, 10, "Rendering...");
+        return;
+    }
+
     if(tracker->showing_help) {
         canvas_draw_icon(canvas, 0, 0, &I_help);
         return;
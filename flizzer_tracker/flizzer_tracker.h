@@ -26,6 +26,11 @@
 #define FLIZZER_TRACKER_INSTRUMENTS_FOLDER "/ext/apps_data/flizzer_tracker/instruments"
 #define FILE_NAME_LEN 64
 
+// Seconds of audio rendered offline (see render_song_offline()) after a song is loaded, to
+// measure the engines and check the block renderer against the per-sample one. 0 disables it.
+#define OFFLINE_RENDER_SECONDS 0
+#define OFFLINE_RENDER_CHUNK 256
+
 typedef enum {
     EventTypeInput,
     EventTypeSaveSong,
@@ -170,6 +175,7 @@ typedef struct {
     Storage* storage;
     Stream* stream;
     FuriString* filepath;
+    FuriThread* render_thread;
     DialogsApp* dialogs;
     Submenu* pattern_submenu;
     Submenu* pattern_copypaste_submenu;
@@ -206,6 +212,7 @@ typedef struct {
     bool is_saving;
     bool is_loading_instrument;
     bool is_saving_instrument;
+    bool is_rendering;
     bool showing_help;
 
     bool cut_pattern; //if we need to clear the pattern we pasted from
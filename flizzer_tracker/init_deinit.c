@@ -263,6 +263,8 @@ FlizzerTrackerApp* init_tracker(
 }
 
 void deinit_tracker(FlizzerTrackerApp* tracker) {
+    render_song_offline_join(tracker);
+
     notification_message(tracker->notification, &sequence_display_backlight_enforce_auto);
     furi_record_close(RECORD_NOTIFICATION);
 
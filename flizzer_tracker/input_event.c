@@ -225,6 +225,10 @@ void submenu_callback(void* context, uint32_t index) {
             if(ret && strcmp(&cpath[strlen(cpath) - 4], SONG_FILE_EXT) == 0) {
                 bool result = load_song_util(tracker, path);
                 UNUSED(result);
+
+                if(OFFLINE_RENDER_SECONDS > 0) {
+                    render_song_offline_start(tracker);
+                }
             }
 
             else {
@@ -461,7 +465,7 @@ void process_input_event(FlizzerTrackerApp* tracker, FlizzerTrackerEvent* event)
     }
 
     if(tracker->showing_help || tracker->is_loading || tracker->is_saving ||
-       tracker->is_loading_instrument || tracker->is_saving_instrument)
+       tracker->is_loading_instrument || tracker->is_saving_instrument || tracker->is_rendering)
         return; //do not react until these are finished
 
     if(event->input.key == InputKeyBack && event->input.type == InputTypeShort &&
@@ -17,7 +17,7 @@ void sound_engine_init(
     memset(sound_engine, 0, sizeof(SoundEngine));
 
     sound_engine->audio_buffer = malloc(audio_buffer_size * sizeof(sound_engine->audio_buffer[0]));
-    memset(sound_engine->audio_buffer, 0, sizeof(SoundEngine));
+    memset(sound_engine->audio_buffer, 0, audio_buffer_size * sizeof(sound_engine->audio_buffer[0]));
     sound_engine->audio_buffer_size = audio_buffer_size;
     sound_engine->sample_rate = sample_rate;
     sound_engine->external_audio_output = external_audio_output;
@@ -95,7 +95,9 @@ void sound_engine_enable_gate(SoundEngine* sound_engine, SoundEngineChannel* cha
     }
 }
 
-void sound_engine_fill_buffer(
+// Per-sample path, needed when ring modulation or hard sync tie a channel to the other channels'
+// current sample. Also the reference the block path must match bit for bit.
+void sound_engine_fill_buffer_per_sample(
     SoundEngine* sound_engine,
     uint16_t* audio_buffer,
     uint32_t audio_buffer_size) {
@@ -200,4 +202,62 @@ void sound_engine_fill_buffer(
         //audio_buffer[i] = output / (64 * 4);
         audio_buffer[i] = output >> 8;
     }
-}
\ No newline at end of file
+}
+
+static bool sound_engine_channels_interact(SoundEngine* sound_engine) {
+    for(uint32_t chan = 0; chan < NUM_CHANNELS; ++chan) {
+        SoundEngineChannel* channel = &sound_engine->channel[chan];
+
+        if(channel->frequency > 0 &&
+           (channel->flags & (SE_ENABLE_RING_MOD | SE_ENABLE_HARD_SYNC))) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void sound_engine_fill_buffer(
+    SoundEngine* sound_engine,
+    uint16_t* audio_buffer,
+    uint32_t audio_buffer_size) {
+    if(sound_engine_channels_interact(sound_engine)) {
+        sound_engine_fill_buffer_per_sample(sound_engine, audio_buffer, audio_buffer_size);
+        return;
+    }
+
+    // Channels are independent: render each one through oscillator, envelope and filter a block
+    // at a time, so every stage runs a tight loop with its state kept in registers
+    int32_t* mix = sound_engine->mix_block;
+    int32_t* block = sound_engine->channel_block;
+
+    for(uint32_t start = 0; start < audio_buffer_size; start += SE_BLOCK_SIZE) {
+        uint32_t length = audio_buffer_size - start;
+        if(length > SE_BLOCK_SIZE) length = SE_BLOCK_SIZE;
+
+        for(uint32_t i = 0; i < length; ++i) {
+            mix[i] = WAVE_AMP * 2;
+        }
+
+        for(uint32_t chan = 0; chan < NUM_CHANNELS; ++chan) {
+            SoundEngineChannel* channel = &sound_engine->channel[chan];
+
+            if(channel->frequency == 0) continue;
+
+            sound_engine_osc_block(sound_engine, channel, block, length);
+            sound_engine_adsr_block(sound_engine, &channel->adsr, &channel->flags, block, length);
+
+            if((channel->flags & SE_ENABLE_FILTER) && channel->filter_mode != 0) {
+                sound_engine_filter_block(&channel->filter, channel->filter_mode, block, length);
+            }
+
+            for(uint32_t i = 0; i < length; ++i) {
+                mix[i] += block[i];
+            }
+        }
+
+        for(uint32_t i = 0; i < length; ++i) {
+            audio_buffer[start + i] = mix[i] >> 8;
+        }
+    }
+}
@@ -20,4 +20,8 @@ void sound_engine_fill_buffer(
     SoundEngine* sound_engine,
     uint16_t* audio_buffer,
     uint32_t audio_buffer_size);
+void sound_engine_fill_buffer_per_sample(
+    SoundEngine* sound_engine,
+    uint16_t* audio_buffer,
+    uint32_t audio_buffer_size);
 void sound_engine_enable_gate(SoundEngine* sound_engine, SoundEngineChannel* channel, bool enable);
\ No newline at end of file
@@ -56,4 +56,31 @@ int32_t sound_engine_cycle_and_output_adsr(
 
     return (int32_t)((int32_t)input * (int32_t)(adsr->envelope >> 10) / (int32_t)(MAX_ADSR >> 10) *
                      (int32_t)adsr->volume / (int32_t)MAX_ADSR_VOLUME);
+}
+
+void sound_engine_adsr_block(
+    SoundEngine* eng,
+    SoundEngineADSR* adsr,
+    uint16_t* flags,
+    int32_t* buffer,
+    uint32_t length) {
+    uint32_t i = 0;
+
+    while(i < length) {
+        if(adsr->envelope_state == SUSTAIN || adsr->envelope_state == DONE) {
+            // the envelope holds still until the gate changes, so skip the state machine
+            int32_t envelope = adsr->envelope >> 10;
+            int32_t volume = adsr->volume;
+
+            for(; i < length; ++i) {
+                buffer[i] = (int32_t)(buffer[i] * envelope / (int32_t)(MAX_ADSR >> 10) * volume /
+                                      (int32_t)MAX_ADSR_VOLUME);
+            }
+        }
+
+        else {
+            buffer[i] = sound_engine_cycle_and_output_adsr(buffer[i], eng, adsr, flags);
+            ++i;
+        }
+    }
 }
\ No newline at end of file
@@ -6,4 +6,10 @@ int32_t sound_engine_cycle_and_output_adsr(
     int32_t input,
     SoundEngine* eng,
     SoundEngineADSR* adsr,
-    uint16_t* flags);
\ No newline at end of file
+    uint16_t* flags);
+void sound_engine_adsr_block(
+    SoundEngine* eng,
+    SoundEngineADSR* adsr,
+    uint16_t* flags,
+    int32_t* buffer,
+    uint32_t length);
\ No newline at end of file
@@ -17,6 +17,8 @@
 #define SINE_LUT_SIZE 256
 #define SINE_LUT_BITDEPTH 8
 
+#define SE_BLOCK_SIZE 64 // samples rendered per channel pass in sound_engine_fill_buffer()
+
 #define MAX_ADSR (0xff << 17)
 #define MAX_ADSR_VOLUME 0x80
 #define BASE_FREQ 22050
@@ -98,5 +100,8 @@ typedef struct {
     bool external_audio_output;
     uint8_t sine_lut[SINE_LUT_SIZE];
 
+    int32_t mix_block[SE_BLOCK_SIZE];
+    int32_t channel_block[SE_BLOCK_SIZE];
+
     // uint32_t counter; //for debug
 } SoundEngine;
\ No newline at end of file
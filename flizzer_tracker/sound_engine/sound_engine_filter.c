@@ -25,4 +25,36 @@ int32_t sound_engine_output_highpass(SoundEngineFilter* flt) {
 
 int32_t sound_engine_output_bandpass(SoundEngineFilter* flt) {
     return flt->band * 8;
+}
+
+void sound_engine_filter_block(
+    SoundEngineFilter* flt,
+    uint8_t filter_mode,
+    int32_t* buffer,
+    uint32_t length) {
+    // output selection as masks, so the mode switch stays out of the sample loop
+    static const uint8_t outputs[FIL_MODES] = {0, 1, 2, 4, 1 | 2, 2 | 4, 1 | 4, 1 | 2 | 4};
+    uint8_t sel = filter_mode < FIL_MODES ? outputs[filter_mode] : 0;
+    int32_t low_mask = (sel & 1) ? -1 : 0;
+    int32_t high_mask = (sel & 2) ? -1 : 0;
+    int32_t band_mask = (sel & 4) ? -1 : 0;
+
+    int32_t cutoff = flt->cutoff;
+    int32_t damping = 256 - flt->resonance;
+    int32_t low = flt->low, high = flt->high, band = flt->band;
+
+    for(uint32_t i = 0; i < length; ++i) {
+        int32_t input = buffer[i] / 8;
+        low = low + ((cutoff * band) >> 16);
+        high = input - low - ((damping * band) >> 8);
+        band = ((cutoff * high) >> 16) + band;
+
+        if(sel) {
+            buffer[i] = ((low & low_mask) + (high & high_mask) + (band & band_mask)) * 8;
+        }
+    }
+
+    flt->low = low;
+    flt->high = high;
+    flt->band = band;
 }
\ No newline at end of file
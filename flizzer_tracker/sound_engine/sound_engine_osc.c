@@ -275,4 +275,64 @@ uint16_t
     }
 
     return WAVE_AMP / 2;
+}
+
+// advance the accumulator like sound_engine_fill_buffer() does, sync bit of the last sample is kept
+#define OSC_BLOCK_LOOP(wave)                                 \
+    for(uint32_t i = 0; i < length; ++i) {                   \
+        acc += frequency;                                    \
+        sync_bit = (acc > ACC_LENGTH ? 1 : 0);               \
+        acc &= ACC_LENGTH - 1;                               \
+        buffer[i] = (int32_t)(wave) - WAVE_AMP / 2;          \
+    }
+
+// Render length samples of the channel oscillator. The plain waveforms get a tight loop of their
+// own, the noise and combined ones go through sound_engine_osc() sample by sample.
+void sound_engine_osc_block(
+    SoundEngine* sound_engine,
+    SoundEngineChannel* channel,
+    int32_t* buffer,
+    uint32_t length) {
+    uint32_t acc = channel->accumulator;
+    uint32_t frequency = channel->frequency;
+    uint8_t sync_bit = channel->sync_bit;
+
+    switch(channel->waveform) {
+    case SE_WAVEFORM_PULSE: {
+        uint32_t pw = channel->pw;
+        OSC_BLOCK_LOOP(sound_engine_pulse(acc, pw));
+        break;
+    }
+
+    case SE_WAVEFORM_TRIANGLE: {
+        OSC_BLOCK_LOOP(sound_engine_triangle(acc));
+        break;
+    }
+
+    case SE_WAVEFORM_SAW: {
+        OSC_BLOCK_LOOP(sound_engine_saw(acc));
+        break;
+    }
+
+    case SE_WAVEFORM_SINE: {
+        OSC_BLOCK_LOOP(sound_engine_sine(acc, sound_engine));
+        break;
+    }
+
+    default: {
+        for(uint32_t i = 0; i < length; ++i) {
+            uint32_t prev_acc = acc;
+            acc += frequency;
+            sync_bit = (acc > ACC_LENGTH ? 1 : 0);
+            acc &= ACC_LENGTH - 1;
+            channel->accumulator = acc;
+            buffer[i] = (int32_t)sound_engine_osc(sound_engine, channel, prev_acc) - WAVE_AMP / 2;
+        }
+
+        break;
+    }
+    }
+
+    channel->accumulator = acc;
+    channel->sync_bit = sync_bit;
 }
\ No newline at end of file
@@ -5,4 +5,9 @@
 uint16_t sound_engine_triangle(uint32_t acc);
 
 uint16_t
-    sound_engine_osc(SoundEngine* sound_engine, SoundEngineChannel* channel, uint32_t prev_acc);
\ No newline at end of file
+    sound_engine_osc(SoundEngine* sound_engine, SoundEngineChannel* channel, uint32_t prev_acc);
+void sound_engine_osc_block(
+    SoundEngine* sound_engine,
+    SoundEngineChannel* channel,
+    int32_t* buffer,
+    uint32_t length);
\ No newline at end of file
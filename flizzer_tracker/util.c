@@ -50,6 +50,14 @@ void play_song(FlizzerTrackerApp* tracker, bool from_cursor) {
     tracker->tracker_engine.current_tick = 0;
     tracker_engine_set_song(&tracker->tracker_engine, &tracker->song);
 
+    reset_channels(tracker);
+
+    tracker->tracker_engine.pattern_position = temppos;
+
+    play();
+}
+
+void reset_channels(FlizzerTrackerApp* tracker) {
     for(uint8_t i = 0; i < SONG_MAX_CHANNELS; i++) {
         bool was_disabled = tracker->tracker_engine.channel[i].channel_flags & TEC_DISABLED;
 
@@ -60,10 +68,127 @@ void play_song(FlizzerTrackerApp* tracker, bool from_cursor) {
             tracker->tracker_engine.channel[i].channel_flags |= TEC_DISABLED;
         }
     }
+}
 
-    tracker->tracker_engine.pattern_position = temppos;
+// Render the song from its start with the audio and tracker timers stopped, as fast as the CPU
+// allows: the engine ticks are placed on the same sample positions the timer would hit. Logs the
+// CPU time spent on every second of audio and returns a FNV-1a hash of all rendered samples.
+static uint32_t render_song_pass(FlizzerTrackerApp* tracker, uint32_t seconds, bool per_sample) {
+    uint16_t* buffer = malloc(OFFLINE_RENDER_CHUNK * sizeof(uint16_t));
+    uint32_t sample_rate = tracker->sound_engine.sample_rate;
+    uint32_t rate = tracker->song.rate ? tracker->song.rate : 1;
+    uint64_t total = (uint64_t)sample_rate * seconds;
+    uint64_t rendered = 0, next_tick = 0, next_second = sample_rate;
+    uint32_t ticks = 0, second_start = furi_get_tick(), start = second_start;
+    uint32_t hash = 2166136261u;
+
+    tracker->tracker_engine.pattern_position = 0;
+    tracker->tracker_engine.sequence_position = 0;
+    tracker->tracker_engine.current_tick = 0;
+    tracker_engine_set_song(&tracker->tracker_engine, &tracker->song);
+    reset_channels(tracker);
+    tracker->tracker_engine.playing = true;
 
-    play();
+    while(rendered < total) {
+        if(rendered == next_tick) {
+            tracker_engine_advance_tick(&tracker->tracker_engine);
+            ticks++;
+            next_tick = (uint64_t)ticks * sample_rate / rate;
+        }
+
+        uint32_t length = OFFLINE_RENDER_CHUNK;
+        if(next_tick - rendered < length) length = next_tick - rendered;
+        if(next_second - rendered < length) length = next_second - rendered;
+
+        if(per_sample) {
+            sound_engine_fill_buffer_per_sample(&tracker->sound_engine, buffer, length);
+        } else {
+            sound_engine_fill_buffer(&tracker->sound_engine, buffer, length);
+        }
+
+        for(uint32_t i = 0; i < length; i++) {
+            hash = (hash ^ (buffer[i] & 0xff)) * 16777619u;
+            hash = (hash ^ (buffer[i] >> 8)) * 16777619u;
+        }
+
+        rendered += length;
+
+        if(rendered == next_second) {
+            uint32_t now = furi_get_tick();
+            FURI_LOG_I(
+                "FlizzerTracker",
+                "Offline render (%s): second %lu took %lu ms",
+                per_sample ? "per sample" : "block",
+                (uint32_t)(rendered / sample_rate),
+                now - second_start);
+            second_start = now;
+            next_second += sample_rate;
+        }
+    }
+
+    FURI_LOG_I(
+        "FlizzerTracker",
+        "Offline render (%s): %lu s of audio in %lu ms, hash %08lX",
+        per_sample ? "per sample" : "block",
+        seconds,
+        furi_get_tick() - start,
+        hash);
+
+    free(buffer);
+    tracker->tracker_engine.playing = false;
+    reset_channels(tracker);
+    reset_buffer(&tracker->sound_engine);
+
+    return hash;
+}
+
+// Render the song through the block renderer and then through the per-sample reference, and
+// check that both produced the same samples. Returns true if they match.
+bool render_song_offline(FlizzerTrackerApp* tracker, uint32_t seconds) {
+    stop_song(tracker);
+
+    uint32_t block_hash = render_song_pass(tracker, seconds, false);
+    uint32_t reference_hash = render_song_pass(tracker, seconds, true);
+
+    if(block_hash != reference_hash) {
+        FURI_LOG_E(
+            "FlizzerTracker",
+            "Offline render: block output %08lX differs from per sample output %08lX",
+            block_hash,
+            reference_hash);
+        return false;
+    }
+
+    FURI_LOG_I("FlizzerTracker", "Offline render: block output matches per sample output");
+    return true;
+}
+
+static int32_t render_song_offline_worker(void* context) {
+    FlizzerTrackerApp* tracker = (FlizzerTrackerApp*)context;
+
+    render_song_offline(tracker, OFFLINE_RENDER_SECONDS);
+    tracker->is_rendering = false;
+
+    return 0;
+}
+
+// Run render_song_offline() on its own thread, the GUI shows "Rendering..." and input is ignored
+// until it's done
+void render_song_offline_start(FlizzerTrackerApp* tracker) {
+    render_song_offline_join(tracker);
+
+    tracker->is_rendering = true;
+    tracker->render_thread =
+        furi_thread_alloc_ex("FlizzerRender", 2 * 1024, render_song_offline_worker, tracker);
+    furi_thread_start(tracker->render_thread);
+}
+
+void render_song_offline_join(FlizzerTrackerApp* tracker) {
+    if(tracker->render_thread == NULL) return;
+
+    furi_thread_join(tracker->render_thread);
+    furi_thread_free(tracker->render_thread);
+    tracker->render_thread = NULL;
 }
 
 bool is_pattern_empty(TrackerSong* song, uint8_t pattern) {
@@ -17,6 +17,10 @@
 void reset_buffer(SoundEngine* sound_engine);
 void play_song(FlizzerTrackerApp* tracker, bool from_cursor);
 void stop_song(FlizzerTrackerApp* tracker);
+void reset_channels(FlizzerTrackerApp* tracker);
+bool render_song_offline(FlizzerTrackerApp* tracker, uint32_t seconds);
+void render_song_offline_start(FlizzerTrackerApp* tracker);
+void render_song_offline_join(FlizzerTrackerApp* tracker);
 
 bool is_pattern_empty(TrackerSong* song, uint8_t pattern);
 bool check_and_allocate_pattern(TrackerSong* song, uint8_t pattern);
@@ -8,7 +8,17 @@ Level::Level()
       gameRef(nullptr),
       size(Vector(0, 0)),
       entity_count(0),
+      entity_capacity(0),
       entities(nullptr),
+      grid_prev(nullptr),
+      grid_next(nullptr),
+      grid_bucket(nullptr),
+      query_mark(nullptr),
+      query_stamp(0),
+      scratch_indices(nullptr),
+      scratch_collisions(nullptr),
+      scratch_capacity(0),
+      grid_ready(false),
       _start(nullptr),
       _stop(nullptr)
 {
@@ -20,7 +30,17 @@ Level::Level(const char *name, const Vector &size, Game *game, void (*start)(Lev
       gameRef(game),
       size(size),
       entity_count(0),
+      entity_capacity(0),
       entities(nullptr),
+      grid_prev(nullptr),
+      grid_next(nullptr),
+      grid_bucket(nullptr),
+      query_mark(nullptr),
+      query_stamp(0),
+      scratch_indices(nullptr),
+      scratch_collisions(nullptr),
+      scratch_capacity(0),
+      grid_ready(false),
       _start(start),
       _stop(stop)
 {
@@ -48,10 +68,25 @@ void Level::clear()
             entities[i] = nullptr;
         }
     }
-    // Free the dynamic array
+    // Free the dynamic arrays
     delete[] entities;
+    delete[] grid_prev;
+    delete[] grid_next;
+    delete[] grid_bucket;
+    delete[] query_mark;
+    delete[] scratch_indices;
+    delete[] scratch_collisions;
     entities = nullptr;
+    grid_prev = nullptr;
+    grid_next = nullptr;
+    grid_bucket = nullptr;
+    query_mark = nullptr;
+    scratch_indices = nullptr;
+    scratch_collisions = nullptr;
+    scratch_capacity = 0;
     entity_count = 0;
+    entity_capacity = 0;
+    grid_ready = false;
 }
 
 // Get list of collisions for a given entity
@@ -64,15 +99,13 @@ Entity **Level::collision_list(Entity *entity, int &count) const
     }
 
     Entity **result = new Entity *[entity_count];
-    for (int i = 0; i < entity_count; i++)
+    int *indices = new int[entity_count];
+    count = grid_query(entity, indices, false);
+    for (int i = 0; i < count; i++)
     {
-        if (entities[i] != nullptr &&
-            entities[i] != entity && // Skip self
-            is_collision(entity, entities[i]))
-        {
-            result[count++] = entities[i];
-        }
+        result[i] = entities[indices[i]];
     }
+    delete[] indices;
     return result;
 }
 
@@ -91,25 +124,15 @@ void Level::entity_add(Entity *entity)
         return;
     }
 
-    // Allocate a new array with size one greater than the current count
-    Entity **newEntities = new Entity *[entity_count + 1];
-    if (!newEntities)
+    // Grow the arrays geometrically so adding n entities costs O(n) copies
+    if (entity_count == entity_capacity &&
+        !entity_reserve(entity_capacity ? entity_capacity * 2 : 8))
     {
         FURI_LOG_E("Level", "Failed to allocate memory for entities array");
         return;
     }
-
-    // Copy the existing entity pointers (if any)
-    for (int i = 0; i < entity_count; i++)
-    {
-        newEntities[i] = entities[i];
-    }
-    newEntities[entity_count] = entity;
-
-    // Delete the old array
-    delete[] entities;
-    entities = newEntities;
-    entity_count++;
+    entities[entity_count++] = entity;
+    grid_ready = false; // indices changed, rebuilt on next update
 
     // Start the new entity
     entity->start(this->gameRef);
@@ -141,35 +164,251 @@ void Level::entity_remove(Entity *entity)
         delete entities[remove_index];
     }
 
-    // Allocate a new array with one fewer slot (if any remain)
-    Entity **newEntities = (entity_count - 1 > 0) ? new Entity *[entity_count - 1] : nullptr;
-    // Copy over all pointers except the removed one
-    for (int i = 0, j = 0; i < entity_count; i++)
+    // Shift the remaining pointers down, keeping their order (capacity is kept)
+    for (int i = remove_index; i < entity_count - 1; i++)
     {
-        if (i == remove_index)
-            continue;
-        newEntities[j++] = entities[i];
+        entities[i] = entities[i + 1];
+    }
+    entity_count--;
+    entities[entity_count] = nullptr;
+    grid_ready = false; // indices changed, rebuilt on next update
+}
+
+// Grow the entity array and the grid node arrays to hold at least capacity entities
+bool Level::entity_reserve(int capacity)
+{
+    if (capacity <= entity_capacity)
+        return true;
+    if (capacity * LEVEL_GRID_SPAN > INT16_MAX)
+        return false;
+
+    Entity **newEntities = new Entity *[capacity];
+    int16_t *newPrev = new int16_t[capacity * LEVEL_GRID_SPAN];
+    int16_t *newNext = new int16_t[capacity * LEVEL_GRID_SPAN];
+    int16_t *newBucket = new int16_t[capacity * LEVEL_GRID_SPAN];
+    uint16_t *newMark = new uint16_t[capacity];
+    if (!newEntities || !newPrev || !newNext || !newBucket || !newMark)
+    {
+        delete[] newEntities;
+        delete[] newPrev;
+        delete[] newNext;
+        delete[] newBucket;
+        delete[] newMark;
+        return false;
     }
 
-    // Free the old array and update state
+    for (int i = 0; i < entity_count; i++)
+    {
+        newEntities[i] = entities[i];
+    }
+    for (int i = 0; i < capacity; i++)
+    {
+        newMark[i] = 0;
+    }
     delete[] entities;
+    delete[] grid_prev;
+    delete[] grid_next;
+    delete[] grid_bucket;
+    delete[] query_mark;
     entities = newEntities;
-    entity_count--;
+    grid_prev = newPrev;
+    grid_next = newNext;
+    grid_bucket = newBucket;
+    query_mark = newMark;
+    query_stamp = 0;
+    entity_capacity = capacity;
+    grid_ready = false; // node arrays are uninitialized
+    return true;
 }
 
-// Check if any entity has collided with the given entity
-bool Level::has_collided(Entity *entity) const
+// Grow the collision result buffers used by update to hold at least capacity entries
+bool Level::scratch_reserve(int capacity)
 {
+    if (capacity <= scratch_capacity)
+        return true;
+
+    // Match the entity array, which grows by doubling
+    if (capacity < entity_capacity)
+        capacity = entity_capacity;
+    int *newIndices = new int[capacity];
+    Entity **newCollisions = new Entity *[capacity];
+    if (!newIndices || !newCollisions)
+    {
+        delete[] newIndices;
+        delete[] newCollisions;
+        return false;
+    }
+    delete[] scratch_indices;
+    delete[] scratch_collisions;
+    scratch_indices = newIndices;
+    scratch_collisions = newCollisions;
+    scratch_capacity = capacity;
+    return true;
+}
+
+// Range of grid cells covered by an entity, false if it spans more than LEVEL_GRID_SPAN cells
+bool Level::grid_cells(const Entity *entity, int &cx0, int &cy0, int &cx1, int &cy1) const
+{
+    cx0 = (int)floorf(entity->position.x / LEVEL_GRID_CELL_SIZE);
+    cy0 = (int)floorf(entity->position.y / LEVEL_GRID_CELL_SIZE);
+    cx1 = (int)floorf((entity->position.x + entity->size.x) / LEVEL_GRID_CELL_SIZE);
+    cy1 = (int)floorf((entity->position.y + entity->size.y) / LEVEL_GRID_CELL_SIZE);
+    return (cx1 - cx0 + 1) * (cy1 - cy0 + 1) <= LEVEL_GRID_SPAN;
+}
+
+static inline int16_t grid_hash(int cx, int cy)
+{
+    return (int16_t)(((unsigned)cx * 73856093u ^ (unsigned)cy * 19349663u) & (LEVEL_GRID_BUCKETS - 1));
+}
+
+// Link the nodes of entity index into the buckets of the cells it covers
+void Level::grid_insert(int index)
+{
+    Entity *entity = entities[index];
+    if (entity == nullptr)
+        return;
+
+    int16_t buckets[LEVEL_GRID_SPAN];
+    int n = 0;
+    int cx0, cy0, cx1, cy1;
+    if (grid_cells(entity, cx0, cy0, cx1, cy1))
+    {
+        for (int cy = cy0; cy <= cy1; cy++)
+        {
+            for (int cx = cx0; cx <= cx1; cx++)
+            {
+                buckets[n++] = grid_hash(cx, cy);
+            }
+        }
+    }
+    else
+    {
+        buckets[n++] = LEVEL_GRID_BUCKETS; // oversized, checked by every query
+    }
+
+    for (int k = 0; k < n; k++)
+    {
+        int16_t node = index * LEVEL_GRID_SPAN + k;
+        int16_t b = buckets[k];
+        grid_bucket[node] = b;
+        grid_prev[node] = -1;
+        grid_next[node] = grid_head[b];
+        if (grid_head[b] != -1)
+            grid_prev[grid_head[b]] = node;
+        grid_head[b] = node;
+    }
+}
+
+// Unlink the nodes of entity index from their buckets
+void Level::grid_unlink(int index)
+{
+    for (int k = 0; k < LEVEL_GRID_SPAN; k++)
+    {
+        int16_t node = index * LEVEL_GRID_SPAN + k;
+        int16_t b = grid_bucket[node];
+        if (b == -1)
+            continue;
+        if (grid_prev[node] != -1)
+            grid_next[grid_prev[node]] = grid_next[node];
+        else
+            grid_head[b] = grid_next[node];
+        if (grid_next[node] != -1)
+            grid_prev[grid_next[node]] = grid_prev[node];
+        grid_bucket[node] = -1;
+    }
+}
+
+// Hash every entity into the grid from scratch
+void Level::grid_rebuild()
+{
+    for (int b = 0; b <= LEVEL_GRID_BUCKETS; b++)
+    {
+        grid_head[b] = -1;
+    }
+    for (int i = 0; i < entity_count * LEVEL_GRID_SPAN; i++)
+    {
+        grid_bucket[i] = -1;
+    }
     for (int i = 0; i < entity_count; i++)
     {
-        if (entities[i] != nullptr &&
-            entities[i] != entity &&
-            is_collision(entity, entities[i]))
+        grid_insert(i);
+    }
+    grid_ready = true;
+}
+
+// Collect the indices of the entities colliding with entity, in ascending order
+// (the order of the entities array, like a linear scan would return them)
+int Level::grid_query(const Entity *entity, int *result, bool first_only) const
+{
+    int count = 0;
+    int cx0, cy0, cx1, cy1;
+    if (!grid_ready || !grid_cells(entity, cx0, cy0, cx1, cy1))
+    {
+        // No grid or a very large entity: test against everything
+        for (int i = 0; i < entity_count; i++)
+        {
+            if (entities[i] != nullptr &&
+                entities[i] != entity && // Skip self
+                is_collision(entity, entities[i]))
+            {
+                result[count++] = i;
+                if (first_only)
+                    break;
+            }
+        }
+        return count;
+    }
+
+    if (++query_stamp == 0)
+    {
+        // Stamp wrapped around, forget the old marks
+        for (int i = 0; i < entity_capacity; i++)
+        {
+            query_mark[i] = 0;
+        }
+        query_stamp = 1;
+    }
+
+    for (int cy = cy0; cy <= cy1 + 1; cy++)
+    {
+        for (int cx = cx0; cx <= cx1; cx++)
         {
-            return true;
+            // The extra row visits the oversized bucket
+            int16_t b = cy <= cy1 ? grid_hash(cx, cy) : LEVEL_GRID_BUCKETS;
+            for (int16_t node = grid_head[b]; node != -1; node = grid_next[node])
+            {
+                int i = node / LEVEL_GRID_SPAN;
+                if (query_mark[i] == query_stamp)
+                    continue;
+                query_mark[i] = query_stamp;
+                if (entities[i] != nullptr &&
+                    entities[i] != entity && // Skip self
+                    is_collision(entity, entities[i]))
+                {
+                    // Insertion sort, the result lists are short
+                    int j = count++;
+                    while (j > 0 && result[j - 1] > i)
+                    {
+                        result[j] = result[j - 1];
+                        j--;
+                    }
+                    result[j] = i;
+                    if (first_only)
+                        return count;
+                }
+            }
+            if (cy > cy1)
+                break; // oversized bucket visited once
         }
     }
-    return false;
+    return count;
+}
+
+// Check if any entity has collided with the given entity
+bool Level::has_collided(Entity *entity) const
+{
+    int index;
+    return grid_query(entity, &index, true) > 0;
 }
 
 // Determine if two entities are colliding
@@ -309,6 +548,12 @@ void Level::stop()
 // Update all active entities
 void Level::update(Game *game)
 {
+    // Positions may have been changed outside of update, so start from a fresh grid
+    if (entity_count > 0)
+    {
+        grid_rebuild();
+    }
+
     for (int i = 0; i < entity_count; i++)
     {
         Entity *ent = entities[i];
@@ -316,15 +561,48 @@ void Level::update(Game *game)
         if (ent != nullptr && ent->is_active)
         {
             ent->update(game);
+            if (grid_ready)
+            {
+                // The entity probably moved, rehash it before querying
+                grid_unlink(i);
+                grid_insert(i);
+            }
 
-            int count = 0;
-            Entity **collisions = collision_list(ent, count);
+            // Handlers below may add entities, so the buffers are only grown here
+            if (!scratch_reserve(entity_count))
+            {
+                FURI_LOG_E("Level", "Failed to allocate memory for collision results");
+                continue;
+            }
+            int *indices = scratch_indices;
+            Entity **collisions = scratch_collisions;
+            int count = grid_query(ent, indices, false);
+            for (int j = 0; j < count; j++)
+            {
+                collisions[j] = entities[indices[j]];
+            }
 
             for (int j = 0; j < count; j++)
             {
                 ent->collision(collisions[j], game);
             }
-            delete[] collisions;
+
+            // Collision handlers may push either entity around. If an entity was
+            // added or removed meanwhile the grid is off, and queries fall back
+            // to a linear scan until the next update.
+            if (grid_ready)
+            {
+                grid_unlink(i);
+                grid_insert(i);
+                for (int j = 0; j < count; j++)
+                {
+                    grid_unlink(indices[j]);
+                    grid_insert(indices[j]);
+                }
+            }
         }
     }
+
+    // Positions may change outside of update, don't trust the grid until the next one
+    grid_ready = false;
 }
@@ -1,6 +1,15 @@
 #pragma once
+#include <stdint.h>
 #include "engine/vector.hpp"
 
+// Collision grid: entity bounds are hashed into cells of LEVEL_GRID_CELL_SIZE
+// world units (one DynamicMap tile is one unit). Cells are larger than the
+// biggest entity (the 10x10 player), so entities cover at most 2x2 cells, and
+// a 128x64 level is 8x4 cells, one per bucket.
+#define LEVEL_GRID_CELL_SIZE 16.0f
+#define LEVEL_GRID_BUCKETS 64 // power of two
+#define LEVEL_GRID_SPAN 4     // max cells per entity, larger entities go to an overflow bucket
+
 // Forward declarations
 class Game;
 class Entity;
@@ -58,8 +67,30 @@ private:
     Game *gameRef;
     Vector size;
     int entity_count;
+    int entity_capacity;
     Entity **entities;
+    // Spatial hash of entity bounds, rebuilt at the start of every update.
+    // Entity i owns the nodes i * LEVEL_GRID_SPAN .. + LEVEL_GRID_SPAN - 1
+    int16_t grid_head[LEVEL_GRID_BUCKETS + 1]; // last bucket holds oversized entities
+    int16_t *grid_prev;
+    int16_t *grid_next;
+    int16_t *grid_bucket;
+    mutable uint16_t *query_mark; // per-entity stamp to skip duplicate candidates
+    mutable uint16_t query_stamp;
+    // Collision results reused by update, grown only between queries
+    int *scratch_indices;
+    Entity **scratch_collisions;
+    int scratch_capacity;
+    bool grid_ready; // false while the grid doesn't match the entities array
     // Callback Functions
     void (*_start)(Level &);
     void (*_stop)(Level &);
+
+    bool entity_reserve(int capacity);
+    bool grid_cells(const Entity *entity, int &cx0, int &cy0, int &cx1, int &cy1) const;
+    void grid_insert(int index);
+    void grid_rebuild();
+    int grid_query(const Entity *entity, int *result, bool first_only) const;
+    void grid_unlink(int index);
+    bool scratch_reserve(int capacity);
 };
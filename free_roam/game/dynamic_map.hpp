@@ -6,6 +6,7 @@
 #define MAX_MAP_WIDTH 64
 #define MAX_MAP_HEIGHT 64
 #define MAX_WALLS 100
+#define RENDER_COLUMNS 64 // SCREEN_WIDTH / RES_DIVIDER
 
 enum TileType
 {
@@ -42,10 +43,146 @@ private:
     uint8_t wall_count;
     const char *name;
     bool fillIn;
+    uint32_t revision; // bumped on every tile change, invalidates the column cache
+
+    // Column cache: wall slices of the last rendered view, reused while the
+    // player and the map don't change
+    mutable int8_t column_start_y[RENDER_COLUMNS];
+    mutable uint8_t column_dots[RENDER_COLUMNS];
+    mutable bool column_cache_valid;
+    mutable uint32_t cached_revision;
+    mutable float cached_view_height;
+    mutable Vector cached_pos;
+    mutable Vector cached_dir;
+    mutable Vector cached_plane;
+
+    // Cast the ray of one screen column and store the wall slice in the column cache
+    void castColumn(uint8_t column, float view_height, Vector player_pos, Vector player_dir, Vector player_plane) const
+    {
+        float camera_x = cameraX(column);
+        float ray_x = player_dir.x + player_plane.x * camera_x;
+        float ray_y = player_dir.y + player_plane.y * camera_x;
+        uint8_t map_x = (uint8_t)player_pos.x;
+        uint8_t map_y = (uint8_t)player_pos.y;
+
+        column_dots[column] = 0;
+
+        // Prevent division by zero
+        if (ray_x == 0)
+            ray_x = 0.00001f;
+        if (ray_y == 0)
+            ray_y = 0.00001f;
+
+        float delta_x = fabs(1 / ray_x);
+        float delta_y = fabs(1 / ray_y);
+
+        int8_t step_x;
+        int8_t step_y;
+        float side_x;
+        float side_y;
+
+        if (ray_x < 0)
+        {
+            step_x = -1;
+            side_x = (player_pos.x - map_x) * delta_x;
+        }
+        else
+        {
+            step_x = 1;
+            side_x = (map_x + (float)1.0 - player_pos.x) * delta_x;
+        }
+
+        if (ray_y < 0)
+        {
+            step_y = -1;
+            side_y = (player_pos.y - map_y) * delta_y;
+        }
+        else
+        {
+            step_y = 1;
+            side_y = (map_y + (float)1.0 - player_pos.y) * delta_y;
+        }
+
+        // Wall detection
+        uint8_t depth = 0;
+        bool hit = 0;
+        bool side = 0;
+
+        // Follow the ray until we hit a wall or reach max depth
+        while (!hit && depth < 12) // MAX_RENDER_DEPTH
+        {
+            // Cast the ray forward
+            if (side_x < side_y)
+            {
+                side_x += delta_x;
+                map_x += step_x;
+                side = 0;
+            }
+            else
+            {
+                side_y += delta_y;
+                map_y += step_y;
+                side = 1;
+            }
+
+            // Check if the coordinates are within the map boundaries
+            if (map_x < width && map_y < height)
+            {
+                // Use the tile from our actual map data
+                TileType tile = tiles[map_y][map_x];
+                hit = (tile == TILE_WALL || tile == TILE_DOOR);
+            }
+
+            depth++;
+        }
+
+        if (!hit)
+            return;
+
+        float distance;
+        if (side == 0)
+        {
+            distance = fmax(1, (map_x - player_pos.x + (1 - step_x) / 2) / ray_x);
+        }
+        else
+        {
+            distance = fmax(1, (map_y - player_pos.y + (1 - step_y) / 2) / ray_y);
+        }
+
+        // rendered line height
+        uint8_t line_height = 56 / distance;                                          // RENDER_HEIGHT
+        int8_t start_y = (int8_t)(view_height / distance - line_height / 2 + 56 / 2); // RENDER_HEIGHT
+        int8_t end_y = (int8_t)(view_height / distance + line_height / 2 + 56 / 2);
+
+        // Clamp to screen bounds
+        if (start_y < 0)
+            start_y = 0;
+        if (end_y >= 64)
+            end_y = 63;
+
+        column_start_y[column] = start_y;
+        column_dots[column] = end_y - start_y;
+    }
+
+    // Camera space x coordinate of each column, from -1 (left) to 1 (right)
+    static float cameraX(uint8_t column)
+    {
+        static float table[RENDER_COLUMNS];
+        static bool table_ready = false;
+        if (!table_ready)
+        {
+            for (uint8_t i = 0; i < RENDER_COLUMNS; i++)
+            {
+                table[i] = 2 * (float)(i * 2) / 128 - 1; // SCREEN_WIDTH
+            }
+            table_ready = true;
+        }
+        return table[column];
+    }
 
 public:
     // Constructor
-    DynamicMap(const char *name, uint8_t w, uint8_t h, bool addBorder = true, bool fillIn = false) : width(w), height(h), wall_count(0), name(name), fillIn(fillIn)
+    DynamicMap(const char *name, uint8_t w, uint8_t h, bool addBorder = true, bool fillIn = false) : width(w), height(h), wall_count(0), name(name), fillIn(fillIn), revision(0), column_cache_valid(false)
     {
         memset(tiles, 0, sizeof(tiles));
         if (addBorder)
@@ -199,142 +336,48 @@ public:
 
     void render(float view_height, Draw *const canvas, Vector player_pos, Vector player_dir, Vector player_plane) const
     {
-        // render walls using existing raycasting
-        for (uint8_t x = 0; x < 128; x += 2) // SCREEN_WIDTH with RES_DIVIDER
+        // Recast only when the view or the map changed since the last frame
+        if (!column_cache_valid || cached_revision != revision || cached_view_height != view_height ||
+            cached_pos != player_pos || cached_dir != player_dir || cached_plane != player_plane)
         {
-            float camera_x = 2 * (float)x / 128 - 1; // SCREEN_WIDTH
-            float ray_x = player_dir.x + player_plane.x * camera_x;
-            float ray_y = player_dir.y + player_plane.y * camera_x;
-            uint8_t map_x = (uint8_t)player_pos.x;
-            uint8_t map_y = (uint8_t)player_pos.y;
-
-            // Prevent division by zero
-            if (ray_x == 0)
-                ray_x = 0.00001f;
-            if (ray_y == 0)
-                ray_y = 0.00001f;
-
-            float delta_x = fabs(1 / ray_x);
-            float delta_y = fabs(1 / ray_y);
-
-            int8_t step_x;
-            int8_t step_y;
-            float side_x;
-            float side_y;
-
-            if (ray_x < 0)
-            {
-                step_x = -1;
-                side_x = (player_pos.x - map_x) * delta_x;
-            }
-            else
-            {
-                step_x = 1;
-                side_x = (map_x + (float)1.0 - player_pos.x) * delta_x;
-            }
-
-            if (ray_y < 0)
+            for (uint8_t column = 0; column < RENDER_COLUMNS; column++)
             {
-                step_y = -1;
-                side_y = (player_pos.y - map_y) * delta_y;
+                castColumn(column, view_height, player_pos, player_dir, player_plane);
             }
-            else
-            {
-                step_y = 1;
-                side_y = (map_y + (float)1.0 - player_pos.y) * delta_y;
-            }
-
-            // Wall detection
-            uint8_t depth = 0;
-            bool hit = 0;
-            bool side;
+            cached_view_height = view_height;
+            cached_pos = player_pos;
+            cached_dir = player_dir;
+            cached_plane = player_plane;
+            cached_revision = revision;
+            column_cache_valid = true;
+        }
 
-            // Follow the ray until we hit a wall or reach max depth
-            while (!hit && depth < 12) // MAX_RENDER_DEPTH
+        // Draw the cached wall slices
+        for (uint8_t column = 0; column < RENDER_COLUMNS; column++)
+        {
+            uint8_t x = column * 2; // RES_DIVIDER
+            int8_t start_y = column_start_y[column];
+            uint8_t dots = column_dots[column];
+            if (fillIn)
             {
-                // Cast the ray forward
-                if (side_x < side_y)
+                // Fill in walls pixel-by-pixel
+                for (int i = 0; i < dots; i++)
                 {
-                    side_x += delta_x;
-                    map_x += step_x;
-                    side = 0;
-                }
-                else
-                {
-                    side_y += delta_y;
-                    map_y += step_y;
-                    side = 1;
-                }
-
-                // Always default to empty space
-                uint8_t block = 0x0;
-
-                // Check if the coordinates are within the map boundaries
-                if (map_x < width && map_y < height)
-                {
-                    // Use the tile from our actual map data
-                    TileType tile = tiles[map_y][map_x];
-                    if (tile == TILE_WALL || tile == TILE_DOOR)
+                    // Draw the outline pixels
+                    canvas->drawPixel(Vector(x, start_y + i), ColorBlack);
+                    // Fill in the wall by drawing additional pixels to the right
+                    if (x + 1 < 128) // Make sure we don't go out of bounds
                     {
-                        block = 0xF;
+                        canvas->drawPixel(Vector(x + 1, start_y + i), ColorBlack);
                     }
                 }
-
-                if (block == 0xF) // Hit a wall
-                {
-                    hit = 1;
-                }
-
-                depth++;
             }
-
-            if (hit)
+            else
             {
-                float distance;
-
-                if (side == 0)
+                // draw the outline
+                for (int i = 0; i < dots; i++)
                 {
-                    distance = fmax(1, (map_x - player_pos.x + (1 - step_x) / 2) / ray_x);
-                }
-                else
-                {
-                    distance = fmax(1, (map_y - player_pos.y + (1 - step_y) / 2) / ray_y);
-                }
-
-                // rendered line height
-                uint8_t line_height = 56 / distance;                                          // RENDER_HEIGHT
-                int8_t start_y = (int8_t)(view_height / distance - line_height / 2 + 56 / 2); // RENDER_HEIGHT
-                int8_t end_y = (int8_t)(view_height / distance + line_height / 2 + 56 / 2);
-
-                // Clamp to screen bounds
-                if (start_y < 0)
-                    start_y = 0;
-                if (end_y >= 64)
-                    end_y = 63;
-
-                // Draw vertical line
-                uint8_t dots = end_y - start_y;
-                if (fillIn)
-                {
-                    // Fill in walls pixel-by-pixel
-                    for (int i = 0; i < dots; i++)
-                    {
-                        // Draw the outline pixels
-                        canvas->drawPixel(Vector(x, start_y + i), ColorBlack);
-                        // Fill in the wall by drawing additional pixels to the right
-                        if (x + 1 < 128) // Make sure we don't go out of bounds
-                        {
-                            canvas->drawPixel(Vector(x + 1, start_y + i), ColorBlack);
-                        }
-                    }
-                }
-                else
-                {
-                    // draw the outline
-                    for (int i = 0; i < dots; i++)
-                    {
-                        canvas->drawPixel(Vector(x, start_y + i), ColorBlack);
-                    }
+                    canvas->drawPixel(Vector(x, start_y + i), ColorBlack);
                 }
             }
         }
@@ -347,6 +390,7 @@ public:
         if (x < width && y < height)
         {
             tiles[y][x] = type;
+            revision++;
         }
     }
 };
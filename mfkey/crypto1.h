@@ -15,6 +15,7 @@
 
 static inline uint32_t prng_successor(uint32_t x, uint32_t n);
 static inline int filter(uint32_t const x);
+static inline uint32_t filter_block32(uint32_t const x);
 static inline uint8_t evenparity32(uint32_t x);
 static inline void update_contribution(unsigned int data[], int item, int mask1, int mask2);
 void crypto1_get_lfsr(struct Crypto1State *state, MfClassicKey *lfsr);
@@ -62,6 +63,25 @@ static inline int filter(uint32_t const x)
 	return BIT(0xEC57E80A, f);
 }
 
+// Bit-sliced filter() over 32 consecutive states: bit i of the result is filter(x | i).
+// x must have its low 5 bits clear. Only bits 0-4 vary between lanes, so the first
+// nibble is a constant lane pattern, the second depends on bit 4 alone and the
+// remaining nibbles collapse into a 3-bit index into the output function.
+static inline uint32_t filter_block32(uint32_t const x)
+{
+	uint32_t a = 0xf22cf22c;
+	uint32_t n1 = (x >> 4) & 0xe;
+	uint32_t b = (0u - BIT(0xd938, n1)) & 0x0000ffff;
+	b |= (0u - BIT(0xd938, n1 | 1)) & 0xffff0000;
+	uint32_t k = BIT(0xf22c, x >> 8 & 0xf) << 2 | BIT(0xf22c, x >> 12 & 0xf) << 1 |
+				 BIT(0xd938, x >> 16 & 0xf);
+	uint32_t m00 = 0u - BIT(0xEC57E80A, k);
+	uint32_t m01 = 0u - BIT(0xEC57E80A, 8 | k);
+	uint32_t m10 = 0u - BIT(0xEC57E80A, 16 | k);
+	uint32_t m11 = 0u - BIT(0xEC57E80A, 24 | k);
+	return (~a & ((~b & m00) | (b & m01))) | (a & ((~b & m10) | (b & m11)));
+}
+
 #ifdef __ARM_ARCH_7EM__
 static inline uint8_t evenparity32(uint32_t x)
 {
@@ -72,6 +92,12 @@ static inline uint8_t evenparity32(uint32_t x)
 	// magic 0x6996: bit i tells you parity of i (0 ≤ i < 16)
 	return (uint8_t)((0x6996u >> (x & 0xF)) & 1);
 }
+#else
+// Portable fallback so the crypto core also builds for non Cortex-M4 targets
+static inline uint8_t evenparity32(uint32_t x)
+{
+	return (uint8_t)__builtin_parity(x);
+}
 #endif
 
 static inline void update_contribution(unsigned int data[], int item, int mask1, int mask2)
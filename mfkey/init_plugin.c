@@ -28,6 +28,57 @@
 #define SWAPENDIAN(x) \
     ((x) = ((x) >> 8 & 0xff00ff) | ((x) & 0xff00ff) << 8, (x) = (x) >> 16 | (x) << 16)
 
+#define NONCE_INDEX_INITIAL_SLOTS 64
+#define DICT_CACHE_RAM_RESERVE    (16 * 1024)
+
+// Fields that identify a nonce for deduplication
+typedef struct {
+    uint32_t uid;
+    uint32_t nt0;
+    uint32_t nt1;
+    uint8_t attack;
+    uint8_t key_idx;
+} NonceId;
+
+// State shared by the nonce loaders: dictionary keys cached in RAM so each nonce does not
+// rewind and reparse the dictionary files, and an open addressing index over every loaded
+// nonce, cracked from the dictionary or not, used to drop duplicate nonces.
+typedef struct {
+    uint64_t* dict_keys;
+    size_t dict_key_count;
+    NonceId* seen;
+    size_t seen_count;
+    size_t seen_capacity;
+    uint16_t* index_slots; // seen index + 1, 0 = empty
+    size_t index_size;
+    size_t nonce_capacity;
+    uint32_t duplicates;
+    KeysDict* system_dict;
+    bool system_dict_exists;
+    KeysDict* user_dict;
+} NonceLoadContext;
+
+static bool key_matches_nonce(uint64_t k, MfClassicNonce* nonce) {
+    struct Crypto1State temp = {0, 0};
+    for(int i = 0; i < 24; i++) {
+        (&temp)->odd |= (BIT(k, 2 * i + 1) << (i ^ 3));
+        (&temp)->even |= (BIT(k, 2 * i) << (i ^ 3));
+    }
+    if(nonce->attack == mfkey32) {
+        crypt_word_noret(&temp, nonce->uid_xor_nt1, 0);
+        crypt_word_noret(&temp, nonce->nr1_enc, 1);
+        if(nonce->ar1_enc == (crypt_word(&temp) ^ nonce->p64b)) {
+            return true;
+        }
+    } else if(nonce->attack == static_nested || nonce->attack == static_encrypted) {
+        uint32_t expected_ks1 = crypt_word_ret(&temp, nonce->uid_xor_nt0, 0);
+        if(nonce->ks1_1_enc == expected_ks1) {
+            return true;
+        }
+    }
+    return false;
+}
+
 bool key_already_found_for_nonce_in_dict(KeysDict* dict, MfClassicNonce* nonce) {
     // This function must not be passed the CUID dictionary
     bool found = false;
@@ -35,29 +86,169 @@ bool key_already_found_for_nonce_in_dict(KeysDict* dict, MfClassicNonce* nonce)
     keys_dict_rewind(dict);
     while(keys_dict_get_next_key(dict, key_bytes, sizeof(MfClassicKey))) {
         uint64_t k = bit_lib_bytes_to_num_be(key_bytes, sizeof(MfClassicKey));
-        struct Crypto1State temp = {0, 0};
-        for(int i = 0; i < 24; i++) {
-            (&temp)->odd |= (BIT(k, 2 * i + 1) << (i ^ 3));
-            (&temp)->even |= (BIT(k, 2 * i) << (i ^ 3));
-        }
-        if(nonce->attack == mfkey32) {
-            crypt_word_noret(&temp, nonce->uid_xor_nt1, 0);
-            crypt_word_noret(&temp, nonce->nr1_enc, 1);
-            if(nonce->ar1_enc == (crypt_word(&temp) ^ nonce->p64b)) {
-                found = true;
-                break;
-            }
-        } else if(nonce->attack == static_nested || nonce->attack == static_encrypted) {
-            uint32_t expected_ks1 = crypt_word_ret(&temp, nonce->uid_xor_nt0, 0);
-            if(nonce->ks1_1_enc == expected_ks1) {
-                found = true;
-                break;
-            }
+        if(key_matches_nonce(k, nonce)) {
+            found = true;
+            break;
         }
     }
     return found;
 }
 
+static size_t dict_cache_load(KeysDict* dict, uint64_t* keys, size_t max_keys) {
+    size_t count = 0;
+    uint8_t key_bytes[sizeof(MfClassicKey)];
+    keys_dict_rewind(dict);
+    while(count < max_keys && keys_dict_get_next_key(dict, key_bytes, sizeof(MfClassicKey))) {
+        keys[count++] = bit_lib_bytes_to_num_be(key_bytes, sizeof(MfClassicKey));
+    }
+    return count;
+}
+
+static void nonce_load_context_init(
+    NonceLoadContext* ctx,
+    KeysDict* system_dict,
+    bool system_dict_exists,
+    KeysDict* user_dict) {
+    memset(ctx, 0, sizeof(NonceLoadContext));
+    ctx->system_dict = system_dict;
+    ctx->system_dict_exists = system_dict_exists;
+    ctx->user_dict = user_dict;
+    ctx->nonce_capacity = 1;
+    ctx->seen_capacity = NONCE_INDEX_INITIAL_SLOTS / 2;
+    ctx->seen = malloc(ctx->seen_capacity * sizeof(NonceId));
+    ctx->index_size = NONCE_INDEX_INITIAL_SLOTS;
+    ctx->index_slots = malloc(ctx->index_size * sizeof(uint16_t));
+    memset(ctx->index_slots, 0, ctx->index_size * sizeof(uint16_t));
+
+    // Cache both dictionaries if they fit, otherwise fall back to streaming them per nonce
+    size_t total_keys = keys_dict_get_total_keys(user_dict);
+    if(system_dict_exists) total_keys += keys_dict_get_total_keys(system_dict);
+    size_t cache_size = total_keys * sizeof(uint64_t);
+    if(total_keys > 0 && memmgr_heap_get_max_free_block() > cache_size + DICT_CACHE_RAM_RESERVE) {
+        ctx->dict_keys = malloc(cache_size);
+        if(system_dict_exists) {
+            ctx->dict_key_count = dict_cache_load(system_dict, ctx->dict_keys, total_keys);
+        }
+        ctx->dict_key_count += dict_cache_load(
+            user_dict, ctx->dict_keys + ctx->dict_key_count, total_keys - ctx->dict_key_count);
+    }
+}
+
+static void nonce_load_context_deinit(NonceLoadContext* ctx) {
+    free(ctx->dict_keys);
+    free(ctx->seen);
+    free(ctx->index_slots);
+}
+
+static bool nonce_key_in_dicts(NonceLoadContext* ctx, MfClassicNonce* nonce) {
+    if(ctx->dict_keys) {
+        for(size_t i = 0; i < ctx->dict_key_count; i++) {
+            if(key_matches_nonce(ctx->dict_keys[i], nonce)) return true;
+        }
+        return false;
+    }
+    return (ctx->system_dict_exists &&
+            key_already_found_for_nonce_in_dict(ctx->system_dict, nonce)) ||
+           key_already_found_for_nonce_in_dict(ctx->user_dict, nonce);
+}
+
+static inline uint32_t nonce_hash(const NonceId* id) {
+    uint32_t h = id->uid * 0x9E3779B1u;
+    h ^= id->nt0 * 0x85EBCA77u;
+    h ^= id->nt1 * 0xC2B2AE3Du;
+    h ^= (uint32_t)id->attack << 8 | id->key_idx;
+    return h ^ (h >> 16);
+}
+
+static inline bool nonce_same(const NonceId* a, const NonceId* b) {
+    // key_idx is part of the identity: static nonce tags reuse nt across sectors
+    return a->attack == b->attack && a->uid == b->uid && a->nt0 == b->nt0 &&
+           a->nt1 == b->nt1 && a->key_idx == b->key_idx;
+}
+
+static void nonce_index_put(NonceLoadContext* ctx, size_t idx) {
+    size_t mask = ctx->index_size - 1;
+    size_t slot = nonce_hash(&ctx->seen[idx]) & mask;
+    while(ctx->index_slots[slot]) {
+        slot = (slot + 1) & mask;
+    }
+    ctx->index_slots[slot] = idx + 1;
+}
+
+// Returns false if the nonce was already loaded, otherwise records it
+static bool nonce_index_add(NonceLoadContext* ctx, const MfClassicNonce* nonce) {
+    NonceId id = {
+        .uid = nonce->uid,
+        .nt0 = nonce->nt0,
+        .nt1 = nonce->nt1,
+        .attack = nonce->attack,
+        .key_idx = nonce->key_idx,
+    };
+    size_t mask = ctx->index_size - 1;
+    for(size_t slot = nonce_hash(&id) & mask; ctx->index_slots[slot]; slot = (slot + 1) & mask) {
+        if(nonce_same(&ctx->seen[ctx->index_slots[slot] - 1], &id)) {
+            return false;
+        }
+    }
+
+    if(ctx->seen_count == ctx->seen_capacity) {
+        ctx->seen_capacity *= 2;
+        ctx->seen = realloc(ctx->seen, ctx->seen_capacity * sizeof(NonceId)); //-V701
+    }
+    size_t idx = ctx->seen_count++;
+    ctx->seen[idx] = id;
+
+    // Keep the index at most half full
+    if(ctx->seen_count * 2 > ctx->index_size) {
+        free(ctx->index_slots);
+        ctx->index_size *= 2;
+        ctx->index_slots = malloc(ctx->index_size * sizeof(uint16_t));
+        memset(ctx->index_slots, 0, ctx->index_size * sizeof(uint16_t));
+        for(size_t i = 0; i < ctx->seen_count; i++) {
+            nonce_index_put(ctx, i);
+        }
+    } else {
+        nonce_index_put(ctx, idx);
+    }
+    return true;
+}
+
+static void nonce_array_append(
+    NonceLoadContext* ctx,
+    MfClassicNonceArray* nonce_array,
+    const MfClassicNonce* nonce) {
+    if(nonce_array->remaining_nonces == ctx->nonce_capacity) {
+        ctx->nonce_capacity *= 2;
+        nonce_array->remaining_nonce_array = realloc( //-V701
+            nonce_array->remaining_nonce_array,
+            sizeof(MfClassicNonce) * ctx->nonce_capacity);
+    }
+    nonce_array->remaining_nonce_array[nonce_array->remaining_nonces++] = *nonce;
+    nonce_array->total_nonces++;
+}
+
+// Returns true if the nonce still needs to be cracked and was appended
+static bool nonce_array_add(
+    NonceLoadContext* ctx,
+    MfClassicNonceArray* nonce_array,
+    ProgramState* program_state,
+    MfClassicNonce* nonce) {
+    // Duplicates are dropped before the dictionary check, so they are never counted, cracked
+    // or not
+    if(!nonce_index_add(ctx, nonce)) {
+        ctx->duplicates++;
+        return false;
+    }
+    (program_state->total)++;
+    if(nonce_key_in_dicts(ctx, nonce)) {
+        (program_state->cracked)++;
+        (program_state->num_completed)++;
+        return false;
+    }
+    nonce_array_append(ctx, nonce_array, nonce);
+    return true;
+}
+
 bool napi_mf_classic_mfkey32_nonces_check_presence() {
     Storage* storage = furi_record_open(RECORD_STORAGE);
 
@@ -112,9 +303,7 @@ int binaryStringToInt(const char* binStr) {
 bool load_mfkey32_nonces(
     MfClassicNonceArray* nonce_array,
     ProgramState* program_state,
-    KeysDict* system_dict,
-    bool system_dict_exists,
-    KeysDict* user_dict) {
+    NonceLoadContext* ctx) {
     bool array_loaded = false;
 
     do {
@@ -200,21 +389,7 @@ bool load_mfkey32_nonces(
             res.uid_xor_nt0 = res.uid ^ res.nt0;
             res.uid_xor_nt1 = res.uid ^ res.nt1;
 
-            (program_state->total)++;
-            if((system_dict_exists && key_already_found_for_nonce_in_dict(system_dict, &res)) ||
-               (key_already_found_for_nonce_in_dict(user_dict, &res))) {
-                (program_state->cracked)++;
-                (program_state->num_completed)++;
-                continue;
-            }
-            //FURI_LOG_I(TAG, "No key found for %8lx %8lx", res.uid, res.ar1_enc);
-            // TODO: Refactor
-            nonce_array->remaining_nonce_array = realloc( //-V701
-                nonce_array->remaining_nonce_array,
-                sizeof(MfClassicNonce) * ((nonce_array->remaining_nonces) + 1));
-            nonce_array->remaining_nonces++;
-            nonce_array->remaining_nonce_array[(nonce_array->remaining_nonces) - 1] = res;
-            nonce_array->total_nonces++;
+            nonce_array_add(ctx, nonce_array, program_state, &res);
         }
         furi_string_free(next_line);
         buffered_file_stream_close(nonce_array->stream);
@@ -229,9 +404,7 @@ bool load_mfkey32_nonces(
 bool load_nested_nonces(
     MfClassicNonceArray* nonce_array,
     ProgramState* program_state,
-    KeysDict* system_dict,
-    bool system_dict_exists,
-    KeysDict* user_dict) {
+    NonceLoadContext* ctx) {
     if(!buffered_file_stream_open(
            nonce_array->stream, MF_CLASSIC_NESTED_NONCE_PATH, FSAM_READ, FSOM_OPEN_EXISTING)) {
         return false;
@@ -280,21 +453,9 @@ bool load_nested_nonces(
                 res.uid_xor_nt1 = res.uid ^ res.nt1;
             }
 
-            (program_state->total)++;
-            if((system_dict_exists && key_already_found_for_nonce_in_dict(system_dict, &res)) ||
-               (key_already_found_for_nonce_in_dict(user_dict, &res))) {
-                (program_state->cracked)++;
-                (program_state->num_completed)++;
-                continue;
+            if(nonce_array_add(ctx, nonce_array, program_state, &res)) {
+                array_loaded = true;
             }
-
-            nonce_array->remaining_nonce_array = realloc(
-                nonce_array->remaining_nonce_array,
-                sizeof(MfClassicNonce) * (nonce_array->remaining_nonces + 1));
-            nonce_array->remaining_nonce_array[nonce_array->remaining_nonces] = res;
-            nonce_array->remaining_nonces++;
-            nonce_array->total_nonces++;
-            array_loaded = true;
         }
     }
 
@@ -317,15 +478,29 @@ MfClassicNonceArray* napi_mf_classic_nonce_array_alloc(
     nonce_array->stream = buffered_file_stream_alloc(storage);
     furi_record_close(RECORD_STORAGE);
 
+    uint32_t start = furi_get_tick();
+    NonceLoadContext ctx;
+    nonce_load_context_init(&ctx, system_dict, system_dict_exists, user_dict);
+    uint32_t dict_loaded = furi_get_tick();
+
     if(program_state->mfkey32_present) {
-        load_mfkey32_nonces(
-            nonce_array, program_state, system_dict, system_dict_exists, user_dict);
+        load_mfkey32_nonces(nonce_array, program_state, &ctx);
     }
 
     if(program_state->nested_present) {
-        load_nested_nonces(nonce_array, program_state, system_dict, system_dict_exists, user_dict);
+        load_nested_nonces(nonce_array, program_state, &ctx);
     }
 
+    FURI_LOG_I(
+        TAG,
+        "Dict cache: %zu keys in %lu ms, parsed %d nonces (%lu duplicates) in %lu ms",
+        ctx.dict_key_count,
+        dict_loaded - start,
+        program_state->total,
+        ctx.duplicates,
+        furi_get_tick() - dict_loaded);
+    nonce_load_context_deinit(&ctx);
+
     return nonce_array;
 }
 
@@ -48,13 +48,6 @@
 #define CONST_M2_2 (LF_POLY_EVEN << 1 | 1)
 #define BIT(x, n) ((x) >> (n) & 1)
 #define BEBIT(x, n) BIT(x, (n) ^ 24)
-#define SWAP(a, b)          \
-	do                      \
-	{                       \
-		unsigned int t = a; \
-		a = b;              \
-		b = t;              \
-	} while (0)
 #define SWAPENDIAN(x) \
 	((x) = ((x) >> 8 & 0xff00ff) | ((x) & 0xff00ff) << 8, (x) = (x) >> 16 | (x) << 16)
 // #define SIZEOF(arr) sizeof(arr) / sizeof(*arr)
@@ -318,77 +311,69 @@ static inline __attribute__((hot)) int state_loop(
 	return states_tail;
 }
 
-int binsearch(unsigned int data[], int start, int stop)
-{
-	int mid, val = data[stop] & 0xff000000;
-	while (start != stop)
-	{
-		mid = (stop - start) >> 1;
-		if ((data[start + mid] ^ 0x80000000) > (val ^ 0x80000000))
-			stop = start + mid;
-		else
-			start += mid + 1;
-	}
-	return start;
-}
+// Bucket counters for radix_sort_msb(). The worker thread stack is only 2 KB, so these
+// live in .bss; the sort never re-enters itself (old_recover() recurses after sorting).
+static uint16_t radix_next[256];
+static uint16_t radix_end[256];
 
-void quicksort(unsigned int array[], int low, int high)
+// In-place radix pass on the top byte (American flag sort). old_recover() only joins
+// odd and even states on their top byte, so ordering inside a bucket does not matter.
+static void radix_sort_msb(unsigned int data[], int head, int tail)
 {
-	// Use insertion sort for small arrays (threshold determined by testing)
-	if (high - low < 16)
+	if (tail - head < 16)
 	{
-		// Insertion sort
-		for (int i = low + 1; i <= high; i++)
+		// Insertion sort for small arrays
+		for (int i = head + 1; i <= tail; i++)
 		{
-			unsigned int key = array[i];
+			unsigned int key = data[i];
 			int j = i - 1;
-			while (j >= low && array[j] > key)
+			while (j >= head && (data[j] >> 24) > (key >> 24))
 			{
-				array[j + 1] = array[j];
+				data[j + 1] = data[j];
 				j--;
 			}
-			array[j + 1] = key;
+			data[j + 1] = key;
 		}
 		return;
 	}
 
-	if (low >= high)
-		return;
-
-	// Median-of-three pivot selection
-	int middle = low + (high - low) / 2;
-	if (array[middle] < array[low])
-		SWAP(array[middle], array[low]);
-	if (array[high] < array[low])
-		SWAP(array[high], array[low]);
-	if (array[high] < array[middle])
-		SWAP(array[high], array[middle]);
-
-	unsigned int pivot = array[middle];
-
-	// Rest of quicksort with improved partitioning
-	int i = low, j = high;
-	while (i <= j)
+	memset(radix_end, 0, sizeof(radix_end));
+	for (int i = head; i <= tail; i++)
 	{
-		while (array[i] < pivot)
-			i++;
-		while (array[j] > pivot)
-			j--;
-		if (i <= j)
+		radix_end[data[i] >> 24]++;
+	}
+	uint16_t pos = head;
+	for (int b = 0; b < 256; b++)
+	{
+		radix_next[b] = pos;
+		pos += radix_end[b];
+		radix_end[b] = pos;
+	}
+	for (int b = 0; b < 256; b++)
+	{
+		while (radix_next[b] < radix_end[b])
 		{
-			// swap
-			unsigned int temp = array[i];
-			array[i] = array[j];
-			array[j] = temp;
-			i++;
-			j--;
+			unsigned int v = data[radix_next[b]];
+			unsigned int d = v >> 24;
+			while (d != (unsigned int)b)
+			{
+				unsigned int t = data[radix_next[d]];
+				data[radix_next[d]++] = v;
+				v = t;
+				d = v >> 24;
+			}
+			data[radix_next[b]++] = v;
 		}
 	}
+}
 
-	if (low < j)
-		quicksort(array, low, j);
-	if (high > i)
-		quicksort(array, i, high);
+// Start of the run of entries sharing the top byte of data[tail]
+static inline int msb_group_head(unsigned int data[], int head, int tail)
+{
+	unsigned int msb = data[tail] >> 24;
+	while (tail > head && (data[tail - 1] >> 24) == msb)
+		tail--;
+	return tail;
 }
 
 int extend_table(unsigned int data[], int tbl, int end, int bit, int m1, int m2, unsigned int in)
@@ -472,14 +457,19 @@ int old_recover(
 		}
 	}
 	first_run = 0;
-	quicksort(odd, o_head, o_tail);
-	quicksort(even, e_head, e_tail);
+	radix_sort_msb(odd, o_head, o_tail);
+	radix_sort_msb(even, e_head, e_tail);
+	// Merge join from the top: both lists are grouped by top byte in ascending order
 	while (o_tail >= o_head && e_tail >= e_head)
 	{
-		if (((odd[o_tail] ^ even[e_tail]) >> 24) == 0)
+		unsigned int o_msb = odd[o_tail] >> 24;
+		unsigned int e_msb = even[e_tail] >> 24;
+		if (o_msb == e_msb)
 		{
-			o_tail = binsearch(odd, o_head, o = o_tail);
-			e_tail = binsearch(even, e_head, e = e_tail);
+			o = o_tail;
+			e = e_tail;
+			o_tail = msb_group_head(odd, o_head, o);
+			e_tail = msb_group_head(even, e_head, e);
 			s = old_recover(
 				odd,
 				o_tail--,
@@ -500,13 +490,13 @@ int old_recover(
 				break;
 			}
 		}
-		else if ((odd[o_tail] ^ 0x80000000) > (even[e_tail] ^ 0x80000000))
+		else if (o_msb > e_msb)
 		{
-			o_tail = binsearch(odd, o_head, o_tail) - 1;
+			o_tail = msb_group_head(odd, o_head, o_tail) - 1;
 		}
 		else
 		{
-			e_tail = binsearch(even, e_head, e_tail) - 1;
+			e_tail = msb_group_head(even, e_head, e_tail) - 1;
 		}
 	}
 	return s;
@@ -540,6 +530,74 @@ static inline int sync_state(ProgramState *program_state)
 	return 0;
 }
 
+static inline void msb_insert_unique(
+	struct Msb *msbs,
+	unsigned int *states_buffer,
+	int states_tail,
+	unsigned int msb_head,
+	unsigned int msb_tail)
+{
+	for (int i = states_tail; i >= 0; i--)
+	{
+		unsigned int msb = states_buffer[i] >> 24;
+		if ((msb >= msb_head) && (msb < msb_tail))
+		{
+			// Calculate index once
+			int msb_idx = msb - msb_head;
+
+			// Avoid sequential scan by using a direct flag
+			int found = 0;
+			for (int j = 0; j < msbs[msb_idx].tail; j++)
+			{
+				if (msbs[msb_idx].states[j] == states_buffer[i])
+				{
+					found = 1;
+					break;
+				}
+			}
+
+			if (!found)
+			{
+				int tail = msbs[msb_idx].tail++;
+				msbs[msb_idx].states[tail] = states_buffer[i];
+			}
+		}
+	}
+}
+
+static inline void msb_tables_add_semi_state(
+	int semi_state,
+	int filter_semi_state,
+	int oks,
+	int eks,
+	int oks_bit,
+	int eks_bit,
+	unsigned int in,
+	unsigned int msb_head,
+	unsigned int msb_tail,
+	unsigned int *states_buffer,
+	struct Msb *odd_msbs,
+	struct Msb *even_msbs)
+{
+	int states_tail;
+
+	// Check oks condition
+	if (filter_semi_state == oks_bit)
+	{
+		states_buffer[0] = semi_state;
+		states_tail = state_loop(states_buffer, oks, CONST_M1_1, CONST_M2_1, 0, 0);
+		msb_insert_unique(odd_msbs, states_buffer, states_tail, msb_head, msb_tail);
+	}
+
+	// Check eks condition
+	if (filter_semi_state == eks_bit)
+	{
+		states_buffer[0] = semi_state;
+		states_tail = state_loop(states_buffer, eks, CONST_M1_2, CONST_M2_2, in, 3);
+		msb_insert_unique(even_msbs, states_buffer, states_tail, msb_head, msb_tail);
+	}
+}
+
 int calculate_msb_tables(
 	int oks,
 	int eks,
@@ -555,9 +613,7 @@ int calculate_msb_tables(
 {
 	unsigned int msb_head = (MSB_LIMIT * msb_round);
 	unsigned int msb_tail = (MSB_LIMIT * (msb_round + 1));
-	int states_tail = 0;
 	int semi_state = 0;
-	unsigned int msb = 0;
 
 	// Preprocessed in value
 	in = ((in >> 16 & 0xff) | (in << 16) | (in & 0xff00)) << 1;
@@ -573,7 +629,15 @@ int calculate_msb_tables(
 	// Check for stop request less frequently
 	int sync_check_interval = 32768 * 2; // Doubled the interval
 
-	for (semi_state = 1 << 20; semi_state >= 0; semi_state--)
+	// semi_state 1 << 20 is outside the 32-state blocks below, handle it on its own
+	msb_tables_add_semi_state(
+		1 << 20, filter(1 << 20), oks, eks, oks_bit, eks_bit, in, msb_head, msb_tail,
+		states_buffer, odd_msbs, even_msbs);
+
+	// Sweep the remaining semi states 32 at a time, descending as before. filter_block32()
+	// evaluates the whole block at once and only the lanes that match a keystream bit
+	// are expanded through state_loop().
+	for (semi_state = (1 << 20) - 32; semi_state >= 0; semi_state -= 32)
 	{
 		if (semi_state % sync_check_interval == 0)
 		{
@@ -583,75 +647,17 @@ int calculate_msb_tables(
 			}
 		}
 
-		// Process both filter conditions in one pass when possible
-		int filter_semi_state = filter(semi_state);
-
-		// Check oks condition
-		if (filter_semi_state == oks_bit)
-		{
-			states_buffer[0] = semi_state;
-			states_tail = state_loop(states_buffer, oks, CONST_M1_1, CONST_M2_1, 0, 0);
-
-			for (int i = states_tail; i >= 0; i--)
-			{
-				msb = states_buffer[i] >> 24;
-				if ((msb >= msb_head) && (msb < msb_tail))
-				{
-					// Calculate index once
-					int msb_idx = msb - msb_head;
-
-					// Avoid sequential scan by using a direct flag
-					int found = 0;
-					for (int j = 0; j < odd_msbs[msb_idx].tail; j++)
-					{
-						if (odd_msbs[msb_idx].states[j] == states_buffer[i])
-						{
-							found = 1;
-							break;
-						}
-					}
-
-					if (!found)
-					{
-						int tail = odd_msbs[msb_idx].tail++;
-						odd_msbs[msb_idx].states[tail] = states_buffer[i];
-					}
-				}
-			}
-		}
-
-		// Check eks condition
-		if (filter_semi_state == eks_bit)
+		uint32_t filter_mask = filter_block32(semi_state);
+		uint32_t odd_mask = oks_bit ? filter_mask : ~filter_mask;
+		uint32_t even_mask = eks_bit ? filter_mask : ~filter_mask;
+		uint32_t lanes = odd_mask | even_mask;
+		while (lanes)
 		{
-			states_buffer[0] = semi_state;
-			states_tail = state_loop(states_buffer, eks, CONST_M1_2, CONST_M2_2, in, 3);
-
-			for (int i = 0; i <= states_tail; i++)
-			{
-				msb = states_buffer[i] >> 24;
-				if ((msb >= msb_head) && (msb < msb_tail))
-				{
-					// Calculate index once
-					int msb_idx = msb - msb_head;
-
-					// Avoid sequential scan
-					int found = 0;
-					for (int j = 0; j < even_msbs[msb_idx].tail; j++)
-					{
-						if (even_msbs[msb_idx].states[j] == states_buffer[i])
-						{
-							found = 1;
-							break;
-						}
-					}
-
-					if (!found)
-					{
-						int tail = even_msbs[msb_idx].tail++;
-						even_msbs[msb_idx].states[tail] = states_buffer[i];
-					}
-				}
-			}
+			int lane = 31 - __builtin_clz(lanes);
+			lanes &= ~(1u << lane);
+			msb_tables_add_semi_state(
+				semi_state | lane, BIT(filter_mask, lane), oks, eks, oks_bit, eks_bit, in,
+				msb_head, msb_tail, states_buffer, odd_msbs, even_msbs);
 		}
 	}
 
@@ -0,0 +1,294 @@
+#include "fft.h"
+
+#define FFT_QUARTER (FFT_MAX_SIZE / 4)
+#define FFT_HALF    (FFT_MAX_SIZE / 2)
+
+// sin(2 * pi * j / FFT_MAX_SIZE) for the first quarter wave, other angles use symmetry
+static const float sin_table_f32[FFT_QUARTER + 1] = {
+    0.00000000f, 0.00613588f, 0.01227154f, 0.01840673f, 0.02454123f, 0.03067480f, 0.03680722f,
+    0.04293826f, 0.04906767f, 0.05519524f, 0.06132074f, 0.06744392f, 0.07356456f, 0.07968244f,
+    0.08579731f, 0.09190896f, 0.09801714f, 0.10412163f, 0.11022221f, 0.11631863f, 0.12241068f,
+    0.12849811f, 0.13458071f, 0.14065824f, 0.14673047f, 0.15279719f, 0.15885814f, 0.16491312f,
+    0.17096189f, 0.17700422f, 0.18303989f, 0.18906866f, 0.19509032f, 0.20110463f, 0.20711138f,
+    0.21311032f, 0.21910124f, 0.22508391f, 0.23105811f, 0.23702361f, 0.24298018f, 0.24892761f,
+    0.25486566f, 0.26079412f, 0.26671276f, 0.27262136f, 0.27851969f, 0.28440754f, 0.29028468f,
+    0.29615089f, 0.30200595f, 0.30784964f, 0.31368174f, 0.31950203f, 0.32531029f, 0.33110631f,
+    0.33688985f, 0.34266072f, 0.34841868f, 0.35416353f, 0.35989504f, 0.36561300f, 0.37131719f,
+    0.37700741f, 0.38268343f, 0.38834505f, 0.39399204f, 0.39962420f, 0.40524131f, 0.41084317f,
+    0.41642956f, 0.42200027f, 0.42755509f, 0.43309382f, 0.43861624f, 0.44412214f, 0.44961133f,
+    0.45508359f, 0.46053871f, 0.46597650f, 0.47139674f, 0.47679923f, 0.48218377f, 0.48755016f,
+    0.49289819f, 0.49822767f, 0.50353838f, 0.50883014f, 0.51410274f, 0.51935599f, 0.52458968f,
+    0.52980362f, 0.53499762f, 0.54017147f, 0.54532499f, 0.55045797f, 0.55557023f, 0.56066158f,
+    0.56573181f, 0.57078075f, 0.57580819f, 0.58081396f, 0.58579786f, 0.59075970f, 0.59569930f,
+    0.60061648f, 0.60551104f, 0.61038281f, 0.61523159f, 0.62005721f, 0.62485949f, 0.62963824f,
+    0.63439328f, 0.63912444f, 0.64383154f, 0.64851440f, 0.65317284f, 0.65780669f, 0.66241578f,
+    0.66699992f, 0.67155895f, 0.67609270f, 0.68060100f, 0.68508367f, 0.68954054f, 0.69397146f,
+    0.69837625f, 0.70275474f, 0.70710678f, 0.71143220f, 0.71573083f, 0.72000251f, 0.72424708f,
+    0.72846439f, 0.73265427f, 0.73681657f, 0.74095113f, 0.74505779f, 0.74913639f, 0.75318680f,
+    0.75720885f, 0.76120239f, 0.76516727f, 0.76910334f, 0.77301045f, 0.77688847f, 0.78073723f,
+    0.78455660f, 0.78834643f, 0.79210658f, 0.79583690f, 0.79953727f, 0.80320753f, 0.80684755f,
+    0.81045720f, 0.81403633f, 0.81758481f, 0.82110251f, 0.82458930f, 0.82804505f, 0.83146961f,
+    0.83486287f, 0.83822471f, 0.84155498f, 0.84485357f, 0.84812034f, 0.85135519f, 0.85455799f,
+    0.85772861f, 0.86086694f, 0.86397286f, 0.86704625f, 0.87008699f, 0.87309498f, 0.87607009f,
+    0.87901223f, 0.88192126f, 0.88479710f, 0.88763962f, 0.89044872f, 0.89322430f, 0.89596625f,
+    0.89867447f, 0.90134885f, 0.90398929f, 0.90659570f, 0.90916798f, 0.91170603f, 0.91420976f,
+    0.91667906f, 0.91911385f, 0.92151404f, 0.92387953f, 0.92621024f, 0.92850608f, 0.93076696f,
+    0.93299280f, 0.93518351f, 0.93733901f, 0.93945922f, 0.94154407f, 0.94359346f, 0.94560733f,
+    0.94758559f, 0.94952818f, 0.95143502f, 0.95330604f, 0.95514117f, 0.95694034f, 0.95870347f,
+    0.96043052f, 0.96212140f, 0.96377607f, 0.96539444f, 0.96697647f, 0.96852209f, 0.97003125f,
+    0.97150389f, 0.97293995f, 0.97433938f, 0.97570213f, 0.97702814f, 0.97831737f, 0.97956977f,
+    0.98078528f, 0.98196387f, 0.98310549f, 0.98421009f, 0.98527764f, 0.98630810f, 0.98730142f,
+    0.98825757f, 0.98917651f, 0.99005821f, 0.99090264f, 0.99170975f, 0.99247953f, 0.99321195f,
+    0.99390697f, 0.99456457f, 0.99518473f, 0.99576741f, 0.99631261f, 0.99682030f, 0.99729046f,
+    0.99772307f, 0.99811811f, 0.99847558f, 0.99879546f, 0.99907773f, 0.99932238f, 0.99952942f,
+    0.99969882f, 0.99983058f, 0.99992470f, 0.99998118f, 1.00000000f
+};
+
+static const int16_t sin_table_q15[FFT_QUARTER + 1] = {
+    0, 201, 402, 603, 804, 1005, 1206, 1407, 1608, 1809, 2009, 2210, 2410, 2611, 2811, 3012, 3212,
+    3412, 3612, 3811, 4011, 4210, 4410, 4609, 4808, 5007, 5205, 5404, 5602, 5800, 5998, 6195, 6393,
+    6590, 6786, 6983, 7179, 7375, 7571, 7767, 7962, 8157, 8351, 8545, 8739, 8933, 9126, 9319, 9512,
+    9704, 9896, 10087, 10278, 10469, 10659, 10849, 11039, 11228, 11417, 11605, 11793, 11980, 12167,
+    12353, 12539, 12725, 12910, 13094, 13279, 13462, 13645, 13828, 14010, 14191, 14372, 14553,
+    14732, 14912, 15090, 15269, 15446, 15623, 15800, 15976, 16151, 16325, 16499, 16673, 16846,
+    17018, 17189, 17360, 17530, 17700, 17869, 18037, 18204, 18371, 18537, 18703, 18868, 19032,
+    19195, 19357, 19519, 19680, 19841, 20000, 20159, 20317, 20475, 20631, 20787, 20942, 21096,
+    21250, 21403, 21554, 21705, 21856, 22005, 22154, 22301, 22448, 22594, 22739, 22884, 23027,
+    23170, 23311, 23452, 23592, 23731, 23870, 24007, 24143, 24279, 24413, 24547, 24680, 24811,
+    24942, 25072, 25201, 25329, 25456, 25582, 25708, 25832, 25955, 26077, 26198, 26319, 26438,
+    26556, 26674, 26790, 26905, 27019, 27133, 27245, 27356, 27466, 27575, 27683, 27790, 27896,
+    28001, 28105, 28208, 28310, 28411, 28510, 28609, 28706, 28803, 28898, 28992, 29085, 29177,
+    29268, 29358, 29447, 29534, 29621, 29706, 29791, 29874, 29956, 30037, 30117, 30195, 30273,
+    30349, 30424, 30498, 30571, 30643, 30714, 30783, 30852, 30919, 30985, 31050, 31113, 31176,
+    31237, 31297, 31356, 31414, 31470, 31526, 31580, 31633, 31685, 31736, 31785, 31833, 31880,
+    31926, 31971, 32014, 32057, 32098, 32137, 32176, 32213, 32250, 32285, 32318, 32351, 32382,
+    32412, 32441, 32469, 32495, 32521, 32545, 32567, 32589, 32609, 32628, 32646, 32663, 32678,
+    32692, 32705, 32717, 32728, 32737, 32745, 32752, 32757, 32761, 32765, 32766, 32767
+};
+
+// Angles are in units of 2 * pi / FFT_MAX_SIZE, j is in [0, FFT_HALF]
+static inline float cos_f32(uint32_t j) {
+    return j <= FFT_QUARTER ? sin_table_f32[FFT_QUARTER - j] : -sin_table_f32[j - FFT_QUARTER];
+}
+
+static inline float sin_f32(uint32_t j) {
+    return j <= FFT_QUARTER ? sin_table_f32[j] : sin_table_f32[FFT_HALF - j];
+}
+
+static inline int32_t cos_q15(uint32_t j) {
+    return j <= FFT_QUARTER ? sin_table_q15[FFT_QUARTER - j] : -sin_table_q15[j - FFT_QUARTER];
+}
+
+static inline int32_t sin_q15(uint32_t j) {
+    return j <= FFT_QUARTER ? sin_table_q15[j] : sin_table_q15[FFT_HALF - j];
+}
+
+static inline int16_t saturate_q15(int32_t x) {
+    return x > INT16_MAX ? INT16_MAX : (x < INT16_MIN ? INT16_MIN : x);
+}
+
+// Cosine of 2 * pi * i / n, for any i in [0, n)
+static float window_cos(uint32_t i, uint32_t n) {
+    uint32_t j = (i * (FFT_MAX_SIZE / n)) % FFT_MAX_SIZE;
+    return cos_f32(j > FFT_HALF ? FFT_MAX_SIZE - j : j);
+}
+
+void fft_window_f32(float* window, uint32_t n, FftWindow type) {
+    for(uint32_t i = 0; i < n; i++) {
+        switch(type) {
+        case FftWindowHann:
+            window[i] = 0.5f - 0.5f * window_cos(i, n);
+            break;
+        case FftWindowBlackman:
+            window[i] = 0.42f - 0.5f * window_cos(i, n) + 0.08f * window_cos(2 * i % n, n);
+            break;
+        default:
+            window[i] = 1.0f;
+            break;
+        }
+    }
+}
+
+void fft_window_q15(int16_t* window, uint32_t n, FftWindow type) {
+    for(uint32_t i = 0; i < n; i++) {
+        float w = 1.0f;
+        switch(type) {
+        case FftWindowHann:
+            w = 0.5f - 0.5f * window_cos(i, n);
+            break;
+        case FftWindowBlackman:
+            w = 0.42f - 0.5f * window_cos(i, n) + 0.08f * window_cos(2 * i % n, n);
+            break;
+        default:
+            break;
+        }
+        window[i] = saturate_q15((int32_t)(w * 32767.0f + 0.5f));
+    }
+}
+
+// Radix-2 decimation in time over m interleaved complex values
+static void fft_complex_f32(float* buf, uint32_t m) {
+    for(uint32_t i = 1, j = 0; i < m; i++) {
+        uint32_t bit = m >> 1;
+        for(; j & bit; bit >>= 1) {
+            j ^= bit;
+        }
+        j |= bit;
+
+        if(i < j) {
+            float tmp = buf[2 * i];
+            buf[2 * i] = buf[2 * j];
+            buf[2 * j] = tmp;
+            tmp = buf[2 * i + 1];
+            buf[2 * i + 1] = buf[2 * j + 1];
+            buf[2 * j + 1] = tmp;
+        }
+    }
+
+    for(uint32_t len = 2; len <= m; len <<= 1) {
+        uint32_t half = len >> 1;
+        uint32_t step = FFT_MAX_SIZE / len;
+        for(uint32_t k = 0; k < half; k++) {
+            float wr = cos_f32(k * step);
+            float wi = -sin_f32(k * step);
+            for(uint32_t j = k; j < m; j += len) {
+                float* a = &buf[2 * j];
+                float* b = &buf[2 * (j + half)];
+                float tr = wr * b[0] - wi * b[1];
+                float ti = wr * b[1] + wi * b[0];
+                b[0] = a[0] - tr;
+                b[1] = a[1] - ti;
+                a[0] += tr;
+                a[1] += ti;
+            }
+        }
+    }
+}
+
+void fft_real_f32(float* buf, uint32_t n) {
+    uint32_t m = n >> 1;
+    uint32_t step = FFT_MAX_SIZE / n;
+
+    // Even samples become the real part, odd samples the imaginary part
+    fft_complex_f32(buf, m);
+
+    float re0 = buf[0];
+    float im0 = buf[1];
+    buf[0] = re0 + im0;
+    buf[1] = re0 - im0;
+
+    // Untangle bins k and m - k of the half size transform in one go
+    for(uint32_t k = 1; k <= m / 2; k++) {
+        float* zk = &buf[2 * k];
+        float* zmk = &buf[2 * (m - k)];
+        float fr = zk[0] + zmk[0];
+        float fi = zk[1] - zmk[1];
+        float gr = zk[0] - zmk[0];
+        float gi = zk[1] + zmk[1];
+        float c = cos_f32(k * step);
+        float s = sin_f32(k * step);
+        float tr = c * gi - s * gr;
+        float ti = c * gr + s * gi;
+
+        zk[0] = 0.5f * (fr + tr);
+        zk[1] = 0.5f * (fi - ti);
+        zmk[0] = 0.5f * (fr - tr);
+        zmk[1] = 0.5f * (-fi - ti);
+    }
+}
+
+static void fft_complex_q15(int16_t* buf, uint32_t m) {
+    for(uint32_t i = 1, j = 0; i < m; i++) {
+        uint32_t bit = m >> 1;
+        for(; j & bit; bit >>= 1) {
+            j ^= bit;
+        }
+        j |= bit;
+
+        if(i < j) {
+            int16_t tmp = buf[2 * i];
+            buf[2 * i] = buf[2 * j];
+            buf[2 * j] = tmp;
+            tmp = buf[2 * i + 1];
+            buf[2 * i + 1] = buf[2 * j + 1];
+            buf[2 * j + 1] = tmp;
+        }
+    }
+
+    for(uint32_t len = 2; len <= m; len <<= 1) {
+        uint32_t half = len >> 1;
+        uint32_t step = FFT_MAX_SIZE / len;
+        for(uint32_t k = 0; k < half; k++) {
+            int32_t wr = cos_q15(k * step);
+            int32_t wi = -sin_q15(k * step);
+            for(uint32_t j = k; j < m; j += len) {
+                int16_t* a = &buf[2 * j];
+                int16_t* b = &buf[2 * (j + half)];
+                int32_t tr = (wr * b[0] - wi * b[1]) >> 15;
+                int32_t ti = (wr * b[1] + wi * b[0]) >> 15;
+                int32_t ar = a[0];
+                int32_t ai = a[1];
+                a[0] = (ar + tr) >> 1;
+                a[1] = (ai + ti) >> 1;
+                b[0] = (ar - tr) >> 1;
+                b[1] = (ai - ti) >> 1;
+            }
+        }
+    }
+}
+
+void fft_real_q15(int16_t* buf, uint32_t n) {
+    uint32_t m = n >> 1;
+    uint32_t step = FFT_MAX_SIZE / n;
+
+    fft_complex_q15(buf, m);
+
+    int32_t re0 = buf[0];
+    int32_t im0 = buf[1];
+    buf[0] = (re0 + im0) >> 1;
+    buf[1] = (re0 - im0) >> 1;
+
+    // Same split as the float version, with the extra halving folded into the final shift
+    for(uint32_t k = 1; k <= m / 2; k++) {
+        int16_t* zk = &buf[2 * k];
+        int16_t* zmk = &buf[2 * (m - k)];
+        int64_t fr = (int64_t)(zk[0] + zmk[0]) << 15;
+        int64_t fi = (int64_t)(zk[1] - zmk[1]) << 15;
+        int32_t gr = zk[0] - zmk[0];
+        int32_t gi = zk[1] + zmk[1];
+        int32_t c = cos_q15(k * step);
+        int32_t s = sin_q15(k * step);
+        int64_t tr = (int64_t)c * gi - (int64_t)s * gr;
+        int64_t ti = (int64_t)c * gr + (int64_t)s * gi;
+
+        zk[0] = saturate_q15((int32_t)((fr + tr) >> 17));
+        zk[1] = saturate_q15((int32_t)((fi - ti) >> 17));
+        zmk[0] = saturate_q15((int32_t)((fr - tr) >> 17));
+        zmk[1] = saturate_q15((int32_t)((-fi - ti) >> 17));
+    }
+}
+
+static inline void power_update(float* power, uint32_t k, float p, float alpha) {
+    power[k] = alpha < 1.0f ? power[k] + alpha * (p - power[k]) : p;
+}
+
+void fft_power_f32(const float* buf, float* power, uint32_t n, uint32_t average) {
+    float alpha = 1.0f / (float)(average > 0 ? average : 1);
+    power_update(power, 0, buf[0] * buf[0], alpha);
+    for(uint32_t k = 1; k < n / 2; k++) {
+        float re = buf[2 * k];
+        float im = buf[2 * k + 1];
+        power_update(power, k, re * re + im * im, alpha);
+    }
+}
+
+void fft_power_q15(const int16_t* buf, float* power, uint32_t n, uint32_t average) {
+    float alpha = 1.0f / (float)(average > 0 ? average : 1);
+    power_update(power, 0, (float)((int32_t)buf[0] * buf[0]), alpha);
+    for(uint32_t k = 1; k < n / 2; k++) {
+        // Sum of two -32768 squares doesn't fit int32
+        int64_t re = buf[2 * k];
+        int64_t im = buf[2 * k + 1];
+        power_update(power, k, (float)(re * re + im * im), alpha);
+    }
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <stdint.h>
+
+// Largest supported transform, twiddle tables are sampled for this size
+#define FFT_MAX_SIZE 1024
+
+typedef enum {
+    FftWindowRect,
+    FftWindowHann,
+    FftWindowBlackman,
+} FftWindow;
+
+// Fill n window coefficients, n is a power of two from 4 to FFT_MAX_SIZE
+void fft_window_f32(float* window, uint32_t n, FftWindow type);
+void fft_window_q15(int16_t* window, uint32_t n, FftWindow type);
+
+// Real input FFT of n samples, computed in place as an n/2 point complex FFT plus a split
+// pass. On return buf holds bins 0 to n/2-1 as interleaved re, im pairs, except that the
+// purely real bin n/2 is packed into the imaginary slot of bin 0.
+void fft_real_f32(float* buf, uint32_t n);
+
+// Q15 variant of fft_real_f32, every stage is scaled down to avoid overflow, so the result
+// is the true spectrum divided by n. Keep inputs within half scale for full headroom.
+void fft_real_q15(int16_t* buf, uint32_t n);
+
+// Update power spectrum (n/2 bins) from a packed transform. An average above 1 blends the
+// new frame into power as an exponential moving average over that many frames.
+void fft_power_f32(const float* buf, float* power, uint32_t n, uint32_t average);
+void fft_power_q15(const int16_t* buf, float* power, uint32_t n, uint32_t average);
@@ -0,0 +1,230 @@
+#include "record.h"
+
+#define RECORD_WORKER_STACK_SIZE (2 * 1024)
+#define RECORD_WORKER_FLAG_STOP  (1UL << 0)
+#define RECORD_WORKER_POLL_MS    (1) // DMA interrupt can't wake the thread, so it polls
+
+struct ScopeRecorder {
+    uint16_t* blocks; // SCOPE_RECORD_BLOCKS ring of DMA blocks
+    uint32_t block_samples;
+    __IO uint32_t head; // Blocks pushed, only written by DMA interrupt
+    __IO uint32_t tail; // Blocks written out, only written by writer thread
+    __IO uint32_t dropped_blocks;
+    __IO uint32_t overruns;
+    __IO bool running;
+    uint32_t gaps[SCOPE_RECORD_BLOCKS]; // Blocks dropped right before each slot
+    uint32_t pending_gap; // Blocks dropped since the last pushed one, only used by interrupt
+
+    File* file;
+    FuriThread* thread;
+    ScopeRecordHeader header;
+    uint32_t samples;
+    uint32_t start_tick;
+    uint32_t stop_tick;
+    uint32_t max_write_ticks;
+    bool error;
+};
+
+static bool scope_record_write(ScopeRecorder* recorder, const uint16_t* words, uint32_t count) {
+    if(recorder->error) return false;
+    if(count == 0) return true;
+
+    size_t size = count * sizeof(uint16_t);
+    uint32_t start = furi_get_tick();
+    if(storage_file_write(recorder->file, words, size) != size) {
+        recorder->error = true;
+        return false;
+    }
+
+    uint32_t ticks = furi_get_tick() - start;
+    if(ticks > recorder->max_write_ticks) recorder->max_write_ticks = ticks;
+    return true;
+}
+
+static void scope_record_write_samples(
+    ScopeRecorder* recorder,
+    const uint16_t* samples,
+    uint32_t count) {
+    if(scope_record_write(recorder, samples, count)) recorder->samples += count;
+}
+
+// Mark where dropped blocks are missing, so readers can keep the time axis right
+static void scope_record_write_gap(ScopeRecorder* recorder, uint32_t blocks) {
+    while(blocks > 0) {
+        uint16_t count = MIN(blocks, (uint32_t)SCOPE_RECORD_GAP_MAX);
+        uint16_t marker = SCOPE_RECORD_GAP_FLAG | count;
+        scope_record_write(recorder, &marker, 1);
+        blocks -= count;
+    }
+}
+
+// Write out queued blocks, contiguous slots of the ring go out as one write, up to the
+// next slot that follows a gap
+static void scope_record_drain(ScopeRecorder* recorder) {
+    uint32_t head;
+    while((head = recorder->head) != recorder->tail) {
+        uint32_t slot = recorder->tail % SCOPE_RECORD_BLOCKS;
+        uint32_t available = MIN(head - recorder->tail, SCOPE_RECORD_BLOCKS - slot);
+        uint32_t count = 1;
+        while(count < available && recorder->gaps[slot + count] == 0)
+            count++;
+
+        scope_record_write_gap(recorder, recorder->gaps[slot]);
+        scope_record_write_samples(
+            recorder,
+            &recorder->blocks[slot * recorder->block_samples],
+            count * recorder->block_samples);
+        recorder->tail += count;
+    }
+}
+
+static int32_t scope_record_worker(void* context) {
+    ScopeRecorder* recorder = context;
+    while(true) {
+        uint32_t flags = furi_thread_flags_wait(
+            RECORD_WORKER_FLAG_STOP, FuriFlagWaitAny, furi_ms_to_ticks(RECORD_WORKER_POLL_MS));
+        scope_record_drain(recorder);
+        if(!(flags & FuriFlagError) && (flags & RECORD_WORKER_FLAG_STOP)) break;
+    }
+
+    return 0;
+}
+
+ScopeRecorder* scope_record_alloc(uint32_t block_samples) {
+    furi_check(block_samples > 0 && block_samples <= SCOPE_RECORD_MAX_BLOCK);
+    ScopeRecorder* recorder = malloc(sizeof(ScopeRecorder));
+    memset(recorder, 0, sizeof(ScopeRecorder));
+    recorder->block_samples = block_samples;
+    recorder->blocks = malloc(SCOPE_RECORD_BLOCKS * block_samples * sizeof(uint16_t));
+    return recorder;
+}
+
+void scope_record_free(ScopeRecorder* recorder) {
+    furi_assert(recorder);
+    furi_assert(!recorder->running);
+    free(recorder->blocks);
+    free(recorder);
+}
+
+bool scope_record_start(
+    ScopeRecorder* recorder,
+    Storage* storage,
+    const char* path,
+    uint32_t sample_rate,
+    uint16_t vref) {
+    furi_assert(recorder);
+    furi_assert(!recorder->running);
+
+    recorder->file = storage_file_alloc(storage);
+    if(!storage_file_open(recorder->file, path, FSAM_WRITE, FSOM_CREATE_ALWAYS)) {
+        storage_file_free(recorder->file);
+        recorder->file = NULL;
+        return false;
+    }
+
+    memcpy(recorder->header.magic, SCOPE_RECORD_MAGIC, sizeof(recorder->header.magic));
+    recorder->header.version = SCOPE_RECORD_VERSION;
+    recorder->header.header_size = sizeof(ScopeRecordHeader);
+    recorder->header.sample_rate = sample_rate;
+    recorder->header.resolution = 12;
+    recorder->header.vref = vref;
+    recorder->header.block_samples = recorder->block_samples;
+    recorder->header.samples = 0;
+    recorder->header.dropped_samples = 0;
+
+    // Header is rewritten with final sample counts once recording stops
+    if(storage_file_write(recorder->file, &recorder->header, sizeof(ScopeRecordHeader)) !=
+       sizeof(ScopeRecordHeader)) {
+        storage_file_close(recorder->file);
+        storage_file_free(recorder->file);
+        recorder->file = NULL;
+        return false;
+    }
+
+    recorder->head = 0;
+    recorder->tail = 0;
+    recorder->dropped_blocks = 0;
+    recorder->overruns = 0;
+    recorder->pending_gap = 0;
+    recorder->samples = 0;
+    recorder->max_write_ticks = 0;
+    recorder->error = false;
+    recorder->start_tick = furi_get_tick();
+
+    recorder->thread = furi_thread_alloc_ex(
+        "ScopeRecord", RECORD_WORKER_STACK_SIZE, scope_record_worker, recorder);
+    furi_thread_start(recorder->thread);
+
+    recorder->running = true;
+    return true;
+}
+
+void scope_record_push(ScopeRecorder* recorder, const uint16_t* block) {
+    if(!recorder->running) return;
+
+    uint32_t head = recorder->head;
+    if(head - recorder->tail >= SCOPE_RECORD_BLOCKS) {
+        recorder->dropped_blocks++;
+        // Consecutive drops are one overrun
+        if(recorder->pending_gap++ == 0) recorder->overruns++;
+        return;
+    }
+
+    uint32_t slot = head % SCOPE_RECORD_BLOCKS;
+    memcpy(
+        &recorder->blocks[slot * recorder->block_samples],
+        block,
+        recorder->block_samples * sizeof(uint16_t));
+    recorder->gaps[slot] = recorder->pending_gap;
+    recorder->pending_gap = 0;
+    // Block must be in memory before the writer thread can see it
+    __DMB();
+    recorder->head = head + 1;
+}
+
+void scope_record_stop(ScopeRecorder* recorder, const uint16_t* tail, uint32_t tail_samples) {
+    furi_assert(recorder);
+    if(!recorder->running) return;
+
+    recorder->running = false;
+    furi_thread_flags_set(furi_thread_get_id(recorder->thread), RECORD_WORKER_FLAG_STOP);
+    furi_thread_join(recorder->thread);
+    furi_thread_free(recorder->thread);
+    recorder->thread = NULL;
+
+    // Blocks dropped after the last queued one come right before the tail
+    scope_record_write_gap(recorder, recorder->pending_gap);
+    scope_record_write_samples(recorder, tail, tail_samples);
+    recorder->stop_tick = furi_get_tick();
+
+    recorder->header.samples = recorder->samples;
+    recorder->header.dropped_samples = recorder->dropped_blocks * recorder->block_samples;
+    if(storage_file_seek(recorder->file, 0, true)) {
+        storage_file_write(recorder->file, &recorder->header, sizeof(ScopeRecordHeader));
+    }
+
+    storage_file_close(recorder->file);
+    storage_file_free(recorder->file);
+    recorder->file = NULL;
+}
+
+bool scope_record_is_running(const ScopeRecorder* recorder) {
+    return recorder->running;
+}
+
+void scope_record_get_stats(const ScopeRecorder* recorder, ScopeRecordStats* stats) {
+    uint32_t end_tick = recorder->running ? furi_get_tick() : recorder->stop_tick;
+    uint32_t tick_frequency = furi_kernel_get_tick_frequency();
+
+    stats->samples = recorder->samples;
+    stats->dropped_samples = recorder->dropped_blocks * recorder->block_samples;
+    stats->overruns = recorder->overruns;
+    stats->elapsed_ms = (uint64_t)(end_tick - recorder->start_tick) * 1000 / tick_frequency;
+    stats->bytes_per_second = 0;
+    if(stats->elapsed_ms > 0) {
+        stats->bytes_per_second =
+            (uint64_t)stats->samples * sizeof(uint16_t) * 1000 / stats->elapsed_ms;
+    }
+    stats->max_write_ms = (uint64_t)recorder->max_write_ticks * 1000 / tick_frequency;
+    stats->error = recorder->error;
+}
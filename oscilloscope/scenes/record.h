@@ -0,0 +1,61 @@
+#pragma once
+
+#include <furi.h>
+#include <furi_hal.h>
+#include <storage/storage.h>
+
+#define SCOPE_RECORD_MAGIC     "FSCR"
+#define SCOPE_RECORD_VERSION   (2)
+#define SCOPE_RECORD_EXTENSION ".rec"
+#define SCOPE_RECORD_BLOCKS    (8) // DMA blocks queued between interrupt and writer thread
+#define SCOPE_RECORD_MAX_BLOCK (512) // Largest DMA block, in samples
+#define SCOPE_RECORD_GAP_FLAG  (0x8000) // Set in a sample word that marks a gap
+#define SCOPE_RECORD_GAP_MAX   (0x7FFF) // Most dropped blocks a single gap marker holds
+
+// Recording file header, followed by raw little-endian u16 ADC samples. Samples are 12 bit,
+// so a word with SCOPE_RECORD_GAP_FLAG set is a gap marker instead: its low bits are the
+// number of blocks of block_samples samples that were dropped at that point.
+typedef struct __attribute__((packed)) {
+    char magic[4]; // SCOPE_RECORD_MAGIC
+    uint16_t version; // SCOPE_RECORD_VERSION
+    uint16_t header_size; // Offset of the first sample
+    uint32_t sample_rate; // Nominal samples per second
+    uint16_t resolution; // ADC bits per sample
+    uint16_t vref; // ADC reference voltage, mV
+    uint32_t block_samples; // Samples per DMA block
+    uint32_t samples; // Samples in file, not counting gap markers, filled in once stopped
+    uint32_t dropped_samples; // Samples lost to overruns, missing from the file
+} ScopeRecordHeader;
+
+typedef struct {
+    uint32_t samples; // Samples written to SD card
+    uint32_t dropped_samples; // Samples lost, because writer thread fell behind
+    uint32_t overruns; // Number of times writer thread fell behind
+    uint32_t elapsed_ms; // Recording duration
+    uint32_t bytes_per_second; // Sustained SD card throughput
+    uint32_t max_write_ms; // Slowest single SD card write
+    bool error; // SD card write failed, rest of recording is discarded
+} ScopeRecordStats;
+
+typedef struct ScopeRecorder ScopeRecorder;
+
+ScopeRecorder* scope_record_alloc(uint32_t block_samples);
+void scope_record_free(ScopeRecorder* recorder);
+
+// Create file and start writer thread, blocks are accepted once this returns true
+bool scope_record_start(
+    ScopeRecorder* recorder,
+    Storage* storage,
+    const char* path,
+    uint32_t sample_rate,
+    uint16_t vref);
+
+// Queue one complete DMA block. Called from DMA interrupt, which runs above the RTOS
+// syscall priority, so this only touches the queue and never blocks.
+void scope_record_push(ScopeRecorder* recorder, const uint16_t* block);
+
+// Drain queued blocks, append tail samples collected after the last block and finalise header
+void scope_record_stop(ScopeRecorder* recorder, const uint16_t* tail, uint32_t tail_samples);
+
+bool scope_record_is_running(const ScopeRecorder* recorder);
+void scope_record_get_stats(const ScopeRecorder* recorder, ScopeRecordStats* stats);
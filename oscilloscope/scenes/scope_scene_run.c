@@ -1,4 +1,3 @@
-#include <complex.h>
 #include <math.h>
 
 #include <float.h>
@@ -29,8 +28,13 @@
 
 #include "../scope_app_i.h"
 #include "flipperscope_icons.h"
+#include "fft.h"
+#include "record.h"
 
 #define USE_TIMEOUT                          0
+#define USE_FFT_Q15                          0 // Fixed-point spectrum instead of float
+#define USE_FFT_BENCHMARK                    0 // Log spectrum processing time per block
+#define FFT_Q15_PER_MVOLT                    13 // Keeps +-1250mV within half of Q15 range
 #define DIGITAL_SCALE_12BITS                 ((uint32_t)0xFFF)
 #define VAR_CONVERTED_DATA_INIT_VALUE        (DIGITAL_SCALE_12BITS + 1)
 #define VAR_CONVERTED_DATA_INIT_VALUE_16BITS (0xFFFF + 1U)
@@ -77,8 +81,23 @@ uint32_t adc_buffer; // ADC buffer size
 int16_t* index_crossings; // Indexes of zero crossings
 float* data; // Shift data across virtual zero line
 float* crossings;
-float complex* fft_data; // Real data, transformed to complex data via FFT
-float* fft_power; // Power data from FFT
+#if(USE_FFT_Q15 == 1)
+int16_t* fft_data; // Windowed samples, transformed in place by real FFT
+int16_t* fft_window; // Window coefficients
+#else
+float* fft_data; // Windowed samples, transformed in place by real FFT
+float* fft_window; // Window coefficients
+#endif
+float* fft_power; // Power data from FFT, averaged across blocks
+uint32_t fft_average; // Number of blocks power is averaged over
+uint32_t fft_peak; // FFT bin with highest power
+FuriMutex* fft_mutex; // Guards fft_power and fft_peak, run loop writes them while GUI draws
+__IO uint32_t fft_blocks; // Number of complete ADC blocks, for spectrum refresh
+uint32_t fft_blocks_done; // Number of ADC blocks spectrum was computed for
+ScopeRecorder* recorder; // Streams DMA blocks to SD card in record mode
+Storage* record_storage;
+__IO bool recording = false; // Whether DMA blocks are handed to recorder
+bool record_failed = false; // Whether recording file couldn't be created
 
 void Error_Handler() {
     while(1) {
@@ -278,16 +297,29 @@ void swap(__IO uint16_t** a, __IO uint16_t** b) {
 }
 
 void AdcDmaTransferComplete_Callback() {
+    if(type == m_record) {
+        if(recording) scope_record_push(recorder, &aADCxConvertedData[adc_buffer / 2]);
+        return;
+    }
+
     uint32_t tmp_index = 0;
     for(tmp_index = (adc_buffer / 2); tmp_index < adc_buffer; tmp_index++) {
         mvoltWrite[tmp_index] = __LL_ADC_CALC_DATA_TO_VOLTAGE(
             VDDA_APPLI, aADCxConvertedData[tmp_index], LL_ADC_RESOLUTION_12B);
     }
     ubDmaTransferStatus = 1;
-    if(!pause) swap(&mvoltWrite, &mvoltDisplay);
+    if(!pause) {
+        swap(&mvoltWrite, &mvoltDisplay);
+        fft_blocks++;
+    }
 }
 
 void AdcDmaTransferHalf_Callback() {
+    if(type == m_record) {
+        if(recording) scope_record_push(recorder, &aADCxConvertedData[0]);
+        return;
+    }
+
     uint32_t tmp_index = 0;
     for(tmp_index = 0; tmp_index < (adc_buffer / 2); tmp_index++) {
         mvoltWrite[tmp_index] = __LL_ADC_CALC_DATA_TO_VOLTAGE(
@@ -345,50 +377,109 @@ void Activate_ADC(void) {
     }
 }
 
-// Found from:
-// https://www.algorithm-archive.org/contents/cooley_tukey/cooley_tukey.html
-void bit_reverse(float complex* X, int N) {
-    for(int i = 0; i < N; ++i) {
-        int n = i;
-        int a = i;
-        int count = (int)ceil(log2((float)N)) - 1;
-
-        n >>= 1;
-        while(n > 0) {
-            a = (a << 1) | (n & 1);
-            count--;
-            n >>= 1;
-        }
-        n = (a << count) & (int)((1 << (int)ceil(log2((float)N))) - 1);
+// Compute spectrum of the latest complete ADC block
+static void fft_process_block(void) {
+#if(USE_FFT_BENCHMARK == 1)
+    uint32_t start = DWT->CYCCNT;
+#endif
+    // Remove DC offset, so windowing doesn't smear it into neighbouring bins
+    __IO uint16_t* block = mvoltDisplay;
+    uint32_t mean = 0;
+    for(uint32_t i = 0; i < adc_buffer; i++) {
+        mean += block[i];
+    }
+    mean /= adc_buffer;
 
-        if(n > i) {
-            float complex tmp = X[i];
-            X[i] = X[n];
-            X[n] = tmp;
+#if(USE_FFT_Q15 == 1)
+    for(uint32_t i = 0; i < adc_buffer; i++) {
+        int32_t sample = ((int32_t)block[i] - (int32_t)mean) * FFT_Q15_PER_MVOLT;
+        fft_data[i] = (sample * fft_window[i]) >> 15;
+    }
+    fft_real_q15(fft_data, adc_buffer);
+    furi_mutex_acquire(fft_mutex, FuriWaitForever);
+    fft_power_q15(fft_data, fft_power, adc_buffer, fft_average);
+#else
+    for(uint32_t i = 0; i < adc_buffer; i++) {
+        fft_data[i] = ((float)block[i] - (float)mean) / 1000 * fft_window[i];
+    }
+    fft_real_f32(fft_data, adc_buffer);
+    furi_mutex_acquire(fft_mutex, FuriWaitForever);
+    fft_power_f32(fft_data, fft_power, adc_buffer, fft_average);
+#endif
+
+    // Find FFT bin, with highest power
+    float max_val = -1;
+    fft_peak = 0;
+    for(uint32_t i = 1; i < adc_buffer / 2; i++) {
+        if(fft_power[i] > max_val) {
+            max_val = fft_power[i];
+            fft_peak = i;
         }
     }
+    furi_mutex_release(fft_mutex);
+
+#if(USE_FFT_BENCHMARK == 1)
+    uint32_t cycles = DWT->CYCCNT - start;
+    if((fft_blocks_done & 63) == 0) {
+        FURI_LOG_I(
+            "Scope",
+            "FFT %lu points: %lu us per block",
+            adc_buffer,
+            cycles / (SystemCoreClock / 1000000));
+    }
+#endif
 }
 
-// Found from:
-// https://www.algorithm-archive.org/contents/cooley_tukey/cooley_tukey.html
-//
-// Adapted slightly to use ceil, otherwise didn't seem to calculate
-// FFT correctly on the flipper zero
-void iterative_cooley_tukey(float complex* X, int N) {
-    bit_reverse(X, N);
-
-    for(int i = 1; i <= ceil(log2((float)N)); ++i) {
-        int stride = (int)pow(2, i);
-        float complex w = cexp(-2.0 * I * M_PI / (float)stride);
-        for(int j = 0; j < N; j += stride) {
-            float complex v = 1.0;
-            for(int k = 0; k < stride / 2; ++k) {
-                X[k + j + stride / 2] = X[k + j] - v * X[k + j + stride / 2];
-                X[k + j] -= (X[k + j + stride / 2] - X[k + j]);
-                v *= w;
-            }
-        }
+// Smaller DMA blocks at low sample rates, so samples reach the SD card regularly
+static uint32_t record_block_samples(double rate) {
+    uint32_t samples = (uint32_t)(rate / 10);
+    return CLAMP(samples, (uint32_t)SCOPE_RECORD_MAX_BLOCK, 16UL);
+}
+
+static void record_start(void) {
+    FuriHalRtcDateTime datetime;
+    furi_hal_rtc_get_datetime(&datetime);
+    FuriString* path = furi_string_alloc_printf(
+        "%s/rec_%04d%02d%02d_%02d%02d%02d%s",
+        APP_DATA_PATH(""),
+        datetime.year,
+        datetime.month,
+        datetime.day,
+        datetime.hour,
+        datetime.minute,
+        datetime.second,
+        SCOPE_RECORD_EXTENSION);
+
+    record_failed = !scope_record_start(
+        recorder, record_storage, furi_string_get_cstr(path), (uint32_t)freq, VDDA_APPLI);
+    recording = !record_failed;
+    furi_string_free(path);
+}
+
+static void record_stop(void) {
+    uint32_t half = adc_buffer / 2;
+    uint16_t* tail = malloc(adc_buffer * sizeof(uint16_t));
+    uint32_t tail_samples = 0;
+
+    // Stop hand-off and collect samples DMA wrote since the last pushed block, with
+    // interrupts off so a block completing right now can't fall in between
+    __disable_irq();
+    recording = false;
+    uint32_t position = adc_buffer - LL_DMA_GetDataLength(DMA1, LL_DMA_CHANNEL_1);
+    uint32_t start = position < half ? 0 : half;
+    if(start == 0 && LL_DMA_IsActiveFlag_TC1(DMA1)) {
+        memcpy(tail, &aADCxConvertedData[half], half * sizeof(uint16_t));
+        tail_samples = half;
+    } else if(start == half && LL_DMA_IsActiveFlag_HT1(DMA1)) {
+        memcpy(tail, &aADCxConvertedData[0], half * sizeof(uint16_t));
+        tail_samples = half;
     }
+    memcpy(&tail[tail_samples], &aADCxConvertedData[start], (position - start) * sizeof(uint16_t));
+    tail_samples += position - start;
+    __enable_irq();
+
+    scope_record_stop(recorder, tail, tail_samples);
+    free(tail);
 }
 
 // Found from:
@@ -415,6 +506,10 @@ static void app_draw_callback(Canvas* canvas, void* ctx) {
         }
     }
 
+    if(type == m_record) {
+        elements_button_center(canvas, recording ? "Stop" : "REC");
+    }
+
     if(pause)
         canvas_draw_icon(canvas, 116, 1, &I_pause_10x10);
     else
@@ -428,6 +523,9 @@ static void app_draw_callback(Canvas* canvas, void* ctx) {
     max /= 1000;
     min /= 1000;
 
+    // Spectrum text and bars must come from the same block
+    if(type == m_fft) furi_mutex_acquire(fft_mutex, FuriWaitForever);
+
     switch(type) {
     case m_time: {
         // Display current scale
@@ -472,27 +570,10 @@ static void app_draw_callback(Canvas* canvas, void* ctx) {
         canvas_draw_str(canvas, 2, 20, buf1);
     } break;
     case m_fft: {
-        for(uint32_t i = 0; i < adc_buffer; i++) {
-            fft_data[i] = ((float)mvoltDisplay[i] / 1000);
-        }
-
-        // Apply FFT
-        iterative_cooley_tukey(fft_data, adc_buffer);
-
-        // Find FFT bin, with highest power
-        float max_val = -1;
-        int idx = 0;
-        for(uint32_t i = 1; i < adc_buffer / 2; i++) {
-            float f = cabsf(fft_data[i]) * cabsf(fft_data[i]);
-            if(f > max_val) {
-                max_val = f;
-                idx = i;
-            }
-            fft_power[i] = f;
-        }
-
+        // Spectrum itself is computed as ADC blocks arrive, see fft_process_block
         // Display frequency of waveform
-        snprintf(buf1, 50, "Freq: %.1fHz", (double)idx * ((double)freq / (double)adc_buffer));
+        snprintf(
+            buf1, 50, "Freq: %.1fHz", (double)fft_peak * ((double)freq / (double)adc_buffer));
         canvas_draw_str(canvas, 2, 10, buf1);
     } break;
     case m_voltage: {
@@ -507,11 +588,45 @@ static void app_draw_callback(Canvas* canvas, void* ctx) {
         snprintf(buf1, 50, "Vpp: %.2fV", (double)(max - min));
         canvas_draw_str(canvas, 2, 30, buf1);
     } break;
+    case m_record: {
+        ScopeRecordStats stats;
+        scope_record_get_stats(recorder, &stats);
+        if(record_failed)
+            snprintf(buf1, 50, "Can't create file");
+        else
+            snprintf(
+                buf1,
+                50,
+                "%s %lu.%lus",
+                recording ? "Recording" : "Stopped",
+                stats.elapsed_ms / 1000,
+                stats.elapsed_ms / 100 % 10);
+        canvas_draw_str(canvas, 2, 10, buf1);
+        snprintf(buf1, 50, "Rate: %.0f S/s", freq);
+        canvas_draw_str(canvas, 2, 20, buf1);
+        snprintf(buf1, 50, "Samples: %lu", stats.samples);
+        canvas_draw_str(canvas, 2, 30, buf1);
+        snprintf(
+            buf1,
+            50,
+            "SD: %lu.%luKB/s max %lums",
+            stats.bytes_per_second / 1024,
+            stats.bytes_per_second % 1024 * 10 / 1024,
+            stats.max_write_ms);
+        canvas_draw_str(canvas, 2, 40, buf1);
+        if(stats.error)
+            snprintf(buf1, 50, "SD write error");
+        else
+            snprintf(buf1, 50, "Overruns: %lu (%lu lost)", stats.overruns, stats.dropped_samples);
+        canvas_draw_str(canvas, 2, 50, buf1);
+    } break;
     default:
         break;
     }
 
-    if(type != m_fft) {
+    if(type == m_record) {
+        // Recording only shows statistics, samples go straight to SD card
+    } else if(type != m_fft) {
         // Draw lines between each data point
         // y should range from 0 to 63
         for(uint32_t x = 1; x < adc_buffer; x++) {
@@ -548,6 +663,7 @@ static void app_draw_callback(Canvas* canvas, void* ctx) {
             canvas_draw_line(canvas, xpos, 63, xpos, 63 - (uint32_t)(((sum / max) * 63.0f)));
             xpos++;
         }
+        furi_mutex_release(fft_mutex);
     }
 
     // Removing graph lines, to use extra pixel
@@ -571,7 +687,9 @@ void free_all() {
     free(data);
     free(crossings);
     free(fft_data);
+    free(fft_window);
     free(fft_power);
+    furi_mutex_free(fft_mutex);
 }
 
 void scope_scene_run_on_enter(void* context) {
@@ -594,8 +712,11 @@ void scope_scene_run_on_enter(void* context) {
     // What type of measurement are we performing
     type = app->measurement;
 
+    freq = 1 / app->time;
+
     adc_buffer = ADC_CONVERTED_DATA_BUFFER_SIZE;
     if(type == m_fft) adc_buffer = app->fft;
+    if(type == m_record) adc_buffer = 2 * record_block_samples(freq);
 
     aADCxConvertedData = malloc(adc_buffer * sizeof(uint16_t));
     aADCxConvertedData_Voltage_mVoltA = malloc(adc_buffer * sizeof(uint16_t));
@@ -604,8 +725,28 @@ void scope_scene_run_on_enter(void* context) {
     index_crossings = malloc(adc_buffer * sizeof(int16_t));
     data = malloc(adc_buffer * sizeof(float));
     crossings = malloc(adc_buffer * sizeof(float));
-    fft_data = malloc(adc_buffer * sizeof(float complex));
+    fft_data = malloc(adc_buffer * sizeof(*fft_data));
+    fft_window = malloc(adc_buffer * sizeof(*fft_window));
     fft_power = malloc(adc_buffer * sizeof(float));
+    fft_mutex = furi_mutex_alloc(FuriMutexTypeNormal);
+
+#if(USE_FFT_Q15 == 1)
+    fft_window_q15(fft_window, adc_buffer, app->fft_window);
+#else
+    fft_window_f32(fft_window, adc_buffer, app->fft_window);
+#endif
+    memset(fft_power, 0, adc_buffer * sizeof(float));
+    fft_average = app->fft_average;
+    fft_peak = 0;
+    fft_blocks = 0;
+    fft_blocks_done = 0;
+
+    recording = false;
+    record_failed = false;
+    if(type == m_record) {
+        recorder = scope_record_alloc(adc_buffer / 2);
+        record_storage = furi_record_open(RECORD_STORAGE);
+    }
 
     mvoltWrite =
         &aADCxConvertedData_Voltage_mVoltA[0]; // Pointer to area we write converted voltage data to
@@ -628,7 +769,6 @@ void scope_scene_run_on_enter(void* context) {
     MX_GPIO_Init();
     MX_DMA_Init();
 
-    freq = 1 / app->time;
     MX_TIM2_Init((int)freq);
 
     // Set VREFBUF to 2.5V, as vref isn't connected to 3.3V itself in the flipper zero
@@ -663,11 +803,26 @@ void scope_scene_run_on_enter(void* context) {
     Gui* gui = furi_record_open(RECORD_GUI);
     gui_add_view_port(gui, view_port, GuiLayerFullscreen);
 
+    // Spectrum mode polls for new ADC blocks at least as often as they complete
+    uint32_t timeout = 150;
+    if(type == m_fft) {
+        timeout = CLAMP((uint32_t)(adc_buffer * 1000 / freq), timeout, 1UL);
+    }
+
     InputEvent event;
     bool running = true;
     bool save = false;
     while(running) {
-        if(furi_message_queue_get(event_queue, &event, 150) == FuriStatusOk) {
+        bool redraw = type != m_fft;
+        if(type == m_fft && fft_blocks != fft_blocks_done) {
+            // Skip straight to the latest block, if we've fallen behind
+            fft_blocks_done = fft_blocks;
+            fft_process_block();
+            redraw = true;
+        }
+
+        if(furi_message_queue_get(event_queue, &event, timeout) == FuriStatusOk) {
+            redraw = true;
             if((event.type == InputTypePress) || (event.type == InputTypeRepeat)) {
                 switch(event.key) {
                 case InputKeyLeft:
@@ -684,7 +839,16 @@ void scope_scene_run_on_enter(void* context) {
                 case InputKeyDown:
                     break;
                 case InputKeyOk:
-                    pause ^= 1;
+                    if(type == m_record) {
+                        // Holding OK must not restart recording, file names only have seconds
+                        if(event.type != InputTypePress) break;
+                        if(recording)
+                            record_stop();
+                        else
+                            record_start();
+                    } else {
+                        pause ^= 1;
+                    }
                     break;
                 default:
                     running = false;
@@ -692,7 +856,14 @@ void scope_scene_run_on_enter(void* context) {
                 }
             }
         }
-        view_port_update(view_port);
+        if(redraw) view_port_update(view_port);
+    }
+
+    if(type == m_record) {
+        if(recording) record_stop();
+        scope_record_free(recorder);
+        recorder = NULL;
+        furi_record_close(RECORD_STORAGE);
     }
 
     furi_hal_bus_disable(FuriHalBusTIM2);
@@ -31,6 +31,22 @@ static void fft_cb(VariableItem* item) {
     app->fft = fft_list[index].window;
 }
 
+static void fft_window_cb(VariableItem* item) {
+    ScopeApp* app = variable_item_get_context(item);
+    furi_assert(app);
+    uint8_t index = variable_item_get_current_value_index(item);
+    variable_item_set_current_value_text(item, fft_window_list[index].str);
+    app->fft_window = fft_window_list[index].window;
+}
+
+static void fft_average_cb(VariableItem* item) {
+    ScopeApp* app = variable_item_get_context(item);
+    furi_assert(app);
+    uint8_t index = variable_item_get_current_value_index(item);
+    variable_item_set_current_value_text(item, fft_average_list[index].str);
+    app->fft_average = fft_average_list[index].count;
+}
+
 static void measurement_cb(VariableItem* item) {
     ScopeApp* app = variable_item_get_context(item);
     furi_assert(app);
@@ -64,6 +80,28 @@ void scope_scene_setup_on_enter(void* context) {
         }
     }
 
+    item = variable_item_list_add(
+        var_item_list, "FFT function", COUNT_OF(fft_window_list), fft_window_cb, app);
+
+    for(uint32_t i = 0; i < COUNT_OF(fft_window_list); i++) {
+        if(fft_window_list[i].window == app->fft_window) {
+            variable_item_set_current_value_index(item, i);
+            variable_item_set_current_value_text(item, fft_window_list[i].str);
+            break;
+        }
+    }
+
+    item = variable_item_list_add(
+        var_item_list, "FFT average", COUNT_OF(fft_average_list), fft_average_cb, app);
+
+    for(uint32_t i = 0; i < COUNT_OF(fft_average_list); i++) {
+        if(fft_average_list[i].count == app->fft_average) {
+            variable_item_set_current_value_index(item, i);
+            variable_item_set_current_value_text(item, fft_average_list[i].str);
+            break;
+        }
+    }
+
     item = variable_item_list_add(var_item_list, "Scale", COUNT_OF(scale_list), scale_cb, app);
 
     for(uint32_t i = 0; i < COUNT_OF(scale_list); i++) {
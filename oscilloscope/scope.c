@@ -81,6 +81,8 @@ ScopeApp* scope_app_alloc() {
     app->time = 0.001;
     app->scale = 1.0f;
     app->fft = 256;
+    app->fft_window = FftWindowRect;
+    app->fft_average = 1;
     app->measurement = m_time;
 
     scene_manager_next_scene(app->scene_manager, ScopeSceneStart);
@@ -2,6 +2,7 @@
 
 #include "scenes/scope_types.h"
 #include "scenes/scope_scene.h"
+#include "scenes/fft.h"
 
 #include <gui/gui.h>
 #include <gui/view_dispatcher.h>
@@ -33,6 +34,21 @@ typedef struct {
 
 static const fftwindow fft_list[] = {{256, "256"}, {512, "512"}, {1024, "1024"}};
 
+typedef struct {
+    FftWindow window;
+    char* str;
+} fftwindowfunc;
+
+static const fftwindowfunc fft_window_list[] =
+    {{FftWindowRect, "Rect"}, {FftWindowHann, "Hann"}, {FftWindowBlackman, "Blackman"}};
+
+typedef struct {
+    uint32_t count;
+    char* str;
+} fftaverage;
+
+static const fftaverage fft_average_list[] = {{1, "Off"}, {2, "2"}, {4, "4"}, {8, "8"}};
+
 typedef struct {
     float scale;
     char* str;
@@ -45,7 +61,8 @@ enum measureenum {
     m_time,
     m_voltage,
     m_capture,
-    m_fft
+    m_fft,
+    m_record
 };
 
 typedef struct {
@@ -53,8 +70,12 @@ typedef struct {
     char* str;
 } measurement;
 
-static const measurement measurement_list[] =
-    {{m_time, "Time"}, {m_voltage, "Voltage"}, {m_capture, "Capture"}, {m_fft, "FFT"}};
+static const measurement measurement_list[] = {
+    {m_time, "Time"},
+    {m_voltage, "Voltage"},
+    {m_capture, "Capture"},
+    {m_fft, "FFT"},
+    {m_record, "Record"}};
 
 struct ScopeApp {
     Gui* gui;
@@ -67,6 +88,8 @@ struct ScopeApp {
     TextInput* text_input;
     double time;
     int fft;
+    FftWindow fft_window;
+    uint32_t fft_average;
     float scale;
     enum measureenum measurement;
     char file_name_tmp[MAX_LEN_NAME];
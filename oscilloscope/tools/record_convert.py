@@ -0,0 +1,164 @@
+#!/usr/bin/env python3
+
+import argparse
+import array
+import struct
+import sys
+import wave
+
+HEADER = struct.Struct("<4sHHIHHIII")
+MAGIC = b"FSCR"
+VERSIONS = (1, 2)
+GAP_FLAG = 0x8000
+
+
+def getArgs():
+    parser = argparse.ArgumentParser(
+        description="flipperscope recording (.rec) to CSV/WAV converter",
+    )
+    parser.add_argument("file", help="recording from apps_data/flipperscope")
+    parser.add_argument("output", help="output file, .csv or .wav")
+    parser.add_argument(
+        "--format",
+        choices=["csv", "wav"],
+        help="output format, guessed from output file extension by default",
+    )
+    return parser.parse_args()
+
+
+def readRecording(file):
+    data = open(file, "rb").read()
+    if len(data) < HEADER.size:
+        sys.exit("%s: file too short" % file)
+
+    fields = HEADER.unpack_from(data)
+    header = dict(
+        zip(
+            [
+                "magic",
+                "version",
+                "header_size",
+                "sample_rate",
+                "resolution",
+                "vref",
+                "block_samples",
+                "samples",
+                "dropped_samples",
+            ],
+            fields,
+        )
+    )
+    if header["magic"] != MAGIC:
+        sys.exit("%s: not a flipperscope recording" % file)
+    if header["version"] not in VERSIONS:
+        sys.exit("%s: unsupported version %d" % (file, header["version"]))
+
+    words = array.array("H")
+    body = data[header["header_size"] :]
+    words.frombytes(body[: len(body) // 2 * 2])
+    if sys.byteorder != "little":
+        words.byteswap()
+
+    # Split out gap markers, as (sample index, dropped samples) pairs
+    samples = array.array("H")
+    gaps = []
+    for word in words:
+        if word & GAP_FLAG:
+            dropped = (word & ~GAP_FLAG) * header["block_samples"]
+            if gaps and gaps[-1][0] == len(samples):
+                gaps[-1] = (len(samples), gaps[-1][1] + dropped)
+            else:
+                gaps.append((len(samples), dropped))
+        else:
+            samples.append(word)
+
+    # Sample count is only filled in once recording stops cleanly
+    if header["samples"] and header["samples"] < len(samples):
+        del samples[header["samples"] :]
+    elif header["samples"] != len(samples):
+        print(
+            "warning: header lists %d samples, file holds %d, recording may not have been "
+            "stopped cleanly" % (header["samples"], len(samples)),
+            file=sys.stderr,
+        )
+
+    if header["dropped_samples"]:
+        print(
+            "warning: %d samples were dropped during recording, in %d gaps"
+            % (header["dropped_samples"], len(gaps)),
+            file=sys.stderr,
+        )
+        # Version 1 recordings don't say where the gaps are
+        if not gaps:
+            print("warning: gap positions unknown, time axis is wrong after them", file=sys.stderr)
+
+    return header, samples, gaps
+
+
+def writeCsv(output, header, samples, gaps):
+    # Time keeps counting through gaps, the gap column has the samples missing before a row
+    full_scale = (1 << header["resolution"]) - 1
+    gaps = dict(gaps)
+    skipped = 0
+    with open(output, "w") as f:
+        f.write("time_s,voltage_v,gap\n")
+        for i, sample in enumerate(samples):
+            gap = gaps.get(i, 0)
+            skipped += gap
+            f.write(
+                "%.9f,%.4f,%d\n"
+                % (
+                    (i + skipped) / header["sample_rate"],
+                    sample * header["vref"] / full_scale / 1000,
+                    gap,
+                )
+            )
+
+
+def writeWav(output, header, samples, gaps):
+    # Center ADC range on zero and stretch it to full 16 bit scale, gaps are filled with
+    # silence so the audio stays in time
+    shift = 16 - header["resolution"]
+    offset = 1 << (header["resolution"] - 1)
+    pcm = array.array("h")
+    start = 0
+    for position, dropped in gaps + [(len(samples), 0)]:
+        pcm.extend((sample - offset) << shift for sample in samples[start:position])
+        pcm.extend([0] * dropped)
+        start = position
+    if sys.byteorder != "little":
+        pcm.byteswap()
+
+    with wave.open(output, "wb") as f:
+        f.setnchannels(1)
+        f.setsampwidth(2)
+        f.setframerate(header["sample_rate"])
+        f.writeframes(pcm.tobytes())
+
+
+def main():
+    args = getArgs()
+    header, samples, gaps = readRecording(args.file)
+
+    format = args.format
+    if format is None:
+        format = "wav" if args.output.lower().endswith(".wav") else "csv"
+
+    if format == "wav":
+        writeWav(args.output, header, samples, gaps)
+    else:
+        writeCsv(args.output, header, samples, gaps)
+
+    print(
+        "%d samples at %d S/s (%.3fs) written to %s"
+        % (
+            len(samples),
+            header["sample_rate"],
+            len(samples) / header["sample_rate"],
+            args.output,
+        )
+    )
+
+
+if __name__ == "__main__":
+    main()
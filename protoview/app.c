@@ -157,6 +157,10 @@ ProtoViewApp* protoview_app_alloc() {
     app->us_scale = PROTOVIEW_RAW_VIEW_DEFAULT_SCALE;
     app->signal_offset = 0;
     app->msg_info = NULL;
+    app->decode_bitmap = malloc(DECODE_BITMAP_SIZE);
+    decoders_init();
+    app->decoder_stats = malloc(sizeof(ProtoViewDecoderStats) * count_decoders());
+    memset(app->decoder_stats, 0, sizeof(ProtoViewDecoderStats) * count_decoders());
 
     // Init Worker & Protocol
     app->txrx = malloc(sizeof(ProtoViewTxRx));
@@ -213,6 +217,8 @@ void protoview_app_free(ProtoViewApp* app) {
     // Raw samples buffers.
     raw_samples_free(RawSamples);
     raw_samples_free(DetectedSamples);
+    free(app->decode_bitmap);
+    free(app->decoder_stats);
     furi_hal_power_suppress_charge_exit();
 
     free(app);
@@ -260,6 +266,8 @@ int32_t protoview_app_entry(void* p) {
     UNUSED(p);
     ProtoViewApp* app = protoview_app_alloc();
 
+    if(PROTOVIEW_REPLAY_ON_START) replay_signal_file(app, PROTOVIEW_REPLAY_FILE);
+
     /* Create a timer. We do data analysis in the callback. */
     FuriTimer* timer = furi_timer_alloc(timer_callback, FuriTimerTypePeriodic, app);
     furi_timer_start(timer, furi_kernel_get_tick_frequency() / 8);
@@ -26,15 +26,24 @@
 #define PROTOVIEW_RAW_VIEW_DEFAULT_SCALE 100 // 100us is 1 pixel by default
 #define BITMAP_SEEK_NOT_FOUND            UINT32_MAX // Returned by function as sentinel
 #define PROTOVIEW_VIEW_PRIVDATA_LEN      64 // View specific private data len
+#define BITMAP_PATTERN_MAX_BITS          64 // Max len of a compiled BitmapPattern
+#define DECODE_BITMAP_SIZE               4096 // Bytes of the decode_signal() bitmap
 
 #define DEBUG_MSG 0
 
+/* When enabled, the SubGhz RAW file at PROTOVIEW_REPLAY_FILE is replayed
+ * through the decoding pipeline at startup, and the throughput is logged.
+ * See replay_signal_file(). */
+#define PROTOVIEW_REPLAY_ON_START 0
+#define PROTOVIEW_REPLAY_FILE     EXT_PATH("apps_data/protoview/replay.sub")
+
 /* Forward declarations. */
 
 typedef struct ProtoViewApp ProtoViewApp;
 typedef struct ProtoViewMsgInfo ProtoViewMsgInfo;
 typedef struct ProtoViewFieldSet ProtoViewFieldSet;
 typedef struct ProtoViewDecoder ProtoViewDecoder;
+typedef struct ProtoViewDecoderStats ProtoViewDecoderStats;
 
 /* ============================== enumerations ============================== */
 
@@ -143,6 +152,10 @@ struct ProtoViewApp {
                                       performed the scan. */
     bool signal_decoded; /* Was the current signal decoded? */
     ProtoViewMsgInfo* msg_info; /* Decoded message info if not NULL. */
+    uint8_t* decode_bitmap; /* DECODE_BITMAP_SIZE bytes, reused by
+                               decode_signal() for every signal. */
+    ProtoViewDecoderStats* decoder_stats; /* Runtime stats, one entry
+                                             for each Decoders[] entry. */
     bool direct_sampling_enabled; /* This special view needs an explicit
                                      acknowledge to work. */
     void* view_privdata; /* This is a piece of memory of total size
@@ -221,6 +234,15 @@ typedef struct ProtoViewFieldSet {
     uint32_t numfields;
 } ProtoViewFieldSet;
 
+/* A bit pattern like "0110" packed into an integer by bitmap_pattern_compile(),
+ * so that it can be compared against a window of the bitmap in one step
+ * instead of one bit at a time. The first bit of the pattern is the most
+ * significant of the 'len' bits. */
+typedef struct {
+    uint64_t bits;
+    uint8_t len;
+} BitmapPattern;
+
 typedef struct ProtoViewDecoder {
     const char* name; /* Protocol name. */
     /* The decode function takes a buffer that is actually a bitmap, with
@@ -239,9 +261,31 @@ typedef struct ProtoViewDecoder {
     /* This method takes the fields supported by the decoder, and
      * renders a message in 'samples'. */
     void (*build_message)(RawSamplesBuffer* samples, ProtoViewFieldSet* fields);
+    /* Range of short pulse durations, in microseconds, the protocol is
+     * known to use. decode_signal() skips the decoder when the detected
+     * short pulse is out of range. Zero means no limit: only the generic
+     * unknown decoder, that must see every signal, should use it. */
+    uint32_t min_short_pulse;
+    uint32_t max_short_pulse;
+    /* Optional. Called once at startup by decoders_init(), so that the
+     * decoder can compile the bit patterns it matches into its own static
+     * BitmapPattern variables, instead of compiling them at every decode()
+     * call. */
+    void (*init)(void);
 } ProtoViewDecoder;
 
+/* Runtime stats of a decoder, updated by decode_signal() and shown in the
+ * info view. Kept in the app, not in the decoder, so decoders stay
+ * read-only descriptions of the protocol. */
+struct ProtoViewDecoderStats {
+    uint32_t calls; /* Times the decoder was called. */
+    uint32_t hits; /* Times the decoder decoded the signal. */
+    uint32_t skipped; /* Times the prefilter skipped it. */
+    uint32_t us; /* Cumulative decoding time, in microseconds. */
+};
+
 extern RawSamplesBuffer *RawSamples, *DetectedSamples;
+extern ProtoViewDecoder* Decoders[];
 
 /* app_subghz.c */
 void radio_begin(ProtoViewApp* app);
@@ -257,7 +301,7 @@ void protoview_rx_callback(bool level, uint32_t duration, void* context);
 /* signal.c */
 uint32_t duration_delta(uint32_t a, uint32_t b);
 void reset_current_signal(ProtoViewApp* app);
-void scan_for_signal(ProtoViewApp* app, RawSamplesBuffer* source, uint32_t min_duration);
+uint32_t scan_for_signal(ProtoViewApp* app, RawSamplesBuffer* source, uint32_t min_duration);
 bool bitmap_get(uint8_t* b, uint32_t blen, uint32_t bitpos);
 void bitmap_set(uint8_t* b, uint32_t blen, uint32_t bitpos, bool val);
 void bitmap_copy(
@@ -271,6 +315,14 @@ void bitmap_copy(
 void bitmap_set_pattern(uint8_t* b, uint32_t blen, uint32_t off, const char* pat);
 void bitmap_reverse_bytes_bits(uint8_t* p, uint32_t len);
 bool bitmap_match_bits(uint8_t* b, uint32_t blen, uint32_t bitpos, const char* bits);
+bool bitmap_pattern_compile(BitmapPattern* p, const char* bits);
+bool bitmap_match_pattern(uint8_t* b, uint32_t blen, uint32_t bitpos, const BitmapPattern* p);
+uint32_t bitmap_seek_pattern(
+    uint8_t* b,
+    uint32_t blen,
+    uint32_t startpos,
+    uint32_t maxbits,
+    const BitmapPattern* p);
 uint32_t bitmap_seek_bits(
     uint8_t* b,
     uint32_t blen,
@@ -294,6 +346,14 @@ uint32_t convert_from_line_code(
     uint32_t offset,
     const char* zero_pattern,
     const char* one_pattern);
+uint32_t convert_from_line_code_pattern(
+    uint8_t* buf,
+    uint64_t buflen,
+    uint8_t* bits,
+    uint32_t len,
+    uint32_t off,
+    const BitmapPattern* zero,
+    const BitmapPattern* one);
 uint32_t convert_from_diff_manchester(
     uint8_t* buf,
     uint64_t buflen,
@@ -303,9 +363,12 @@ uint32_t convert_from_diff_manchester(
     bool previous);
 void init_msg_info(ProtoViewMsgInfo* i, ProtoViewApp* app);
 void free_msg_info(ProtoViewMsgInfo* i);
+uint32_t count_decoders(void);
+void decoders_init(void);
 
 /* signal_file.c */
 bool save_signal(ProtoViewApp* app, const char* filename);
+bool replay_signal_file(ProtoViewApp* app, const char* filename);
 
 /* view_*.c */
 void render_view_raw_pulses(Canvas* const canvas, ProtoViewApp* app);
@@ -12,23 +12,33 @@
 
 #include "../app.h"
 
+/* Different pulse + gap + first byte possibilities decode() tests. */
+static const char* sync_strings[6] = {
+    "100000000000000000000000000000011101", /* 30 times gap + one. */
+    "100000000000000000000000000000010001", /* 30 times gap + zero. */
+    "1000000000000000000000000000000011101", /* 31 times gap + one. */
+    "1000000000000000000000000000000010001", /* 31 times gap + zero. */
+    "10000000000000000000000000000000011101", /* 32 times gap + one. */
+    "10000000000000000000000000000000010001", /* 32 times gap + zero. */
+};
+
+/* Patterns matched by decode(), compiled once by init(). */
+static BitmapPattern sync_patterns[6], zero, one;
+
+static void init(void) {
+    for(int j = 0; j < 6; j++)
+        bitmap_pattern_compile(&sync_patterns[j], sync_strings[j]);
+    bitmap_pattern_compile(&zero, "1000");
+    bitmap_pattern_compile(&one, "1110");
+}
+
 static bool decode(uint8_t* bits, uint32_t numbytes, uint32_t numbits, ProtoViewMsgInfo* info) {
     if(numbits < 30) return false;
 
-    /* Test different pulse + gap + first byte possibilities. */
-    const char* sync_patterns[6] = {
-        "100000000000000000000000000000011101", /* 30 times gap + one. */
-        "100000000000000000000000000000010001", /* 30 times gap + zero. */
-        "1000000000000000000000000000000011101", /* 31 times gap + one. */
-        "1000000000000000000000000000000010001", /* 31 times gap + zero. */
-        "10000000000000000000000000000000011101", /* 32 times gap + one. */
-        "10000000000000000000000000000000010001", /* 32 times gap + zero. */
-    };
-
     uint32_t off;
     int j;
     for(j = 0; j < 3; j++) {
-        off = bitmap_seek_bits(bits, numbytes, 0, numbits, sync_patterns[j]);
+        off = bitmap_seek_pattern(bits, numbytes, 0, numbits, &sync_patterns[j]);
         if(off != BITMAP_SEEK_NOT_FOUND) break;
     }
     if(off == BITMAP_SEEK_NOT_FOUND) return false;
@@ -36,10 +46,11 @@ static bool decode(uint8_t* bits, uint32_t numbytes, uint32_t numbits, ProtoView
     info->start_off = off;
 
     // Seek data setction. Why -5? Last 5 half-bit-times are data.
-    off += strlen(sync_patterns[j]) - 5;
+    off += sync_patterns[j].len - 5;
 
     uint8_t d[3]; /* 24 bits of data. */
-    uint32_t decoded = convert_from_line_code(d, sizeof(d), bits, numbytes, off, "1000", "1110");
+    uint32_t decoded =
+        convert_from_line_code_pattern(d, sizeof(d), bits, numbytes, off, &zero, &one);
 
     if(DEBUG_MSG) FURI_LOG_E(TAG, "B4B1 decoded: %lu", decoded);
     if(decoded < 24) return false;
@@ -86,8 +97,13 @@ static void build_message(RawSamplesBuffer* samples, ProtoViewFieldSet* fs) {
     raw_samples_add(samples, true, te);
 }
 
+/* The short pulse depends on the chip oscillator resistor: remotes in the
+ * wild go from ~100us to ~900us, most are around 300-500us. */
 ProtoViewDecoder B4B1Decoder = {
     .name = "PT/SC remote",
     .decode = decode,
     .get_fields = get_fields,
-    .build_message = build_message};
+    .build_message = build_message,
+    .min_short_pulse = 80,
+    .max_short_pulse = 1000,
+    .init = init};
@@ -27,15 +27,25 @@
 
 #include "../app.h"
 
+/* Patterns matched by decode(), compiled once by init(). */
+static BitmapPattern sync_pattern, zero, one;
+
+static void init(void) {
+    bitmap_pattern_compile(
+        &sync_pattern,
+        "101010101010101010101010"
+        "0000");
+    bitmap_pattern_compile(&zero, "110"); /* Pulse width modulation. */
+    bitmap_pattern_compile(&one, "100");
+}
+
 static bool decode(uint8_t* bits, uint32_t numbytes, uint32_t numbits, ProtoViewMsgInfo* info) {
     /* In the sync pattern, we require the 12 high/low pulses and at least
      * half the gap we expect (5 pulses times, one is the final zero in the
      * 24 symbols high/low sequence, then other 4). */
-    const char* sync_pattern = "101010101010101010101010"
-                               "0000";
     uint8_t sync_len = 24 + 4;
     if(numbits - sync_len + sync_len < 3 * 66) return false;
-    uint32_t off = bitmap_seek_bits(bits, numbytes, 0, numbits, sync_pattern);
+    uint32_t off = bitmap_seek_pattern(bits, numbytes, 0, numbits, &sync_pattern);
     if(off == BITMAP_SEEK_NOT_FOUND) return false;
 
     info->start_off = off;
@@ -53,8 +63,8 @@ static bool decode(uint8_t* bits, uint32_t numbytes, uint32_t numbits, ProtoView
     FURI_LOG_E(TAG, "Keeloq preamble+sync found");
 
     uint8_t raw[9] = {0};
-    uint32_t decoded = convert_from_line_code(
-        raw, sizeof(raw), bits, numbytes, off, "110", "100"); /* Pulse width modulation. */
+    uint32_t decoded = convert_from_line_code_pattern(
+        raw, sizeof(raw), bits, numbytes, off, &zero, &one); /* Pulse width modulation. */
     FURI_LOG_E(TAG, "Keeloq decoded bits: %lu", decoded);
     if(decoded < 66) return false; /* Require the full 66 bits. */
 
@@ -118,5 +128,11 @@ static void build_message(RawSamplesBuffer* samples, ProtoViewFieldSet* fieldset
     }
 }
 
-ProtoViewDecoder KeeloqDecoder =
-    {.name = "Keeloq", .decode = decode, .get_fields = get_fields, .build_message = build_message};
+ProtoViewDecoder KeeloqDecoder = {
+    .name = "Keeloq",
+    .decode = decode,
+    .get_fields = get_fields,
+    .build_message = build_message,
+    .min_short_pulse = 100,
+    .max_short_pulse = 800,
+    .init = init};
@@ -9,13 +9,23 @@
 
 #include "../app.h"
 
+/* Patterns matched by decode(), compiled once by init(). */
+static BitmapPattern sync_pattern, zero, one;
+
+static void init(void) {
+    bitmap_pattern_compile(
+        &sync_pattern,
+        "01100110"
+        "01100110"
+        "10010110"
+        "10010110");
+    bitmap_pattern_compile(&zero, "1001");
+    bitmap_pattern_compile(&one, "0110");
+}
+
 static bool decode(uint8_t* bits, uint32_t numbytes, uint32_t numbits, ProtoViewMsgInfo* info) {
     if(numbits < 32) return false;
-    const char* sync_pattern = "01100110"
-                               "01100110"
-                               "10010110"
-                               "10010110";
-    uint64_t off = bitmap_seek_bits(bits, numbytes, 0, numbits, sync_pattern);
+    uint64_t off = bitmap_seek_pattern(bits, numbytes, 0, numbits, &sync_pattern);
     if(off == BITMAP_SEEK_NOT_FOUND) return false;
     FURI_LOG_E(TAG, "Oregon2 preamble+sync found");
 
@@ -24,7 +34,7 @@ static bool decode(uint8_t* bits, uint32_t numbytes, uint32_t numbits, ProtoView
 
     uint8_t buffer[8], raw[8] = {0};
     uint32_t decoded =
-        convert_from_line_code(buffer, sizeof(buffer), bits, numbytes, off, "1001", "0110");
+        convert_from_line_code_pattern(buffer, sizeof(buffer), bits, numbytes, off, &zero, &one);
     FURI_LOG_E(TAG, "Oregon2 decoded bits: %lu", decoded);
 
     if(decoded < 11 * 4) return false; /* Minimum len to extract some data. */
@@ -80,5 +90,13 @@ static bool decode(uint8_t* bits, uint32_t numbytes, uint32_t numbits, ProtoView
     return true;
 }
 
-ProtoViewDecoder Oregon2Decoder =
-    {.name = "Oregon2", .decode = decode, .get_fields = NULL, .build_message = NULL};
+/* v2.1 sends 1024 bits per second Manchester coded, so the short pulse
+ * is ~488us, that OOK receivers stretch or shrink by a good amount. */
+ProtoViewDecoder Oregon2Decoder = {
+    .name = "Oregon2",
+    .decode = decode,
+    .get_fields = NULL,
+    .build_message = NULL,
+    .min_short_pulse = 300,
+    .max_short_pulse = 700,
+    .init = init};
@@ -75,9 +75,19 @@
  *    second. More than enough for the simple chat we have here.
  */
 
+/* Patterns matched by decode(), compiled once by init(). */
+static BitmapPattern sync_pattern, zero, one;
+
+static void init(void) {
+    bitmap_pattern_compile(
+        &sync_pattern,
+        "1010101010101010" // Preamble
+        "1100110011001010"); // Sync
+    bitmap_pattern_compile(&zero, "100"); /* PWM */
+    bitmap_pattern_compile(&one, "110");
+}
+
 static bool decode(uint8_t* bits, uint32_t numbytes, uint32_t numbits, ProtoViewMsgInfo* info) {
-    const char* sync_pattern = "1010101010101010" // Preamble
-                               "1100110011001010"; // Sync
     uint8_t sync_len = 32;
 
     /* This is a variable length message, however the minimum length
@@ -85,7 +95,7 @@ static bool decode(uint8_t* bits, uint32_t numbytes, uint32_t numbits, ProtoView
      * FF 00 plus checksum: a total of 4 bytes. */
     if(numbits - sync_len < 8 * 4) return false;
 
-    uint64_t off = bitmap_seek_bits(bits, numbytes, 0, numbits, sync_pattern);
+    uint64_t off = bitmap_seek_pattern(bits, numbytes, 0, numbits, &sync_pattern);
     if(off == BITMAP_SEEK_NOT_FOUND) return false;
     FURI_LOG_E(TAG, "Chat preamble+sync found");
 
@@ -101,8 +111,8 @@ static bool decode(uint8_t* bits, uint32_t numbytes, uint32_t numbits, ProtoView
     off += sync_len; /* Skip preamble and sync. */
 
     uint8_t raw[64] = {(uint8_t)'.'};
-    uint32_t decoded =
-        convert_from_line_code(raw, sizeof(raw), bits, numbytes, off, "100", "110"); /* PWM */
+    uint32_t decoded = convert_from_line_code_pattern(
+        raw, sizeof(raw), bits, numbytes, off, &zero, &one); /* PWM */
     FURI_LOG_E(TAG, "Chat decoded bits: %lu", decoded);
 
     if(decoded < 8 * 4) return false; /* Min message len. */
@@ -198,8 +208,13 @@ static void build_message(RawSamplesBuffer* samples, ProtoViewFieldSet* fs) {
     free(data);
 }
 
+/* 300us short pulse as sent by build_message(), 100/200us also works
+ * as described at the top of this file. */
 ProtoViewDecoder ProtoViewChatDecoder = {
     .name = "ProtoView chat",
     .decode = decode,
     .get_fields = get_fields,
-    .build_message = build_message};
+    .build_message = build_message,
+    .min_short_pulse = 80,
+    .max_short_pulse = 700,
+    .init = init};
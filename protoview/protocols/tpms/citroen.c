@@ -10,15 +10,23 @@
 
 #include "../../app.h"
 
+/* Patterns matched by decode(), compiled once by init(). */
+static BitmapPattern sync_pattern, zero, one;
+
+static void init(void) {
+    bitmap_pattern_compile(&sync_pattern, "10101010101010110");
+    bitmap_pattern_compile(&zero, "01"); /* Manchester. */
+    bitmap_pattern_compile(&one, "10");
+}
+
 static bool decode(uint8_t* bits, uint32_t numbytes, uint32_t numbits, ProtoViewMsgInfo* info) {
     /* We consider a preamble of 17 symbols. They are more, but the decoding
      * is more likely to happen if we don't pretend to receive from the
      * very start of the message. */
     uint32_t sync_len = 17;
-    const char* sync_pattern = "10101010101010110";
     if(numbits - sync_len < 8 * 10) return false; /* Expect 10 bytes. */
 
-    uint64_t off = bitmap_seek_bits(bits, numbytes, 0, numbits, sync_pattern);
+    uint64_t off = bitmap_seek_pattern(bits, numbytes, 0, numbits, &sync_pattern);
     if(off == BITMAP_SEEK_NOT_FOUND) return false;
     FURI_LOG_E(TAG, "Renault TPMS preamble+sync found");
 
@@ -26,8 +34,8 @@ static bool decode(uint8_t* bits, uint32_t numbytes, uint32_t numbits, ProtoView
     off += sync_len; /* Skip preamble + sync. */
 
     uint8_t raw[10];
-    uint32_t decoded = convert_from_line_code(
-        raw, sizeof(raw), bits, numbytes, off, "01", "10"); /* Manchester. */
+    uint32_t decoded = convert_from_line_code_pattern(
+        raw, sizeof(raw), bits, numbytes, off, &zero, &one); /* Manchester. */
     FURI_LOG_E(TAG, "Citroen TPMS decoded bits: %lu", decoded);
 
     if(decoded < 8 * 10) return false; /* Require the full 10 bytes. */
@@ -55,5 +63,11 @@ static bool decode(uint8_t* bits, uint32_t numbytes, uint32_t numbits, ProtoView
     return true;
 }
 
-ProtoViewDecoder CitroenTPMSDecoder =
-    {.name = "Citroen TPMS", .decode = decode, .get_fields = NULL, .build_message = NULL};
+ProtoViewDecoder CitroenTPMSDecoder = {
+    .name = "Citroen TPMS",
+    .decode = decode,
+    .get_fields = NULL,
+    .build_message = NULL,
+    .min_short_pulse = 20,
+    .max_short_pulse = 250,
+    .init = init};
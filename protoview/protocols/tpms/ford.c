@@ -13,13 +13,23 @@
 
 #include "../../app.h"
 
+/* Patterns matched by decode(), compiled once by init(). */
+static BitmapPattern sync_pattern, zero, one;
+
+static void init(void) {
+    bitmap_pattern_compile(
+        &sync_pattern,
+        "010101010101"
+        "0110");
+    bitmap_pattern_compile(&zero, "01"); /* Manchester. */
+    bitmap_pattern_compile(&one, "10");
+}
+
 static bool decode(uint8_t* bits, uint32_t numbytes, uint32_t numbits, ProtoViewMsgInfo* info) {
-    const char* sync_pattern = "010101010101"
-                               "0110";
     uint8_t sync_len = 12 + 4; /* We just use 12 preamble symbols + sync. */
     if(numbits - sync_len < 8 * 8) return false;
 
-    uint64_t off = bitmap_seek_bits(bits, numbytes, 0, numbits, sync_pattern);
+    uint64_t off = bitmap_seek_pattern(bits, numbytes, 0, numbits, &sync_pattern);
     if(off == BITMAP_SEEK_NOT_FOUND) return false;
     FURI_LOG_E(TAG, "Fort TPMS preamble+sync found");
 
@@ -27,8 +37,8 @@ static bool decode(uint8_t* bits, uint32_t numbytes, uint32_t numbits, ProtoView
     off += sync_len; /* Skip preamble and sync. */
 
     uint8_t raw[8];
-    uint32_t decoded = convert_from_line_code(
-        raw, sizeof(raw), bits, numbytes, off, "01", "10"); /* Manchester. */
+    uint32_t decoded = convert_from_line_code_pattern(
+        raw, sizeof(raw), bits, numbytes, off, &zero, &one); /* Manchester. */
     FURI_LOG_E(TAG, "Ford TPMS decoded bits: %lu", decoded);
 
     if(decoded < 8 * 8) return false; /* Require the full 8 bytes. */
@@ -58,5 +68,11 @@ static bool decode(uint8_t* bits, uint32_t numbytes, uint32_t numbits, ProtoView
     return true;
 }
 
-ProtoViewDecoder FordTPMSDecoder =
-    {.name = "Ford TPMS", .decode = decode, .get_fields = NULL, .build_message = NULL};
+ProtoViewDecoder FordTPMSDecoder = {
+    .name = "Ford TPMS",
+    .decode = decode,
+    .get_fields = NULL,
+    .build_message = NULL,
+    .min_short_pulse = 20,
+    .max_short_pulse = 250,
+    .init = init};
@@ -25,6 +25,15 @@ static const char* test_vector =
     "0101010101010101" // Two FF bytes (usually). Unknown.
     "0110010101010101"; // CRC8 with (poly 7, initialization 0).
 
+/* Patterns matched by decode(), compiled once by init(). */
+static BitmapPattern sync_pattern, zero, one;
+
+static void init(void) {
+    bitmap_pattern_compile(&sync_pattern, "01010101010101010110");
+    bitmap_pattern_compile(&zero, "01"); /* Manchester. */
+    bitmap_pattern_compile(&one, "10");
+}
+
 static bool decode(uint8_t* bits, uint32_t numbytes, uint32_t numbits, ProtoViewMsgInfo* info) {
     if(USE_TEST_VECTOR) { /* Test vector to check that decoding works. */
         bitmap_set_pattern(bits, numbytes, 0, test_vector);
@@ -33,8 +42,7 @@ static bool decode(uint8_t* bits, uint32_t numbytes, uint32_t numbits, ProtoView
 
     if(numbits - 12 < 9 * 8) return false;
 
-    const char* sync_pattern = "01010101010101010110";
-    uint64_t off = bitmap_seek_bits(bits, numbytes, 0, numbits, sync_pattern);
+    uint64_t off = bitmap_seek_pattern(bits, numbytes, 0, numbits, &sync_pattern);
     if(off == BITMAP_SEEK_NOT_FOUND) return false;
     FURI_LOG_E(TAG, "Renault TPMS preamble+sync found");
 
@@ -42,8 +50,8 @@ static bool decode(uint8_t* bits, uint32_t numbytes, uint32_t numbits, ProtoView
     off += 20; /* Skip preamble. */
 
     uint8_t raw[9];
-    uint32_t decoded = convert_from_line_code(
-        raw, sizeof(raw), bits, numbytes, off, "01", "10"); /* Manchester. */
+    uint32_t decoded = convert_from_line_code_pattern(
+        raw, sizeof(raw), bits, numbytes, off, &zero, &one); /* Manchester. */
     FURI_LOG_E(TAG, "Renault TPMS decoded bits: %lu", decoded);
 
     if(decoded < 8 * 9) return false; /* Require the full 9 bytes. */
@@ -116,4 +124,7 @@ ProtoViewDecoder RenaultTPMSDecoder = {
     .name = "Renault TPMS",
     .decode = decode,
     .get_fields = get_fields,
-    .build_message = build_message};
+    .build_message = build_message,
+    .min_short_pulse = 20,
+    .max_short_pulse = 250,
+    .init = init};
@@ -17,6 +17,18 @@
 static const char* test_vector =
     "000000111101010101011010010110010110101001010110100110011001100101010101011010100110100110011010101010101010101010101010101010101010101010101010";
 
+/* Patterns matched by decode(), compiled once by init(). */
+static BitmapPattern sync_pattern, zero, one;
+
+static void init(void) {
+    bitmap_pattern_compile(
+        &sync_pattern,
+        "1111010101"
+        "01011010");
+    bitmap_pattern_compile(&zero, "01"); /* Manchester code. */
+    bitmap_pattern_compile(&one, "10");
+}
+
 static bool decode(uint8_t* bits, uint32_t numbytes, uint32_t numbits, ProtoViewMsgInfo* info) {
     if(USE_TEST_VECTOR) { /* Test vector to check that decoding works. */
         bitmap_set_pattern(bits, numbytes, 0, test_vector);
@@ -25,9 +37,7 @@ static bool decode(uint8_t* bits, uint32_t numbytes, uint32_t numbits, ProtoView
 
     if(numbits < 64) return false; /* Preamble + data. */
 
-    const char* sync_pattern = "1111010101"
-                               "01011010";
-    uint64_t off = bitmap_seek_bits(bits, numbytes, 0, numbits, sync_pattern);
+    uint64_t off = bitmap_seek_pattern(bits, numbytes, 0, numbits, &sync_pattern);
     if(off == BITMAP_SEEK_NOT_FOUND) return false;
     FURI_LOG_E(TAG, "Schrader TPMS gap+preamble found");
 
@@ -38,8 +48,8 @@ static bool decode(uint8_t* bits, uint32_t numbytes, uint32_t numbits, ProtoView
 
     uint8_t raw[8];
     uint8_t id[4];
-    uint32_t decoded = convert_from_line_code(
-        raw, sizeof(raw), bits, numbytes, off, "01", "10"); /* Manchester code. */
+    uint32_t decoded = convert_from_line_code_pattern(
+        raw, sizeof(raw), bits, numbytes, off, &zero, &one); /* Manchester code. */
     FURI_LOG_E(TAG, "Schrader TPMS decoded bits: %lu", decoded);
 
     if(decoded < 64) return false; /* Require the full 8 bytes. */
@@ -66,5 +76,11 @@ static bool decode(uint8_t* bits, uint32_t numbytes, uint32_t numbits, ProtoView
     return true;
 }
 
-ProtoViewDecoder SchraderTPMSDecoder =
-    {.name = "Schrader TPMS", .decode = decode, .get_fields = NULL, .build_message = NULL};
+ProtoViewDecoder SchraderTPMSDecoder = {
+    .name = "Schrader TPMS",
+    .decode = decode,
+    .get_fields = NULL,
+    .build_message = NULL,
+    .min_short_pulse = 20,
+    .max_short_pulse = 250,
+    .init = init};
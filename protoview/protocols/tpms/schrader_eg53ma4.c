@@ -18,13 +18,23 @@
 
 #include "../../app.h"
 
+/* Patterns matched by decode(), compiled once by init(). */
+static BitmapPattern sync_pattern, zero, one;
+
+static void init(void) {
+    bitmap_pattern_compile(
+        &sync_pattern,
+        "010101010101"
+        "01100101");
+    bitmap_pattern_compile(&zero, "01"); /* Manchester code. */
+    bitmap_pattern_compile(&one, "10");
+}
+
 static bool decode(uint8_t* bits, uint32_t numbytes, uint32_t numbits, ProtoViewMsgInfo* info) {
-    const char* sync_pattern = "010101010101"
-                               "01100101";
     uint8_t sync_len = 12 + 8; /* We just use 12 preamble symbols + sync. */
     if(numbits - sync_len + 8 < 8 * 10) return false;
 
-    uint64_t off = bitmap_seek_bits(bits, numbytes, 0, numbits, sync_pattern);
+    uint64_t off = bitmap_seek_pattern(bits, numbytes, 0, numbits, &sync_pattern);
     if(off == BITMAP_SEEK_NOT_FOUND) return false;
     FURI_LOG_E(TAG, "Schrader EG53MA4 TPMS preamble+sync found");
 
@@ -32,8 +42,8 @@ static bool decode(uint8_t* bits, uint32_t numbytes, uint32_t numbits, ProtoView
     off += sync_len - 8; /* Skip preamble, not sync that is part of the data. */
 
     uint8_t raw[10];
-    uint32_t decoded = convert_from_line_code(
-        raw, sizeof(raw), bits, numbytes, off, "01", "10"); /* Manchester code. */
+    uint32_t decoded = convert_from_line_code_pattern(
+        raw, sizeof(raw), bits, numbytes, off, &zero, &one); /* Manchester code. */
     FURI_LOG_E(TAG, "Schrader EG53MA4 TPMS decoded bits: %lu", decoded);
 
     if(decoded < 10 * 8) return false; /* Require the full 10 bytes. */
@@ -59,5 +69,11 @@ static bool decode(uint8_t* bits, uint32_t numbytes, uint32_t numbits, ProtoView
     return true;
 }
 
-ProtoViewDecoder SchraderEG53MA4TPMSDecoder =
-    {.name = "Schrader EG53MA4 TPMS", .decode = decode, .get_fields = NULL, .build_message = NULL};
+ProtoViewDecoder SchraderEG53MA4TPMSDecoder = {
+    .name = "Schrader EG53MA4 TPMS",
+    .decode = decode,
+    .get_fields = NULL,
+    .build_message = NULL,
+    .min_short_pulse = 20,
+    .max_short_pulse = 250,
+    .init = init};
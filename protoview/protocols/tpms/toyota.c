@@ -27,20 +27,28 @@
 
 #include "../../app.h"
 
+static const char* sync[] = {"00111100", "001111100", "00111101", "001111101", NULL};
+
+/* Patterns matched by decode(), compiled once by init(). */
+static BitmapPattern sync_patterns[COUNT_OF(sync) - 1];
+
+static void init(void) {
+    for(int j = 0; sync[j]; j++)
+        bitmap_pattern_compile(&sync_patterns[j], sync[j]);
+}
+
 static bool decode(uint8_t* bits, uint32_t numbytes, uint32_t numbits, ProtoViewMsgInfo* info) {
     if(numbits - 6 < 64 * 2)
         return false; /* Ask for 64 bit of data (each bit
                                            is two symbols in the bitmap). */
 
-    char* sync[] = {"00111100", "001111100", "00111101", "001111101", NULL};
-
     int j;
     uint32_t off = 0;
     for(j = 0; sync[j]; j++) {
-        off = bitmap_seek_bits(bits, numbytes, 0, numbits, sync[j]);
+        off = bitmap_seek_pattern(bits, numbytes, 0, numbits, &sync_patterns[j]);
         if(off != BITMAP_SEEK_NOT_FOUND) {
             info->start_off = off;
-            off += strlen(sync[j]) - 2;
+            off += sync_patterns[j].len - 2;
             break;
         }
     }
@@ -77,5 +85,11 @@ static bool decode(uint8_t* bits, uint32_t numbytes, uint32_t numbits, ProtoView
     return true;
 }
 
-ProtoViewDecoder ToyotaTPMSDecoder =
-    {.name = "Toyota TPMS", .decode = decode, .get_fields = NULL, .build_message = NULL};
+ProtoViewDecoder ToyotaTPMSDecoder = {
+    .name = "Toyota TPMS",
+    .decode = decode,
+    .get_fields = NULL,
+    .build_message = NULL,
+    .min_short_pulse = 20,
+    .max_short_pulse = 250,
+    .init = init};
@@ -322,5 +322,7 @@ static bool decode(uint8_t* bits, uint32_t numbytes, uint32_t numbits, ProtoView
     return true;
 }
 
+/* No short pulse range: this is the fallback for any signal no other
+ * decoder recognized, whatever its timing. */
 ProtoViewDecoder UnknownDecoder =
     {.name = "Unknown", .decode = decode, .get_fields = NULL, .build_message = NULL};
@@ -10,7 +10,8 @@
 /* Allocate and initialize a samples buffer. */
 RawSamplesBuffer* raw_samples_alloc(void) {
     RawSamplesBuffer* buf = malloc(sizeof(*buf));
-    buf->mutex = furi_mutex_alloc(FuriMutexTypeNormal);
+    buf->mutex = furi_mutex_alloc(FuriMutexTypeRecursive);
+    buf->idx = 0;
     raw_samples_reset(buf);
     return buf;
 }
@@ -21,13 +22,19 @@ void raw_samples_free(RawSamplesBuffer* s) {
     free(s);
 }
 
-/* This just set all the samples to zero and also resets the internal
- * index. There is no need to call it after raw_samples_alloc(), but only
- * when one wants to reset the whole buffer of samples. */
+/* This just set all the samples to zero. There is no need to call it
+ * after raw_samples_alloc(), but only when one wants to reset the whole
+ * buffer of samples.
+ *
+ * The index is left where it is: on the live buffer it is owned by the
+ * radio interrupt, that doesn't take the mutex, so storing it from here
+ * could race with raw_samples_add() publishing a new one. Nothing
+ * depends on where the index is after a reset: all the samples read as
+ * zero, except the ones the radio adds meanwhile, that are legit new
+ * samples. */
 void raw_samples_reset(RawSamplesBuffer* s) {
     furi_mutex_acquire(s->mutex, FuriWaitForever);
     s->total = RAW_SAMPLES_NUM;
-    s->idx = 0;
     s->short_pulse_dur = 0;
     memset(s->samples, 0, sizeof(s->samples));
     furi_mutex_release(s->mutex);
@@ -36,16 +43,19 @@ void raw_samples_reset(RawSamplesBuffer* s) {
 /* Set the raw sample internal index so that what is currently at
  * offset 'offset', will appear to be at 0 index. */
 void raw_samples_center(RawSamplesBuffer* s, uint32_t offset) {
+    furi_mutex_acquire(s->mutex, FuriWaitForever);
     s->idx = (s->idx + offset) % RAW_SAMPLES_NUM;
+    furi_mutex_release(s->mutex);
 }
 
-/* Add the specified sample in the circular buffer. */
+/* Add the specified sample in the circular buffer. This is called from
+ * the radio interrupt, so it does not take the mutex: there is a single
+ * producer, and the index is published only after the sample is stored. */
 void raw_samples_add(RawSamplesBuffer* s, bool level, uint32_t dur) {
-    furi_mutex_acquire(s->mutex, FuriWaitForever);
-    s->samples[s->idx].level = level;
-    s->samples[s->idx].dur = dur;
-    s->idx = (s->idx + 1) % RAW_SAMPLES_NUM;
-    furi_mutex_release(s->mutex);
+    uint32_t idx = s->idx;
+    s->samples[idx].level = level;
+    s->samples[idx].dur = dur;
+    __atomic_store_n(&s->idx, (idx + 1) % RAW_SAMPLES_NUM, __ATOMIC_RELEASE);
 }
 
 /* This is like raw_samples_add(), however in case a sample of the
@@ -72,22 +82,40 @@ void raw_samples_add_or_update(RawSamplesBuffer* s, bool level, uint32_t dur) {
 }
 
 /* Get the sample from the buffer. It is possible to use out of range indexes
- * as 'idx' because the modulo operation will rewind back from the start. */
+ * as 'idx' because the modulo operation will rewind back from the start.
+ *
+ * This is called for every sample, so it doesn't take the mutex. The
+ * decoding code only uses it on private copies of the live buffer. Readers
+ * of a buffer that another thread may change at the same time (the GUI
+ * rendering DetectedSamples) must hold s->mutex around the whole read. */
 void raw_samples_get(RawSamplesBuffer* s, uint32_t idx, bool* level, uint32_t* dur) {
-    furi_mutex_acquire(s->mutex, FuriWaitForever);
     idx = (s->idx + idx) % RAW_SAMPLES_NUM;
     *level = s->samples[idx].level;
     *dur = s->samples[idx].dur;
-    furi_mutex_release(s->mutex);
 }
 
-/* Copy one buffer to the other, including current index. */
+/* Copy one buffer to the other, including current index.
+ *
+ * The source may be the live buffer, that the radio keeps filling while
+ * we copy. We don't stop it: the index is read before and after the copy,
+ * and the samples written in between (the oldest ones in the snapshot,
+ * since the producer writes at the index) are zeroed, so the snapshot is
+ * coherent. The slot at the final index is zeroed too: the producer
+ * stores level and duration separately before publishing the index, so
+ * that sample may have been half written when we copied it. A zero
+ * duration sample is never part of a detected signal. */
 void raw_samples_copy(RawSamplesBuffer* dst, RawSamplesBuffer* src) {
-    furi_mutex_acquire(src->mutex, FuriWaitForever);
     furi_mutex_acquire(dst->mutex, FuriWaitForever);
-    dst->idx = src->idx;
-    dst->short_pulse_dur = src->short_pulse_dur;
+    uint32_t start = __atomic_load_n(&src->idx, __ATOMIC_ACQUIRE);
     memcpy(dst->samples, src->samples, sizeof(dst->samples));
-    furi_mutex_release(src->mutex);
+    uint32_t end = __atomic_load_n(&src->idx, __ATOMIC_ACQUIRE);
+    uint32_t overwritten = (end - start) % RAW_SAMPLES_NUM;
+    for(uint32_t j = 0; j <= overwritten; j++) {
+        uint32_t idx = (start + j) % RAW_SAMPLES_NUM;
+        dst->samples[idx].level = 0;
+        dst->samples[idx].dur = 0;
+    }
+    dst->idx = start;
+    dst->short_pulse_dur = src->short_pulse_dur;
     furi_mutex_release(dst->mutex);
 }
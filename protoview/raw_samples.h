@@ -2,7 +2,22 @@
  * See the LICENSE file for information about the license. */
 
 /* Our circular buffer of raw samples, used in order to display
- * the signal. */
+ * the signal.
+ *
+ * The live buffer is filled by the radio callback in interrupt context,
+ * so raw_samples_add() is lock free: it is a single producer ring where
+ * the sample is written before publishing the new index. Readers never
+ * stop the producer: raw_samples_copy() takes a snapshot and invalidates
+ * the few samples that were overwritten while it was copying. The mutex
+ * only serializes the operations that modify a buffer from threads
+ * (copy destination, reset, center, add_or_update): it never excludes the
+ * producer, so no thread side operation stores the live buffer index.
+ *
+ * raw_samples_get() doesn't lock, since it runs for every sample. To read
+ * a buffer another thread may update, like DetectedSamples that the GUI
+ * renders while the scan timer replaces it, hold the mutex around the
+ * whole read. It is recursive, so the writer can also hold it across
+ * several calls, to make them look atomic to readers. */
 
 #define RAW_SAMPLES_NUM \
     2048 /* Use a power of two: we take the modulo
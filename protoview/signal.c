@@ -3,7 +3,7 @@
 
 #include "app.h"
 
-bool decode_signal(RawSamplesBuffer* s, uint64_t len, ProtoViewMsgInfo* info);
+bool decode_signal(ProtoViewApp* app, RawSamplesBuffer* s, uint64_t len, ProtoViewMsgInfo* info);
 
 /* =============================================================================
  * Protocols table.
@@ -183,8 +183,10 @@ void notify_signal_detected(ProtoViewApp* app, bool decoded) {
 /* Search the source buffer with the stored signal (last N samples received)
  * in order to find a coherent signal. If a signal that does not appear to
  * be just noise is found, it is set in DetectedSamples global signal
- * buffer, that is what is rendered on the screen. */
-void scan_for_signal(ProtoViewApp* app, RawSamplesBuffer* source, uint32_t min_duration) {
+ * buffer, that is what is rendered on the screen.
+ *
+ * Returns the number of coherent signals passed to the decoders. */
+uint32_t scan_for_signal(ProtoViewApp* app, RawSamplesBuffer* source, uint32_t min_duration) {
     /* We need to work on a copy: the source buffer may be populated
      * by the background thread receiving data. */
     RawSamplesBuffer* copy = raw_samples_alloc();
@@ -197,12 +199,14 @@ void scan_for_signal(ProtoViewApp* app, RawSamplesBuffer* source, uint32_t min_d
                                        mistake noise for signal. */
 
     uint32_t i = 0;
+    uint32_t candidates = 0;
 
     while(i < copy->total - 1) {
         uint32_t thislen = search_coherent_signal(copy, i, min_duration);
 
         /* For messages that are long enough, attempt decoding. */
         if(thislen > minlen) {
+            candidates++;
             /* Allocate the message information that some decoder may
              * fill, in case it is able to decode a message. */
             ProtoViewMsgInfo* info = malloc(sizeof(ProtoViewMsgInfo));
@@ -214,7 +218,7 @@ void scan_for_signal(ProtoViewApp* app, RawSamplesBuffer* source, uint32_t min_d
             /* decode_signal() expects the detected signal to start
              * from index zero .*/
             raw_samples_center(copy, i);
-            bool decoded = decode_signal(copy, thislen, info);
+            bool decoded = decode_signal(app, copy, thislen, info);
             copy->idx = saved_idx; /* Restore the index as we are scanning
                                       the signal in the loop. */
 
@@ -230,8 +234,12 @@ void scan_for_signal(ProtoViewApp* app, RawSamplesBuffer* source, uint32_t min_d
                 app->msg_info = info;
                 app->signal_bestlen = thislen;
                 app->signal_decoded = decoded;
+                /* Copy and center as one step for the GUI, that renders
+                 * DetectedSamples under its mutex. */
+                furi_mutex_acquire(DetectedSamples->mutex, FuriWaitForever);
                 raw_samples_copy(DetectedSamples, copy);
                 raw_samples_center(DetectedSamples, i);
+                furi_mutex_release(DetectedSamples->mutex);
                 FURI_LOG_E(
                     TAG,
                     "===> Displayed sample updated (%d samples %lu us)",
@@ -249,6 +257,7 @@ void scan_for_signal(ProtoViewApp* app, RawSamplesBuffer* source, uint32_t min_d
         i += thislen ? thislen : 1;
     }
     raw_samples_free(copy);
+    return candidates;
 }
 
 /* =============================================================================
@@ -399,10 +408,84 @@ void bitmap_reverse_bytes_bits(uint8_t* p, uint32_t len) {
     }
 }
 
+/* Compile a pattern given as a string of "0" and "1" characters, like the
+ * ones accepted by bitmap_match_bits(), into a packed BitmapPattern, so that
+ * it can be matched against a whole window of bits at once. Returns false if
+ * the pattern is longer than BITMAP_PATTERN_MAX_BITS: callers should then use
+ * the string based functions. */
+bool bitmap_pattern_compile(BitmapPattern* p, const char* bits) {
+    p->bits = 0;
+    p->len = 0;
+    while(bits[p->len]) {
+        if(p->len == BITMAP_PATTERN_MAX_BITS) return false;
+        p->bits = (p->bits << 1) | (bits[p->len] == '1');
+        p->len++;
+    }
+    return true;
+}
+
+/* Return 64 bits of the bitmap 'b' of 'blen' bytes starting at 'bitpos',
+ * with the first bit in the MSB. Out of range bits are returned as zero,
+ * exactly like bitmap_get() does. */
+static uint64_t bitmap_get_window64(uint8_t* b, uint32_t blen, uint32_t bitpos) {
+    uint32_t byte = bitpos / 8;
+    uint32_t skew = bitpos & 7;
+    uint64_t w = 0;
+    for(uint32_t j = 0; j < 8; j++) {
+        w <<= 8;
+        if(byte + j < blen) w |= b[byte + j];
+    }
+    if(skew) {
+        w <<= skew;
+        if(byte + 8 < blen) w |= b[byte + 8] >> (8 - skew);
+    }
+    return w;
+}
+
+/* Like bitmap_match_bits() but for a compiled pattern. */
+bool bitmap_match_pattern(uint8_t* b, uint32_t blen, uint32_t bitpos, const BitmapPattern* p) {
+    if(p->len == 0) return true;
+    return (bitmap_get_window64(b, blen, bitpos) >> (64 - p->len)) == p->bits;
+}
+
+/* Like bitmap_seek_bits() but for a compiled pattern. Instead of testing
+ * the pattern bit by bit at every offset, we load a 64 bit window and
+ * shift it one bit at a time, comparing the top bits against the packed
+ * pattern. The window is reloaded every 65 - len shifts, so that it always
+ * holds at least the 'len' bits of the pattern. */
+uint32_t bitmap_seek_pattern(
+    uint8_t* b,
+    uint32_t blen,
+    uint32_t startpos,
+    uint32_t maxbits,
+    const BitmapPattern* p) {
+    uint32_t endpos = startpos + blen * 8;
+    uint32_t end2 = startpos + maxbits;
+    if(end2 < endpos) endpos = end2;
+    if(p->len == 0) return startpos < endpos ? startpos : BITMAP_SEEK_NOT_FOUND;
+
+    uint32_t shift = 64 - p->len;
+    uint64_t w = 0;
+    uint32_t valid = 0; /* Shifts left before the window must be reloaded. */
+    for(uint32_t j = startpos; j < endpos; j++) {
+        if(valid == 0) {
+            w = bitmap_get_window64(b, blen, j);
+            valid = shift + 1;
+        }
+        if((w >> shift) == p->bits) return j;
+        w <<= 1;
+        valid--;
+    }
+    return BITMAP_SEEK_NOT_FOUND;
+}
+
 /* Return true if the specified sequence of bits, provided as a string in the
  * form "11010110..." is found in the 'b' bitmap of 'blen' bits at 'bitpos'
  * position. */
 bool bitmap_match_bits(uint8_t* b, uint32_t blen, uint32_t bitpos, const char* bits) {
+    BitmapPattern p;
+    if(bitmap_pattern_compile(&p, bits)) return bitmap_match_pattern(b, blen, bitpos, &p);
+
     for(size_t j = 0; bits[j]; j++) {
         bool expected = (bits[j] == '1') ? true : false;
         if(bitmap_get(b, blen, bitpos + j) != expected) return false;
@@ -415,15 +498,20 @@ bool bitmap_match_bits(uint8_t* b, uint32_t blen, uint32_t bitpos, const char* b
  * Returns the offset (in bits) of the match, or BITMAP_SEEK_NOT_FOUND if not
  * found.
  *
- * Note: there are better algorithms, such as Boyer-Moore. Here we hope that
- * for the kind of patterns we search we'll have a lot of early stops so
- * we use a vanilla approach. */
+ * Patterns up to BITMAP_PATTERN_MAX_BITS long are compiled and searched
+ * with bitmap_seek_pattern(). Longer ones use a vanilla bit by bit approach.
+ * Decoders should rather compile their patterns once in their init method
+ * and call bitmap_seek_pattern() directly. */
 uint32_t bitmap_seek_bits(
     uint8_t* b,
     uint32_t blen,
     uint32_t startpos,
     uint32_t maxbits,
     const char* bits) {
+    BitmapPattern p;
+    if(bitmap_pattern_compile(&p, bits))
+        return bitmap_seek_pattern(b, blen, startpos, maxbits, &p);
+
     uint32_t endpos = startpos + blen * 8;
     uint32_t end2 = startpos + maxbits;
     if(end2 < endpos) endpos = end2;
@@ -557,16 +645,56 @@ uint32_t convert_from_line_code(
     uint32_t off,
     const char* zero_pattern,
     const char* one_pattern) {
+    /* Compile the two symbols once: they are matched at every step. */
+    BitmapPattern zero, one;
+    if(bitmap_pattern_compile(&zero, zero_pattern) && bitmap_pattern_compile(&one, one_pattern))
+        return convert_from_line_code_pattern(buf, buflen, bits, len, off, &zero, &one);
+
     uint32_t decoded = 0; /* Number of bits extracted. */
+    uint32_t bytes = len;
     len *= 8; /* Convert bytes to bits. */
+    uint32_t zero_len = strlen(zero_pattern);
+    uint32_t one_len = strlen(one_pattern);
+
     while(off < len) {
         bool bitval;
-        if(bitmap_match_bits(bits, len, off, zero_pattern)) {
+        if(bitmap_match_bits(bits, bytes, off, zero_pattern)) {
             bitval = false;
-            off += strlen(zero_pattern);
-        } else if(bitmap_match_bits(bits, len, off, one_pattern)) {
+            off += zero_len;
+        } else if(bitmap_match_bits(bits, bytes, off, one_pattern)) {
             bitval = true;
-            off += strlen(one_pattern);
+            off += one_len;
+        } else {
+            break;
+        }
+        bitmap_set(buf, buflen, decoded++, bitval);
+        if(decoded / 8 == buflen) break; /* No space left on target buffer. */
+    }
+    return decoded;
+}
+
+/* Like convert_from_line_code() but with the symbols already compiled,
+ * typically by the decoder init method. */
+uint32_t convert_from_line_code_pattern(
+    uint8_t* buf,
+    uint64_t buflen,
+    uint8_t* bits,
+    uint32_t len,
+    uint32_t off,
+    const BitmapPattern* zero,
+    const BitmapPattern* one) {
+    uint32_t decoded = 0; /* Number of bits extracted. */
+    uint32_t bytes = len;
+    len *= 8; /* Convert bytes to bits. */
+
+    while(off < len) {
+        bool bitval;
+        if(bitmap_match_pattern(bits, bytes, off, zero)) {
+            bitval = false;
+            off += zero->len;
+        } else if(bitmap_match_pattern(bits, bytes, off, one)) {
+            bitval = true;
+            off += one->len;
         } else {
             break;
         }
@@ -619,20 +747,49 @@ void init_msg_info(ProtoViewMsgInfo* i, ProtoViewApp* app) {
     i->fieldset = fieldset_new();
 }
 
+/* Return the number of decoders in Decoders[], not counting the
+ * NULL terminator. */
+uint32_t count_decoders(void) {
+    uint32_t count = 0;
+    while(Decoders[count])
+        count++;
+    return count;
+}
+
+/* Call the init method of the decoders that have one. Must run once before
+ * any decoding happens. */
+void decoders_init(void) {
+    for(uint32_t j = 0; Decoders[j]; j++)
+        if(Decoders[j]->init) Decoders[j]->init();
+}
+
+/* Cheap prefilter run before calling a decoder: the short pulse duration
+ * detected by search_coherent_signal() is compared with the range the
+ * protocol is known to use, so that on a busy band we don't run every
+ * decoder on signals that can't possibly be theirs. */
+static bool decoder_may_match(ProtoViewDecoder* d, uint32_t short_pulse_dur) {
+    if(d->min_short_pulse && short_pulse_dur < d->min_short_pulse) return false;
+    if(d->max_short_pulse && short_pulse_dur > d->max_short_pulse) return false;
+    return true;
+}
+
 /* This function is called when a new signal is detected. It converts it
  * to a bitstream, and the calls the protocol specific functions for
  * decoding. If the signal was decoded correctly by some protocol, true
  * is returned. Otherwise false is returned. */
-bool decode_signal(RawSamplesBuffer* s, uint64_t len, ProtoViewMsgInfo* info) {
-    uint32_t bitmap_bits_size = 4096 * 8;
-    uint32_t bitmap_size = bitmap_bits_size / 8;
+bool decode_signal(ProtoViewApp* app, RawSamplesBuffer* s, uint64_t len, ProtoViewMsgInfo* info) {
+    uint32_t bitmap_size = DECODE_BITMAP_SIZE;
 
     /* We call the decoders with an offset a few samples before the actual
      * signal detected and for a len of a few bits after its end. */
     uint32_t before_samples = 32;
     uint32_t after_samples = 100;
 
-    uint8_t* bitmap = malloc(bitmap_size);
+    /* The bitmap is allocated once with the app and reused for every
+     * signal. Clear it so that decoders looking past the sampled bits
+     * don't see the previous signal. */
+    uint8_t* bitmap = app->decode_bitmap;
+    memset(bitmap, 0, bitmap_size);
     uint32_t bits = convert_signal_to_bits(
         bitmap,
         bitmap_size,
@@ -657,15 +814,22 @@ bool decode_signal(RawSamplesBuffer* s, uint64_t len, ProtoViewMsgInfo* info) {
 
     bool decoded = false;
     while(Decoders[j]) {
-        uint32_t start_time = furi_get_tick();
-        decoded = Decoders[j]->decode(bitmap, bitmap_size, bits, info);
-        uint32_t delta = furi_get_tick() - start_time;
-        FURI_LOG_E(TAG, "Decoder %s took %lu ms", Decoders[j]->name, (unsigned long)delta);
+        ProtoViewDecoderStats* stats = &app->decoder_stats[j];
+        ProtoViewDecoder* d = Decoders[j++];
+        if(!decoder_may_match(d, s->short_pulse_dur)) {
+            stats->skipped++;
+            continue;
+        }
+        /* A decoder pass takes well under a tick, so time it in cycles. */
+        uint32_t start_cycles = DWT->CYCCNT;
+        decoded = d->decode(bitmap, bitmap_size, bits, info);
+        stats->us += (DWT->CYCCNT - start_cycles) / furi_hal_cortex_instructions_per_microsecond();
+        stats->calls++;
         if(decoded) {
-            info->decoder = Decoders[j];
+            stats->hits++;
+            info->decoder = d;
             break;
         }
-        j++;
     }
 
     if(!decoded) {
@@ -689,6 +853,5 @@ bool decode_signal(RawSamplesBuffer* s, uint64_t len, ProtoViewMsgInfo* info) {
                 info->pulses_count);
         }
     }
-    free(bitmap);
     return decoded;
 }
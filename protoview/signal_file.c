@@ -4,6 +4,7 @@
 
 #include "app.h"
 #include <stream/stream.h>
+#include <stream/file_stream.h>
 #include <flipper_format/flipper_format_i.h>
 
 /* ========================= Signal file operations ========================= */
@@ -143,3 +144,75 @@ write_err:
     if(file_content != NULL) furi_string_free(file_content);
     return success;
 }
+
+/* Replay a Flipper SubGhz RAW file through the same detection and decoding
+ * pipeline used for live signals, as fast as the CPU allows. The RAW_Data
+ * samples are added to a private samples buffer and, exactly like
+ * timer_callback() does with the live buffer, scan_for_signal() is called
+ * each time half of the buffer was refilled. This is useful to check the
+ * decoders against captured signals without a radio, and to measure how
+ * fast the pipeline is: the result is logged at the end.
+ *
+ * As a side effect, like with live signals, the best signal found is
+ * displayed by the raw pulses and info views. */
+bool replay_signal_file(ProtoViewApp* app, const char* filename) {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    Stream* stream = file_stream_alloc(storage);
+    bool success = false;
+
+    if(file_stream_open(stream, filename, FSAM_READ, FSOM_OPEN_EXISTING)) {
+        RawSamplesBuffer* buf = raw_samples_alloc();
+        FuriString* line = furi_string_alloc();
+        uint32_t min_duration = ProtoViewModulations[app->modulation].duration_filter;
+        uint32_t samples = 0, candidates = 0, since_scan = 0;
+        uint32_t hits_before = 0, hits_after = 0;
+        for(int j = 0; Decoders[j]; j++)
+            hits_before += app->decoder_stats[j].hits;
+
+        uint32_t start = furi_get_tick();
+        while(stream_read_line(stream, line)) {
+            if(!furi_string_start_with_str(line, "RAW_Data:")) continue;
+            const char* p = furi_string_get_cstr(line) + strlen("RAW_Data:");
+            char* endptr;
+            while(true) {
+                long dur = strtol(p, &endptr, 10);
+                if(endptr == p) break;
+                p = endptr;
+                bool level = dur > 0;
+                if(dur < 0) dur = -dur;
+                if(dur > 0x7fff) dur = 0x7fff; /* Samples are 15 bits. */
+                raw_samples_add(buf, level, dur);
+                samples++;
+                if(++since_scan == RAW_SAMPLES_NUM / 2) {
+                    candidates += scan_for_signal(app, buf, min_duration);
+                    since_scan = 0;
+                }
+            }
+        }
+        if(since_scan) candidates += scan_for_signal(app, buf, min_duration);
+        uint32_t elapsed = furi_get_tick() - start;
+
+        for(int j = 0; Decoders[j]; j++)
+            hits_after += app->decoder_stats[j].hits;
+        if(elapsed == 0) elapsed = 1;
+        FURI_LOG_I(
+            TAG,
+            "Replayed %lu samples in %lu ms: %lu signals (%lu/s), %lu decoded",
+            samples,
+            elapsed,
+            candidates,
+            candidates * 1000 / elapsed,
+            hits_after - hits_before);
+
+        furi_string_free(line);
+        raw_samples_free(buf);
+        success = true;
+    } else {
+        FURI_LOG_W(TAG, "Unable to open replay file %s", filename);
+    }
+
+    file_stream_close(stream);
+    stream_free(stream);
+    furi_record_close(RECORD_STORAGE);
+    return success;
+}
@@ -3,8 +3,6 @@
 
 #include "app.h"
 
-extern ProtoViewDecoder* Decoders[]; // Defined in signal.c.
-
 /* Our view private data. */
 #define USER_VALUE_LEN 64
 typedef struct {
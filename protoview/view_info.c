@@ -10,6 +10,7 @@
 enum {
     SubViewInfoMain,
     SubViewInfoSave,
+    SubViewInfoStats,
     SubViewInfoLast, /* Just a sentinel. */
 };
 
@@ -24,6 +25,7 @@ typedef struct {
     uint8_t cur_info_page; // Info page to display. Useful when there are
         // too many fields populated by the decoder that
         // a single page is not enough.
+    uint8_t cur_stats_page; // Decoders stats page to display.
 } InfoViewPrivData;
 
 /* Draw the text label and value of the specified info field at x,y. */
@@ -118,22 +120,64 @@ static void render_subview_save(Canvas* const canvas, ProtoViewApp* app) {
     canvas_draw_str(canvas, 0, 6, "ok: send, long ok: save");
 }
 
+/* Render the decoders runtime stats: for each decoder the number of
+ * signals it decoded, the number of times it was called and the average
+ * time spent inside it per call. Decoders skipped by the prefilter in
+ * decode_signal() don't count as calls. */
+#define STATS_LINES_PER_PAGE 5
+static void render_subview_stats(Canvas* const canvas, ProtoViewApp* app) {
+    InfoViewPrivData* privdata = app->view_privdata;
+    uint32_t numdecoders = count_decoders();
+    uint8_t pages = (numdecoders + (STATS_LINES_PER_PAGE - 1)) / STATS_LINES_PER_PAGE;
+    privdata->cur_stats_page %= pages;
+    char buf[32];
+
+    canvas_set_font(canvas, FontPrimary);
+    uint8_t y = 8, lineheight = 10;
+    snprintf(buf, sizeof(buf), "Stats %u/%u", privdata->cur_stats_page + 1, pages);
+    canvas_draw_str(canvas, 0, y, buf);
+    y += lineheight;
+
+    canvas_set_font(canvas, FontSecondary);
+    uint32_t j = privdata->cur_stats_page * STATS_LINES_PER_PAGE;
+    for(uint8_t line = 0; line < STATS_LINES_PER_PAGE && j < numdecoders; line++, j++) {
+        ProtoViewDecoderStats* stats = &app->decoder_stats[j];
+        snprintf(
+            buf,
+            sizeof(buf),
+            "%.10s %lu/%lu %luus",
+            Decoders[j]->name,
+            stats->hits,
+            stats->calls,
+            stats->calls ? stats->us / stats->calls : 0);
+        canvas_draw_str(canvas, 0, y, buf);
+        y += lineheight;
+    }
+}
+
 /* Render the selected subview of this view. */
 void render_view_info(Canvas* const canvas, ProtoViewApp* app) {
-    if(app->signal_decoded == false) {
+    int subview = app->current_subview[app->current_view];
+
+    /* Stats are available even when no signal was decoded. The subviews
+     * indicator is only shown over actual content. */
+    if(app->signal_decoded == false && subview != SubViewInfoStats) {
         canvas_set_font(canvas, FontSecondary);
         canvas_draw_str(canvas, 30, 36, "No signal decoded");
         return;
     }
-
     ui_show_available_subviews(canvas, app, SubViewInfoLast);
-    switch(app->current_subview[app->current_view]) {
+
+    switch(subview) {
     case SubViewInfoMain:
         render_subview_main(canvas, app);
         break;
     case SubViewInfoSave:
         render_subview_save(canvas, app);
         break;
+    case SubViewInfoStats:
+        render_subview_stats(canvas, app);
+        break;
     }
 }
 
@@ -281,9 +325,10 @@ void notify_signal_sent(ProtoViewApp* app) {
 
 /* Handle input for the info view. */
 void process_input_info(ProtoViewApp* app, InputEvent input) {
-    /* If we don't have a decoded signal, we don't allow to go up/down
-     * in the subviews: they are only useful when a loaded signal. */
-    if(app->signal_decoded && ui_process_subview_updown(app, input, SubViewInfoLast)) return;
+    /* Navigating the subviews is always allowed, since the stats subview
+     * is useful even without a decoded signal. The save subview only
+     * handles input when there is a signal. */
+    if(ui_process_subview_updown(app, input, SubViewInfoLast)) return;
 
     InfoViewPrivData* privdata = app->view_privdata;
     int subview = ui_get_current_subview(app);
@@ -297,7 +342,7 @@ void process_input_info(ProtoViewApp* app, InputEvent input) {
             /* Show next info page. */
             privdata->cur_info_page++;
         }
-    } else if(subview == SubViewInfoSave) {
+    } else if(subview == SubViewInfoSave && app->signal_decoded) {
         /* Save subview. */
         if(input.type == InputTypePress && input.key == InputKeyRight) {
             privdata->signal_display_start_row++;
@@ -315,6 +360,11 @@ void process_input_info(ProtoViewApp* app, InputEvent input) {
             radio_tx_signal(app, radio_tx_feed_data, &send_state);
             notify_signal_sent(app);
         }
+    } else if(subview == SubViewInfoStats) {
+        if(input.type == InputTypeShort && input.key == InputKeyOk) {
+            /* Show next stats page. */
+            privdata->cur_stats_page++;
+        }
     }
 }
 
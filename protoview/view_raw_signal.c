@@ -11,9 +11,11 @@
  * plot comfortably 8 lines.
  *
  * The 'idx' argument is the first sample to render in the circular
- * buffer. */
+ * buffer. The buffer is locked while rendering, since the scan timer may
+ * replace the detected signal meanwhile. */
 void render_signal(ProtoViewApp* app, Canvas* const canvas, RawSamplesBuffer* buf, uint32_t idx) {
     canvas_set_color(canvas, ColorBlack);
+    furi_mutex_acquire(buf->mutex, FuriWaitForever);
 
     int rows = 8;
     uint32_t time_per_pixel = app->us_scale;
@@ -48,6 +50,7 @@ void render_signal(ProtoViewApp* app, Canvas* const canvas, RawSamplesBuffer* bu
                 dur = 0;
         }
     }
+    furi_mutex_release(buf->mutex);
 }
 
 /* Raw pulses rendering. This is our default view. */
@@ -376,11 +376,9 @@ static void drawAlignmentPattern(BitBucket* modules, BitBucket* isFunction, uint
     }
 }
 
-// Draws two copies of the format bits (with its own error correction code)
-// based on the given mask and this object's error correction level field.
-static void drawFormatBits(BitBucket* modules, BitBucket* isFunction, uint8_t ecc, uint8_t mask) {
-    uint8_t size = modules->bitOffsetOrWidth;
-
+// Returns the 15 format bits (with their own error correction code) for the given error
+// correction level and mask.
+static uint32_t getFormatBits(uint8_t ecc, uint8_t mask) {
     // Calculate error correction code and pack bits
     uint32_t data = ecc << 3 | mask; // errCorrLvl is uint2, mask is uint3
     uint32_t rem = data;
@@ -389,7 +387,14 @@ static void drawFormatBits(BitBucket* modules, BitBucket* isFunction, uint8_t ec
     }
 
     data = data << 10 | rem;
-    data ^= 0x5412; // uint15
+    return data ^ 0x5412; // uint15
+}
+
+// Draws two copies of the format bits (with its own error correction code)
+// based on the given mask and this object's error correction level field.
+static void drawFormatBits(BitBucket* modules, BitBucket* isFunction, uint8_t ecc, uint8_t mask) {
+    uint8_t size = modules->bitOffsetOrWidth;
+    uint32_t data = getFormatBits(ecc, mask);
 
     // Draw first copy
     for(uint8_t i = 0; i <= 5; i++) {
@@ -546,108 +551,368 @@ static void drawCodewords(BitBucket* modules, BitBucket* isFunction, BitBucket*
 #define PENALTY_N3 40
 #define PENALTY_N4 10
 
-// Calculates and returns the penalty score based on state of this QR Code's current modules.
-// This is used by the automatic mask choice algorithm to find the mask pattern that yields the lowest score.
-// @TODO: This can be optimized by working with the bytes instead of bits.
-static uint32_t getPenaltyScore(BitBucket* modules) {
-    uint32_t result = 0;
+// Rows are scored as arrays of 32 bit words, bit x of a row is bit (x % 32) of word x / 32
+#define ROW_WORDS(size) (((size) + 31) / 32)
+
+// Number of rows a finder-like pattern spans
+#define FINDER_ROWS 11
+
+// Finder-like patterns (dark = 1), from the lowest coordinate: 00001011101 and 10111010000
+#define FINDER_LIKE_A 0x5d0
+#define FINDER_LIKE_B 0x05d
+
+// Mask patterns repeat every 6 modules horizontally and every 12 modules vertically, so every
+// row of a pattern is a 96 bit block repeated: MASK_PATTERNS[mask][y % 12][(x / 32) % 3].
+static const uint32_t MASK_PATTERNS[8][12][3] = {
+    {
+        {0x55555555, 0x55555555, 0x55555555}, {0xaaaaaaaa, 0xaaaaaaaa, 0xaaaaaaaa},
+        {0x55555555, 0x55555555, 0x55555555}, {0xaaaaaaaa, 0xaaaaaaaa, 0xaaaaaaaa},
+        {0x55555555, 0x55555555, 0x55555555}, {0xaaaaaaaa, 0xaaaaaaaa, 0xaaaaaaaa},
+        {0x55555555, 0x55555555, 0x55555555}, {0xaaaaaaaa, 0xaaaaaaaa, 0xaaaaaaaa},
+        {0x55555555, 0x55555555, 0x55555555}, {0xaaaaaaaa, 0xaaaaaaaa, 0xaaaaaaaa},
+        {0x55555555, 0x55555555, 0x55555555}, {0xaaaaaaaa, 0xaaaaaaaa, 0xaaaaaaaa},
+    },
+    {
+        {0xffffffff, 0xffffffff, 0xffffffff}, {0x00000000, 0x00000000, 0x00000000},
+        {0xffffffff, 0xffffffff, 0xffffffff}, {0x00000000, 0x00000000, 0x00000000},
+        {0xffffffff, 0xffffffff, 0xffffffff}, {0x00000000, 0x00000000, 0x00000000},
+        {0xffffffff, 0xffffffff, 0xffffffff}, {0x00000000, 0x00000000, 0x00000000},
+        {0xffffffff, 0xffffffff, 0xffffffff}, {0x00000000, 0x00000000, 0x00000000},
+        {0xffffffff, 0xffffffff, 0xffffffff}, {0x00000000, 0x00000000, 0x00000000},
+    },
+    {
+        {0x49249249, 0x92492492, 0x24924924}, {0x49249249, 0x92492492, 0x24924924},
+        {0x49249249, 0x92492492, 0x24924924}, {0x49249249, 0x92492492, 0x24924924},
+        {0x49249249, 0x92492492, 0x24924924}, {0x49249249, 0x92492492, 0x24924924},
+        {0x49249249, 0x92492492, 0x24924924}, {0x49249249, 0x92492492, 0x24924924},
+        {0x49249249, 0x92492492, 0x24924924}, {0x49249249, 0x92492492, 0x24924924},
+        {0x49249249, 0x92492492, 0x24924924}, {0x49249249, 0x92492492, 0x24924924},
+    },
+    {
+        {0x49249249, 0x92492492, 0x24924924}, {0x24924924, 0x49249249, 0x92492492},
+        {0x92492492, 0x24924924, 0x49249249}, {0x49249249, 0x92492492, 0x24924924},
+        {0x24924924, 0x49249249, 0x92492492}, {0x92492492, 0x24924924, 0x49249249},
+        {0x49249249, 0x92492492, 0x24924924}, {0x24924924, 0x49249249, 0x92492492},
+        {0x92492492, 0x24924924, 0x49249249}, {0x49249249, 0x92492492, 0x24924924},
+        {0x24924924, 0x49249249, 0x92492492}, {0x92492492, 0x24924924, 0x49249249},
+    },
+    {
+        {0xc71c71c7, 0x71c71c71, 0x1c71c71c}, {0xc71c71c7, 0x71c71c71, 0x1c71c71c},
+        {0x38e38e38, 0x8e38e38e, 0xe38e38e3}, {0x38e38e38, 0x8e38e38e, 0xe38e38e3},
+        {0xc71c71c7, 0x71c71c71, 0x1c71c71c}, {0xc71c71c7, 0x71c71c71, 0x1c71c71c},
+        {0x38e38e38, 0x8e38e38e, 0xe38e38e3}, {0x38e38e38, 0x8e38e38e, 0xe38e38e3},
+        {0xc71c71c7, 0x71c71c71, 0x1c71c71c}, {0xc71c71c7, 0x71c71c71, 0x1c71c71c},
+        {0x38e38e38, 0x8e38e38e, 0xe38e38e3}, {0x38e38e38, 0x8e38e38e, 0xe38e38e3},
+    },
+    {
+        {0xffffffff, 0xffffffff, 0xffffffff}, {0x41041041, 0x10410410, 0x04104104},
+        {0x49249249, 0x92492492, 0x24924924}, {0x55555555, 0x55555555, 0x55555555},
+        {0x49249249, 0x92492492, 0x24924924}, {0x41041041, 0x10410410, 0x04104104},
+        {0xffffffff, 0xffffffff, 0xffffffff}, {0x41041041, 0x10410410, 0x04104104},
+        {0x49249249, 0x92492492, 0x24924924}, {0x55555555, 0x55555555, 0x55555555},
+        {0x49249249, 0x92492492, 0x24924924}, {0x41041041, 0x10410410, 0x04104104},
+    },
+    {
+        {0xffffffff, 0xffffffff, 0xffffffff}, {0xc71c71c7, 0x71c71c71, 0x1c71c71c},
+        {0xdb6db6db, 0xb6db6db6, 0x6db6db6d}, {0x55555555, 0x55555555, 0x55555555},
+        {0x6db6db6d, 0xdb6db6db, 0xb6db6db6}, {0x71c71c71, 0x1c71c71c, 0xc71c71c7},
+        {0xffffffff, 0xffffffff, 0xffffffff}, {0xc71c71c7, 0x71c71c71, 0x1c71c71c},
+        {0xdb6db6db, 0xb6db6db6, 0x6db6db6d}, {0x55555555, 0x55555555, 0x55555555},
+        {0x6db6db6d, 0xdb6db6db, 0xb6db6db6}, {0x71c71c71, 0x1c71c71c, 0xc71c71c7},
+    },
+    {
+        {0x55555555, 0x55555555, 0x55555555}, {0x38e38e38, 0x8e38e38e, 0xe38e38e3},
+        {0x71c71c71, 0x1c71c71c, 0xc71c71c7}, {0xaaaaaaaa, 0xaaaaaaaa, 0xaaaaaaaa},
+        {0xc71c71c7, 0x71c71c71, 0x1c71c71c}, {0x8e38e38e, 0xe38e38e3, 0x38e38e38},
+        {0x55555555, 0x55555555, 0x55555555}, {0x38e38e38, 0x8e38e38e, 0xe38e38e3},
+        {0x71c71c71, 0x1c71c71c, 0xc71c71c7}, {0xaaaaaaaa, 0xaaaaaaaa, 0xaaaaaaaa},
+        {0xc71c71c7, 0x71c71c71, 0x1c71c71c}, {0x8e38e38e, 0xe38e38e3, 0x38e38e38},
+    },
+};
+
+static uint8_t popcount(uint32_t v) {
+    v = v - ((v >> 1) & 0x55555555);
+    v = (v & 0x33333333) + ((v >> 2) & 0x33333333);
+    return (((v + (v >> 4)) & 0x0F0F0F0F) * 0x01010101) >> 24;
+}
+
+// Reads the row y of a grid, bits beyond the size are 0.
+static void bb_getRow(BitBucket* bitGrid, uint8_t y, uint32_t* row) {
+    uint8_t size = bitGrid->bitOffsetOrWidth;
+    memset(row, 0, ROW_WORDS(size) * sizeof(uint32_t));
+
+    for(uint8_t x = 0; x < size; x++) {
+        if(bb_getBit(bitGrid, x, y)) {
+            row[x >> 5] |= ((uint32_t)1) << (x & 31);
+        }
+    }
+}
+
+static void row_setBit(uint32_t* row, uint8_t x, bool on) {
+    if(on) {
+        row[x >> 5] |= ((uint32_t)1) << (x & 31);
+    } else {
+        row[x >> 5] &= ~(((uint32_t)1) << (x & 31));
+    }
+}
+
+// Writes the format bits that fall into row y, the same way drawFormatBits() does.
+static void row_setFormatBits(uint32_t* row, uint8_t y, uint8_t size, uint32_t data) {
+    if(y <= 5) {
+        row_setBit(row, 8, ((data >> y) & 1) != 0);
+    } else if(y == 7) {
+        row_setBit(row, 8, ((data >> 6) & 1) != 0);
+    } else if(y == 8) {
+        row_setBit(row, 8, ((data >> 7) & 1) != 0);
+        row_setBit(row, 7, ((data >> 8) & 1) != 0);
+
+        for(int8_t i = 9; i < 15; i++) {
+            row_setBit(row, 14 - i, ((data >> i) & 1) != 0);
+        }
+
+        for(int8_t i = 0; i <= 7; i++) {
+            row_setBit(row, size - 1 - i, ((data >> i) & 1) != 0);
+        }
+    } else if(y >= size - 7) {
+        row_setBit(row, 8, ((data >> (y - size + 15)) & 1) != 0);
+    }
+}
+
+// out = row >> n, i.e. bit x of out is bit x + n of the row (0 < n < 32)
+static void row_shift(const uint32_t* row, uint8_t n, uint32_t* out, uint8_t words) {
+    for(uint8_t i = 0; i < words; i++) {
+        out[i] = (row[i] >> n) | (i + 1 < words ? row[i + 1] << (32 - n) : 0);
+    }
+}
+
+// Counts bits of the row at x < limit.
+static uint16_t row_count(const uint32_t* row, int16_t limit, uint8_t words) {
+    uint16_t result = 0;
+
+    for(uint8_t i = 0; i < words && limit > 0; i++, limit -= 32) {
+        uint32_t v = row[i];
+        if(limit < 32) {
+            v &= (((uint32_t)1) << limit) - 1;
+        }
+        result += popcount(v);
+    }
+
+    return result;
+}
 
+// Calculates the penalty scores of all 8 masks applied to this QR Code's modules, which are
+// used by the automatic mask choice algorithm to find the mask pattern that yields the lowest
+// score. This is done in a single pass over the rows, the last FINDER_ROWS rows are kept to
+// find the vertical patterns and each rule is evaluated for 32 modules at a time.
+static void
+    getPenaltyScores(BitBucket* modules, BitBucket* isFunction, uint8_t ecc, uint32_t* scores) {
     uint8_t size = modules->bitOffsetOrWidth;
+    uint8_t words = ROW_WORDS(size);
+
+    // Unmasked rows (y % FINDER_ROWS) and the rows masked by the evaluated mask (y - index)
+    uint32_t data[FINDER_ROWS][words], function[FINDER_ROWS][words];
+    uint32_t masked[FINDER_ROWS][words];
+    uint32_t shifted[words], equal[words], run[words], finderA[words], finderB[words];
+    uint16_t black[8];
+
+    memset(scores, 0, 8 * sizeof(uint32_t));
+    memset(black, 0, sizeof(black));
 
-    // Adjacent modules in row having same color
     for(uint8_t y = 0; y < size; y++) {
-        bool colorX = bb_getBit(modules, 0, y);
-        for(uint8_t x = 1, runX = 1; x < size; x++) {
-            bool cx = bb_getBit(modules, x, y);
-            if(cx != colorX) {
-                colorX = cx;
-                runX = 1;
-
-            } else {
-                runX++;
-                if(runX == 5) {
-                    result += PENALTY_N1;
-                } else if(runX > 5) {
-                    result++;
+        bb_getRow(modules, y, data[y % FINDER_ROWS]);
+        bb_getRow(isFunction, y, function[y % FINDER_ROWS]);
+
+        uint8_t rows = y + 1 < FINDER_ROWS ? y + 1 : FINDER_ROWS;
+
+        for(uint8_t mask = 0; mask < 8; mask++) {
+            uint32_t result = 0;
+            uint32_t format = getFormatBits(ecc, mask);
+
+            for(uint8_t r = 0; r < rows; r++) {
+                uint8_t yy = y - r;
+                const uint32_t* pattern = MASK_PATTERNS[mask][yy % 12];
+
+                for(uint8_t i = 0; i < words; i++) {
+                    masked[r][i] = data[yy % FINDER_ROWS][i] ^
+                                   (pattern[i % 3] & ~function[yy % FINDER_ROWS][i]);
                 }
+
+                row_setFormatBits(masked[r], yy, size, format);
             }
-        }
-    }
 
-    // Adjacent modules in column having same color
-    for(uint8_t x = 0; x < size; x++) {
-        bool colorY = bb_getBit(modules, x, 0);
-        for(uint8_t y = 1, runY = 1; y < size; y++) {
-            bool cy = bb_getBit(modules, x, y);
-            if(cy != colorY) {
-                colorY = cy;
-                runY = 1;
-            } else {
-                runY++;
-                if(runY == 5) {
-                    result += PENALTY_N1;
-                } else if(runY > 5) {
-                    result++;
+            uint32_t* row = masked[0];
+
+            // Adjacent modules in row having same color: a run of n >= 5 modules contains
+            // n - 4 windows of 5 same modules, the first one costs PENALTY_N1 and the rest 1
+            row_shift(row, 1, shifted, words);
+            for(uint8_t i = 0; i < words; i++) {
+                equal[i] = ~(row[i] ^ shifted[i]);
+            }
+
+            memcpy(run, equal, sizeof(run));
+            for(uint8_t n = 1; n < 4; n++) {
+                row_shift(equal, n, shifted, words);
+                for(uint8_t i = 0; i < words; i++) {
+                    run[i] &= shifted[i];
                 }
             }
-        }
-    }
 
-    uint16_t black = 0;
-    for(uint8_t y = 0; y < size; y++) {
-        uint16_t bitsRow = 0, bitsCol = 0;
-        for(uint8_t x = 0; x < size; x++) {
-            bool color = bb_getBit(modules, x, y);
+            uint16_t windows = row_count(run, size - 4, words);
+            for(uint8_t i = 0; i < words; i++) {
+                shifted[i] = run[i] & ~((run[i] << 1) | (i > 0 ? run[i - 1] >> 31 : 0));
+            }
+            uint16_t runs = row_count(shifted, size - 4, words);
+            result += runs * PENALTY_N1 + (windows - runs);
+
+            // Adjacent modules in column having same color, the same way
+            if(y >= 4) {
+                for(uint8_t i = 0; i < words; i++) {
+                    run[i] = ~(masked[0][i] ^ masked[1][i]) & ~(masked[1][i] ^ masked[2][i]) &
+                             ~(masked[2][i] ^ masked[3][i]) & ~(masked[3][i] ^ masked[4][i]);
+                    shifted[i] = y >= 5 ? run[i] & ~(masked[4][i] ^ masked[5][i]) : 0;
+                    run[i] &= ~shifted[i];
+                }
+
+                result += row_count(run, size, words) * PENALTY_N1 +
+                          row_count(shifted, size, words);
+            }
 
             // 2*2 blocks of modules having same color
-            if(x > 0 && y > 0) {
-                bool colorUL = bb_getBit(modules, x - 1, y - 1);
-                bool colorUR = bb_getBit(modules, x, y - 1);
-                bool colorL = bb_getBit(modules, x - 1, y);
-                if(color == colorUL && color == colorUR && color == colorL) {
-                    result += PENALTY_N2;
+            if(y >= 1) {
+                for(uint8_t i = 0; i < words; i++) {
+                    run[i] = ~(masked[0][i] ^ masked[1][i]);
+                }
+
+                row_shift(run, 1, shifted, words);
+                for(uint8_t i = 0; i < words; i++) {
+                    shifted[i] &= run[i] & equal[i];
                 }
+
+                result += row_count(shifted, size - 1, words) * PENALTY_N2;
             }
 
-            // Finder-like pattern in rows and columns
-            bitsRow = ((bitsRow << 1) & 0x7FF) | color;
-            bitsCol = ((bitsCol << 1) & 0x7FF) | bb_getBit(modules, y, x);
+            // Finder-like pattern in rows
+            for(uint8_t i = 0; i < words; i++) {
+                finderA[i] = ~0;
+                finderB[i] = ~0;
+            }
 
-            // Needs 11 bits accumulated
-            if(x >= 10) {
-                if(bitsRow == 0x05D || bitsRow == 0x5D0) {
-                    result += PENALTY_N3;
+            for(uint8_t n = 0; n < FINDER_ROWS; n++) {
+                if(n > 0) {
+                    row_shift(row, n, shifted, words);
+                } else {
+                    memcpy(shifted, row, sizeof(shifted));
                 }
-                if(bitsCol == 0x05D || bitsCol == 0x5D0) {
-                    result += PENALTY_N3;
+
+                for(uint8_t i = 0; i < words; i++) {
+                    finderA[i] &= ((FINDER_LIKE_A >> n) & 1) ? shifted[i] : ~shifted[i];
+                    finderB[i] &= ((FINDER_LIKE_B >> n) & 1) ? shifted[i] : ~shifted[i];
                 }
             }
 
-            // Balance of black and white modules
-            if(color) {
-                black++;
+            for(uint8_t i = 0; i < words; i++) {
+                finderA[i] |= finderB[i];
             }
+            result += row_count(finderA, size - FINDER_ROWS + 1, words) * PENALTY_N3;
+
+            // Finder-like pattern in columns
+            if(y >= FINDER_ROWS - 1) {
+                for(uint8_t i = 0; i < words; i++) {
+                    finderA[i] = ~0;
+                    finderB[i] = ~0;
+
+                    for(uint8_t n = 0; n < FINDER_ROWS; n++) {
+                        uint32_t v = masked[FINDER_ROWS - 1 - n][i];
+                        finderA[i] &= ((FINDER_LIKE_A >> n) & 1) ? v : ~v;
+                        finderB[i] &= ((FINDER_LIKE_B >> n) & 1) ? v : ~v;
+                    }
+
+                    finderA[i] |= finderB[i];
+                }
+
+                result += row_count(finderA, size, words) * PENALTY_N3;
+            }
+
+            // Balance of black and white modules
+            black[mask] += row_count(row, size, words);
+
+            scores[mask] += result;
         }
     }
 
     // Find smallest k such that (45-5k)% <= dark/total <= (55+5k)%
     uint16_t total = size * size;
-    for(uint16_t k = 0; black * 20 < (9 - k) * total || black * 20 > (11 + k) * total; k++) {
-        result += PENALTY_N4;
+    for(uint8_t mask = 0; mask < 8; mask++) {
+        for(uint16_t k = 0;
+            black[mask] * 20 < (9 - k) * total || black[mask] * 20 > (11 + k) * total;
+            k++) {
+            scores[mask] += PENALTY_N4;
+        }
     }
-
-    return result;
 }
 
+// GF(2^8/0x11D) exponentials (antilogarithms) of the generator 0x02, doubled so that the sum of
+// two logarithms can be used as an index directly
+static const uint8_t GF_EXP[510] = {
+    0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x1d, 0x3a, 0x74, 0xe8, 0xcd, 0x87, 0x13, 0x26,
+    0x4c, 0x98, 0x2d, 0x5a, 0xb4, 0x75, 0xea, 0xc9, 0x8f, 0x03, 0x06, 0x0c, 0x18, 0x30, 0x60, 0xc0,
+    0x9d, 0x27, 0x4e, 0x9c, 0x25, 0x4a, 0x94, 0x35, 0x6a, 0xd4, 0xb5, 0x77, 0xee, 0xc1, 0x9f, 0x23,
+    0x46, 0x8c, 0x05, 0x0a, 0x14, 0x28, 0x50, 0xa0, 0x5d, 0xba, 0x69, 0xd2, 0xb9, 0x6f, 0xde, 0xa1,
+    0x5f, 0xbe, 0x61, 0xc2, 0x99, 0x2f, 0x5e, 0xbc, 0x65, 0xca, 0x89, 0x0f, 0x1e, 0x3c, 0x78, 0xf0,
+    0xfd, 0xe7, 0xd3, 0xbb, 0x6b, 0xd6, 0xb1, 0x7f, 0xfe, 0xe1, 0xdf, 0xa3, 0x5b, 0xb6, 0x71, 0xe2,
+    0xd9, 0xaf, 0x43, 0x86, 0x11, 0x22, 0x44, 0x88, 0x0d, 0x1a, 0x34, 0x68, 0xd0, 0xbd, 0x67, 0xce,
+    0x81, 0x1f, 0x3e, 0x7c, 0xf8, 0xed, 0xc7, 0x93, 0x3b, 0x76, 0xec, 0xc5, 0x97, 0x33, 0x66, 0xcc,
+    0x85, 0x17, 0x2e, 0x5c, 0xb8, 0x6d, 0xda, 0xa9, 0x4f, 0x9e, 0x21, 0x42, 0x84, 0x15, 0x2a, 0x54,
+    0xa8, 0x4d, 0x9a, 0x29, 0x52, 0xa4, 0x55, 0xaa, 0x49, 0x92, 0x39, 0x72, 0xe4, 0xd5, 0xb7, 0x73,
+    0xe6, 0xd1, 0xbf, 0x63, 0xc6, 0x91, 0x3f, 0x7e, 0xfc, 0xe5, 0xd7, 0xb3, 0x7b, 0xf6, 0xf1, 0xff,
+    0xe3, 0xdb, 0xab, 0x4b, 0x96, 0x31, 0x62, 0xc4, 0x95, 0x37, 0x6e, 0xdc, 0xa5, 0x57, 0xae, 0x41,
+    0x82, 0x19, 0x32, 0x64, 0xc8, 0x8d, 0x07, 0x0e, 0x1c, 0x38, 0x70, 0xe0, 0xdd, 0xa7, 0x53, 0xa6,
+    0x51, 0xa2, 0x59, 0xb2, 0x79, 0xf2, 0xf9, 0xef, 0xc3, 0x9b, 0x2b, 0x56, 0xac, 0x45, 0x8a, 0x09,
+    0x12, 0x24, 0x48, 0x90, 0x3d, 0x7a, 0xf4, 0xf5, 0xf7, 0xf3, 0xfb, 0xeb, 0xcb, 0x8b, 0x0b, 0x16,
+    0x2c, 0x58, 0xb0, 0x7d, 0xfa, 0xe9, 0xcf, 0x83, 0x1b, 0x36, 0x6c, 0xd8, 0xad, 0x47, 0x8e, 0x01,
+    0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x1d, 0x3a, 0x74, 0xe8, 0xcd, 0x87, 0x13, 0x26, 0x4c,
+    0x98, 0x2d, 0x5a, 0xb4, 0x75, 0xea, 0xc9, 0x8f, 0x03, 0x06, 0x0c, 0x18, 0x30, 0x60, 0xc0, 0x9d,
+    0x27, 0x4e, 0x9c, 0x25, 0x4a, 0x94, 0x35, 0x6a, 0xd4, 0xb5, 0x77, 0xee, 0xc1, 0x9f, 0x23, 0x46,
+    0x8c, 0x05, 0x0a, 0x14, 0x28, 0x50, 0xa0, 0x5d, 0xba, 0x69, 0xd2, 0xb9, 0x6f, 0xde, 0xa1, 0x5f,
+    0xbe, 0x61, 0xc2, 0x99, 0x2f, 0x5e, 0xbc, 0x65, 0xca, 0x89, 0x0f, 0x1e, 0x3c, 0x78, 0xf0, 0xfd,
+    0xe7, 0xd3, 0xbb, 0x6b, 0xd6, 0xb1, 0x7f, 0xfe, 0xe1, 0xdf, 0xa3, 0x5b, 0xb6, 0x71, 0xe2, 0xd9,
+    0xaf, 0x43, 0x86, 0x11, 0x22, 0x44, 0x88, 0x0d, 0x1a, 0x34, 0x68, 0xd0, 0xbd, 0x67, 0xce, 0x81,
+    0x1f, 0x3e, 0x7c, 0xf8, 0xed, 0xc7, 0x93, 0x3b, 0x76, 0xec, 0xc5, 0x97, 0x33, 0x66, 0xcc, 0x85,
+    0x17, 0x2e, 0x5c, 0xb8, 0x6d, 0xda, 0xa9, 0x4f, 0x9e, 0x21, 0x42, 0x84, 0x15, 0x2a, 0x54, 0xa8,
+    0x4d, 0x9a, 0x29, 0x52, 0xa4, 0x55, 0xaa, 0x49, 0x92, 0x39, 0x72, 0xe4, 0xd5, 0xb7, 0x73, 0xe6,
+    0xd1, 0xbf, 0x63, 0xc6, 0x91, 0x3f, 0x7e, 0xfc, 0xe5, 0xd7, 0xb3, 0x7b, 0xf6, 0xf1, 0xff, 0xe3,
+    0xdb, 0xab, 0x4b, 0x96, 0x31, 0x62, 0xc4, 0x95, 0x37, 0x6e, 0xdc, 0xa5, 0x57, 0xae, 0x41, 0x82,
+    0x19, 0x32, 0x64, 0xc8, 0x8d, 0x07, 0x0e, 0x1c, 0x38, 0x70, 0xe0, 0xdd, 0xa7, 0x53, 0xa6, 0x51,
+    0xa2, 0x59, 0xb2, 0x79, 0xf2, 0xf9, 0xef, 0xc3, 0x9b, 0x2b, 0x56, 0xac, 0x45, 0x8a, 0x09, 0x12,
+    0x24, 0x48, 0x90, 0x3d, 0x7a, 0xf4, 0xf5, 0xf7, 0xf3, 0xfb, 0xeb, 0xcb, 0x8b, 0x0b, 0x16, 0x2c,
+    0x58, 0xb0, 0x7d, 0xfa, 0xe9, 0xcf, 0x83, 0x1b, 0x36, 0x6c, 0xd8, 0xad, 0x47, 0x8e,
+};
+
+// GF(2^8/0x11D) logarithms, GF_LOG[0] is unused
+static const uint8_t GF_LOG[256] = {
+    0x00, 0x00, 0x01, 0x19, 0x02, 0x32, 0x1a, 0xc6, 0x03, 0xdf, 0x33, 0xee, 0x1b, 0x68, 0xc7, 0x4b,
+    0x04, 0x64, 0xe0, 0x0e, 0x34, 0x8d, 0xef, 0x81, 0x1c, 0xc1, 0x69, 0xf8, 0xc8, 0x08, 0x4c, 0x71,
+    0x05, 0x8a, 0x65, 0x2f, 0xe1, 0x24, 0x0f, 0x21, 0x35, 0x93, 0x8e, 0xda, 0xf0, 0x12, 0x82, 0x45,
+    0x1d, 0xb5, 0xc2, 0x7d, 0x6a, 0x27, 0xf9, 0xb9, 0xc9, 0x9a, 0x09, 0x78, 0x4d, 0xe4, 0x72, 0xa6,
+    0x06, 0xbf, 0x8b, 0x62, 0x66, 0xdd, 0x30, 0xfd, 0xe2, 0x98, 0x25, 0xb3, 0x10, 0x91, 0x22, 0x88,
+    0x36, 0xd0, 0x94, 0xce, 0x8f, 0x96, 0xdb, 0xbd, 0xf1, 0xd2, 0x13, 0x5c, 0x83, 0x38, 0x46, 0x40,
+    0x1e, 0x42, 0xb6, 0xa3, 0xc3, 0x48, 0x7e, 0x6e, 0x6b, 0x3a, 0x28, 0x54, 0xfa, 0x85, 0xba, 0x3d,
+    0xca, 0x5e, 0x9b, 0x9f, 0x0a, 0x15, 0x79, 0x2b, 0x4e, 0xd4, 0xe5, 0xac, 0x73, 0xf3, 0xa7, 0x57,
+    0x07, 0x70, 0xc0, 0xf7, 0x8c, 0x80, 0x63, 0x0d, 0x67, 0x4a, 0xde, 0xed, 0x31, 0xc5, 0xfe, 0x18,
+    0xe3, 0xa5, 0x99, 0x77, 0x26, 0xb8, 0xb4, 0x7c, 0x11, 0x44, 0x92, 0xd9, 0x23, 0x20, 0x89, 0x2e,
+    0x37, 0x3f, 0xd1, 0x5b, 0x95, 0xbc, 0xcf, 0xcd, 0x90, 0x87, 0x97, 0xb2, 0xdc, 0xfc, 0xbe, 0x61,
+    0xf2, 0x56, 0xd3, 0xab, 0x14, 0x2a, 0x5d, 0x9e, 0x84, 0x3c, 0x39, 0x53, 0x47, 0x6d, 0x41, 0xa2,
+    0x1f, 0x2d, 0x43, 0xd8, 0xb7, 0x7b, 0xa4, 0x76, 0xc4, 0x17, 0x49, 0xec, 0x7f, 0x0c, 0x6f, 0xf6,
+    0x6c, 0xa1, 0x3b, 0x52, 0x29, 0x9d, 0x55, 0xaa, 0xfb, 0x60, 0x86, 0xb1, 0xbb, 0xcc, 0x3e, 0x5a,
+    0xcb, 0x59, 0x5f, 0xb0, 0x9c, 0xa9, 0xa0, 0x51, 0x0b, 0xf5, 0x16, 0xeb, 0x7a, 0x75, 0x2c, 0xd7,
+    0x4f, 0xae, 0xd5, 0xe9, 0xe6, 0xe7, 0xad, 0xe8, 0x74, 0xd6, 0xf4, 0xea, 0xa8, 0x50, 0x58, 0xaf,
+};
+
 static uint8_t rs_multiply(uint8_t x, uint8_t y) {
-    // Russian peasant multiplication
-    // See: https://en.wikipedia.org/wiki/Ancient_Egyptian_multiplication
-    uint16_t z = 0;
-    for(int8_t i = 7; i >= 0; i--) {
-        z = (z << 1) ^ ((z >> 7) * 0x11D);
-        z ^= ((y >> i) & 1) * x;
+    if(x == 0 || y == 0) {
+        return 0;
     }
-    return z;
+    return GF_EXP[GF_LOG[x] + GF_LOG[y]];
 }
 
 static void rs_init(uint8_t degree, uint8_t* coeff) {
@@ -689,8 +954,15 @@ static void rs_getRemainder(
         }
         result[(degree - 1) * stride] = 0;
 
+        if(factor == 0) {
+            continue;
+        }
+
+        uint8_t factorLog = GF_LOG[factor];
         for(uint8_t j = 0; j < degree; j++) {
-            result[j * stride] ^= rs_multiply(coeff[j], factor);
+            if(coeff[j] != 0) {
+                result[j * stride] ^= GF_EXP[GF_LOG[coeff[j]] + factorLog];
+            }
         }
     }
 }
@@ -909,16 +1181,12 @@ int8_t qrcode_initBytes(
 
     // Find the best (lowest penalty) mask
     uint8_t mask = 0;
-    int32_t minPenalty = INT32_MAX;
-    for(uint8_t i = 0; i < 8; i++) {
-        drawFormatBits(&modulesGrid, &isFunctionGrid, eccFormatBits, i);
-        applyMask(&modulesGrid, &isFunctionGrid, i);
-        int penalty = getPenaltyScore(&modulesGrid);
-        if(penalty < minPenalty) {
+    uint32_t penalties[8];
+    getPenaltyScores(&modulesGrid, &isFunctionGrid, eccFormatBits, penalties);
+    for(uint8_t i = 1; i < 8; i++) {
+        if(penalties[i] < penalties[mask]) {
             mask = i;
-            minPenalty = penalty;
         }
-        applyMask(&modulesGrid, &isFunctionGrid, i); // Undoes the mask due to XOR
     }
 
     qrcode->mask = mask;
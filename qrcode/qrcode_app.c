@@ -17,6 +17,8 @@
 #define QRCODE_FILETYPE     "QRCode"
 #define QRCODE_FILE_VERSION 1
 
+#define QRCODE_BENCHMARK 0 // log how long it takes to generate a qrcode
+
 /** Valid modes are Numeric (0), Alpha-Numeric (1), and Binary (2) */
 #define MAX_QRCODE_MODE 2
 
@@ -400,6 +402,9 @@ static bool rebuild_qrcode(QRCodeApp* instance, uint8_t mode, uint8_t version, u
     uint16_t len = (uint16_t)furi_string_size(instance->message);
     instance->qrcode = qrcode_alloc(version);
 
+#if QRCODE_BENCHMARK
+    uint32_t start = furi_get_tick();
+#endif
     int8_t res = qrcode_initBytes(
         instance->qrcode,
         instance->qrcode->modules,
@@ -408,6 +413,10 @@ static bool rebuild_qrcode(QRCodeApp* instance, uint8_t mode, uint8_t version, u
         ecc,
         (uint8_t*)cstr,
         len);
+#if QRCODE_BENCHMARK
+    uint32_t elapsed = furi_get_tick() - start;
+    FURI_LOG_I(TAG, "Version %u, ecc %u generated in %lu ms", version, ecc, elapsed);
+#endif
     if(res != 0) {
         FURI_LOG_E(TAG, "Could not create qrcode");
 
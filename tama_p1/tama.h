@@ -10,9 +10,15 @@
 #define TAMA_LCD_ICON_SIZE       14
 #define TAMA_LCD_ICON_MARGIN     1
 
-#define STATE_FILE_MAGIC   "TLST"
-#define STATE_FILE_VERSION 2
-#define TAMA_SAVE_PATH     APP_DATA_PATH("save.bin")
+#define STATE_FILE_MAGIC      "TLST"
+#define STATE_FILE_VERSION    3 // RTC timestamp + tamalib snapshot
+#define STATE_FILE_VERSION_V2 2 // one field per write, still loaded
+#define TAMA_SAVE_PATH        APP_DATA_PATH("save.bin")
+
+#define TAMA_TICK_FREQUENCY        32768 // CPU ticks per second of game time
+#define TAMA_FAST_FORWARD_MAX_S    (60 * 60) // catch up at most one hour on load
+#define TAMA_FAST_FORWARD_CHUNK    (TAMA_TICK_FREQUENCY / 16) // CPU ticks per turbo run
+#define TAMA_FAST_FORWARD_SLICE_MS 20 // turbo time before GUI and input get the state
 
 typedef struct {
     FuriThread* thread;
@@ -22,7 +28,7 @@ typedef struct {
     uint32_t framebuffer[16];
     uint8_t icons;
     bool halted;
-    bool fast_forward_done;
+    uint32_t fast_forward_ticks; // game time still to catch up, sound and buttons are off
     bool buzzer_on;
     float frequency;
 } TamaApp;
@@ -1,5 +1,6 @@
 #include <furi.h>
 #include <furi_hal_bus.h>
+#include <furi_hal_rtc.h>
 #include <gui/gui.h>
 #include <input/input.h>
 #include <storage/storage.h>
@@ -428,6 +429,14 @@ static void tama_p1_draw_callback(Canvas* const canvas, void* cb_ctx) {
     } else if(g_ctx->halted) {
         canvas_set_font(canvas, FontPrimary);
         canvas_draw_str(canvas, 30, 30, "Halted");
+    } else if(g_ctx->fast_forward_ticks > 0 && !in_menu) {
+        canvas_set_font(canvas, FontPrimary);
+        canvas_draw_str(canvas, 30, 30, "Catching up");
+        canvas_set_font(canvas, FontSecondary);
+        char buf[24];
+        snprintf(
+            buf, sizeof(buf), "%lu s left", g_ctx->fast_forward_ticks / TAMA_TICK_FREQUENCY);
+        canvas_draw_str(canvas, 30, 42, buf);
     } else {
         if(in_menu) {
             // switch(layout_mode)
@@ -474,10 +483,44 @@ static void tama_p1_update_timer_callback(void* ctx) {
     furi_message_queue_put(event_queue, &event, 0);
 }
 
+// Let the pet live through the time the app was closed, up to
+// TAMA_FAST_FORWARD_MAX_S seconds. The stepping thread catches up in slices.
+static void tama_p1_fast_forward(uint32_t saved_at) {
+    uint32_t now = furi_hal_rtc_get_timestamp();
+    if(saved_at == 0 || now <= saved_at) return;
+
+    uint32_t seconds = now - saved_at;
+    if(seconds > TAMA_FAST_FORWARD_MAX_S) seconds = TAMA_FAST_FORWARD_MAX_S;
+
+    FURI_LOG_I(TAG, "Fast forwarding %lu s", seconds);
+    g_ctx->fast_forward_ticks = seconds * TAMA_TICK_FREQUENCY;
+}
+
+// Run catch-up emulation for at most TAMA_FAST_FORWARD_SLICE_MS, with the state mutex held
+static uint32_t tama_p1_fast_forward_slice() {
+    uint32_t start = furi_get_tick();
+    uint32_t steps = 0;
+    while(g_ctx->fast_forward_ticks > 0 &&
+          furi_get_tick() - start < furi_ms_to_ticks(TAMA_FAST_FORWARD_SLICE_MS)) {
+        uint32_t ticks = MIN(g_ctx->fast_forward_ticks, (uint32_t)TAMA_FAST_FORWARD_CHUNK);
+        steps += tamalib_fast_forward(ticks);
+        g_ctx->fast_forward_ticks -= ticks;
+    }
+
+    if(g_ctx->fast_forward_ticks == 0) {
+        // Buzzer was muted while catching up, bring it up to date
+        tamalib_refresh_hw();
+    }
+    return steps;
+}
+
 static void tama_p1_load_state() {
     state_t* state;
     uint8_t buf[4];
     bool error = false;
+    bool loaded = false;
+    uint8_t version;
+    uint32_t saved_at = 0;
     state = tamalib_get_state();
 
     Storage* storage = furi_record_open(RECORD_STORAGE);
@@ -491,11 +534,28 @@ static void tama_p1_load_state() {
         }
 
         storage_file_read(file, &buf, 1);
-        if(buf[0] != STATE_FILE_VERSION) {
+        version = buf[0];
+        if(version != STATE_FILE_VERSION && version != STATE_FILE_VERSION_V2) {
             FURI_LOG_E(TAG, "FATAL: Unsupported version");
             error = true;
         }
-        if(!error) {
+        if(!error && version == STATE_FILE_VERSION) {
+            uint8_t* snapshot = malloc(TAMALIB_SNAPSHOT_SIZE);
+            uint32_t start = furi_get_tick();
+
+            storage_file_read(file, &buf, 4);
+            saved_at = buf[0] | (buf[1] << 8) | (buf[2] << 16) | (buf[3] << 24);
+
+            if(storage_file_read(file, snapshot, TAMALIB_SNAPSHOT_SIZE) ==
+                   TAMALIB_SNAPSHOT_SIZE &&
+               tamalib_load_snapshot(snapshot, TAMALIB_SNAPSHOT_SIZE)) {
+                FURI_LOG_D(TAG, "Snapshot restored in %lu ms", furi_get_tick() - start);
+                loaded = true;
+            } else {
+                FURI_LOG_E(TAG, "Truncated snapshot in \"%s\"", TAMA_SAVE_PATH);
+            }
+            free(snapshot);
+        } else if(!error) {
             FURI_LOG_D(TAG, "Reading save.bin");
 
             storage_file_read(file, &buf, 2);
@@ -578,15 +638,17 @@ static void tama_p1_load_state() {
     storage_file_close(file);
     storage_file_free(file);
     furi_record_close(RECORD_STORAGE);
+
+    if(loaded) {
+        tama_p1_fast_forward(saved_at);
+    }
 }
 
 static void tama_p1_save_state() {
     // Saving state
     FURI_LOG_D(TAG, "Saving Gamestate");
     uint8_t buf[4];
-    state_t* state;
     uint32_t offset = 0;
-    state = tamalib_get_state();
 
     Storage* storage = furi_record_open(RECORD_STORAGE);
     File* file = storage_file_alloc(storage);
@@ -601,88 +663,20 @@ static void tama_p1_save_state() {
         buf[0] = STATE_FILE_VERSION & 0xFF;
         offset += storage_file_write(file, &buf, 1);
 
-        buf[0] = *(state->pc) & 0xFF;
-        buf[1] = (*(state->pc) >> 8) & 0x1F;
-        offset += storage_file_write(file, &buf, 2);
-
-        buf[0] = *(state->x) & 0xFF;
-        buf[1] = (*(state->x) >> 8) & 0xF;
-        offset += storage_file_write(file, &buf, 2);
-
-        buf[0] = *(state->y) & 0xFF;
-        buf[1] = (*(state->y) >> 8) & 0xF;
-        offset += storage_file_write(file, &buf, 2);
-
-        buf[0] = *(state->a) & 0xF;
-        offset += storage_file_write(file, &buf, 1);
-
-        buf[0] = *(state->b) & 0xF;
-        offset += storage_file_write(file, &buf, 1);
-
-        buf[0] = *(state->np) & 0x1F;
-        offset += storage_file_write(file, &buf, 1);
-
-        buf[0] = *(state->sp) & 0xFF;
-        offset += storage_file_write(file, &buf, 1);
-
-        buf[0] = *(state->flags) & 0xF;
-        offset += storage_file_write(file, &buf, 1);
-
-        buf[0] = *(state->tick_counter) & 0xFF;
-        buf[1] = (*(state->tick_counter) >> 8) & 0xFF;
-        buf[2] = (*(state->tick_counter) >> 16) & 0xFF;
-        buf[3] = (*(state->tick_counter) >> 24) & 0xFF;
-        offset += storage_file_write(file, &buf, sizeof(buf));
-
-        buf[0] = *(state->clk_timer_timestamp) & 0xFF;
-        buf[1] = (*(state->clk_timer_timestamp) >> 8) & 0xFF;
-        buf[2] = (*(state->clk_timer_timestamp) >> 16) & 0xFF;
-        buf[3] = (*(state->clk_timer_timestamp) >> 24) & 0xFF;
-        offset += storage_file_write(file, &buf, sizeof(buf));
-
-        buf[0] = *(state->prog_timer_timestamp) & 0xFF;
-        buf[1] = (*(state->prog_timer_timestamp) >> 8) & 0xFF;
-        buf[2] = (*(state->prog_timer_timestamp) >> 16) & 0xFF;
-        buf[3] = (*(state->prog_timer_timestamp) >> 24) & 0xFF;
-        offset += storage_file_write(file, &buf, sizeof(buf));
-
-        buf[0] = *(state->prog_timer_enabled) & 0x1;
-        offset += storage_file_write(file, &buf, 1);
-
-        buf[0] = *(state->prog_timer_data) & 0xFF;
-        offset += storage_file_write(file, &buf, 1);
-
-        buf[0] = *(state->prog_timer_rld) & 0xFF;
-        offset += storage_file_write(file, &buf, 1);
-
-        buf[0] = *(state->call_depth) & 0xFF;
-        buf[1] = (*(state->call_depth) >> 8) & 0xFF;
-        buf[2] = (*(state->call_depth) >> 16) & 0xFF;
-        buf[3] = (*(state->call_depth) >> 24) & 0xFF;
+        // Game time not caught up yet is still owed on the next load
+        uint32_t now = furi_hal_rtc_get_timestamp() -
+                       g_ctx->fast_forward_ticks / TAMA_TICK_FREQUENCY;
+        buf[0] = now & 0xFF;
+        buf[1] = (now >> 8) & 0xFF;
+        buf[2] = (now >> 16) & 0xFF;
+        buf[3] = (now >> 24) & 0xFF;
         offset += storage_file_write(file, &buf, sizeof(buf));
 
-        for(uint32_t i = 0; i < INT_SLOT_NUM; i++) {
-            buf[0] = state->interrupts[i].factor_flag_reg & 0xF;
-            offset += storage_file_write(file, &buf, 1);
-
-            buf[0] = state->interrupts[i].mask_reg & 0xF;
-            offset += storage_file_write(file, &buf, 1);
-
-            buf[0] = state->interrupts[i].triggered & 0x1;
-            offset += storage_file_write(file, &buf, 1);
-        }
-
-        /* First 640 half bytes correspond to the RAM */
-        for(uint32_t i = 0; i < MEM_RAM_SIZE; i++) {
-            buf[0] = GET_RAM_MEMORY(state->memory, i + MEM_RAM_ADDR) & 0xF;
-            offset += storage_file_write(file, &buf, 1);
-        }
-
-        /* I/Os are from 0xF00 to 0xF7F */
-        for(uint32_t i = 0; i < MEM_IO_SIZE; i++) {
-            buf[0] = GET_IO_MEMORY(state->memory, i + MEM_IO_ADDR) & 0xF;
-            offset += storage_file_write(file, &buf, 1);
-        }
+        // Whole CPU state in one write
+        uint8_t* snapshot = malloc(TAMALIB_SNAPSHOT_SIZE);
+        uint32_t size = tamalib_save_snapshot(snapshot);
+        offset += storage_file_write(file, snapshot, size);
+        free(snapshot);
     }
     storage_file_close(file);
     storage_file_free(file);
@@ -701,10 +695,27 @@ static int32_t tama_p1_worker(void* context) {
     LL_TIM_EnableCounter(TIM2);
 
     tama_p1_load_state();
+    uint32_t fast_forward_start = furi_get_tick();
+    uint32_t fast_forward_steps = 0;
 
     while(running) {
         if(furi_thread_flags_get()) {
             running = false;
+        } else if(g_ctx->fast_forward_ticks > 0) {
+            fast_forward_steps += tama_p1_fast_forward_slice();
+            if(g_ctx->fast_forward_ticks == 0) {
+                FURI_LOG_I(
+                    TAG,
+                    "Fast forwarded %lu instructions in %lu ms",
+                    fast_forward_steps,
+                    furi_get_tick() - fast_forward_start);
+            }
+
+            // Let GUI and input have the state in between slices
+            furi_mutex_release(mutex);
+            furi_delay_tick(1);
+            while(furi_mutex_acquire(mutex, FuriWaitForever) != FuriStatusOk)
+                furi_delay_tick(1);
         } else {
             // FURI_LOG_D(TAG, "Stepping"); // enabling this cause blank screen somehow
             // for (int i = 0; i < 100; ++i)
@@ -773,9 +784,6 @@ static void tama_p1_init(TamaApp* const ctx) {
         tamalib_init((u12_t*)ctx->rom, NULL, 64000);
         tamalib_set_speed(speed);
 
-        // TODO: implement fast forwarding
-        // ctx->fast_forward_done = true;
-
         // Start stepping thread
         ctx->thread = furi_thread_alloc();
         furi_thread_set_name(ctx->thread, "TamaLIB");
@@ -1159,6 +1167,8 @@ int32_t tama_p1_app(void* p) {
                         }
                         if(event.input.key == m && event.input.type == InputTypePress) {
                             in_menu = true;
+                        } else if(g_ctx->fast_forward_ticks > 0) {
+                            // Pet doesn't take buttons while catching up
                         } else if(event.input.key == a) {
                             tamalib_set_button(BTN_LEFT, tama_btn_state);
                         } else if(event.input.key == b) {
@@ -169,6 +169,7 @@ static u32_t tick_counter = 0;
 static u32_t ts_freq;
 static u8_t speed_ratio = 1;
 static timestamp_t ref_ts;
+static bool_t turbo_mode = 0;
 
 static state_t cpu_state = {
     .pc = &pc,
@@ -227,6 +228,14 @@ void cpu_free_bp(breakpoint_t** list) {
     *list = NULL;
 }
 
+void cpu_set_turbo(bool_t turbo) {
+    turbo_mode = turbo;
+}
+
+bool_t cpu_get_turbo(void) {
+    return turbo_mode;
+}
+
 void cpu_set_speed(u8_t speed) {
     speed_ratio = speed;
 }
@@ -1817,11 +1826,39 @@ static const op_t ops[] = {
     {NULL, 0, 0, 0, 0, 0, NULL},
 };
 
+#define OP_UNKNOWN 0xFF
+
+/* Index in ops[] of every 12-bit opcode, so that cpu_step() does not have
+ * to scan the table. Built by build_op_table() at init.
+ */
+static u8_t op_table[4096];
+
+static void build_op_table(void) {
+    u12_t op;
+    u8_t i;
+
+    for(op = 0; op < 4096; op++) {
+        /* First match wins, like the linear lookup it replaces */
+        for(i = 0; ops[i].log != NULL; i++) {
+            if((op & ops[i].mask) == ops[i].code) {
+                break;
+            }
+        }
+
+        op_table[op] = (ops[i].log != NULL) ? i : OP_UNKNOWN;
+    }
+}
+
 static timestamp_t wait_for_cycles(timestamp_t since, u8_t cycles) {
     timestamp_t deadline;
 
     tick_counter += cycles;
 
+    if(turbo_mode) {
+        /* No real time reference at all */
+        return since;
+    }
+
     if(speed_ratio == 0) {
         /* Emulation will be as fast as possible */
         return g_hal->get_timestamp();
@@ -1858,7 +1895,7 @@ static void process_interrupts(void) {
 static void print_state(u8_t op_num, u12_t op, u13_t addr) {
     u8_t i;
 
-    if(!g_hal->is_log_enabled(LOG_CPU)) {
+    if(turbo_mode || !g_hal->is_log_enabled(LOG_CPU)) {
         return;
     }
 
@@ -1928,11 +1965,128 @@ void cpu_reset(void) {
     cpu_sync_ref_timestamp();
 }
 
+static const struct {
+    u12_t addr;
+    u12_t size;
+} snapshot_mem_locs[] = {
+    {MEM_RAM_ADDR, MEM_RAM_SIZE},
+    {MEM_DISPLAY1_ADDR, MEM_DISPLAY1_SIZE},
+    {MEM_DISPLAY2_ADDR, MEM_DISPLAY2_SIZE},
+    {MEM_IO_ADDR, MEM_IO_SIZE},
+};
+
+static u8_t* put_u32(u8_t* p, u32_t v) {
+    p[0] = v & 0xFF;
+    p[1] = (v >> 8) & 0xFF;
+    p[2] = (v >> 16) & 0xFF;
+    p[3] = (v >> 24) & 0xFF;
+    return p + 4;
+}
+
+static u32_t get_u32(const u8_t* p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((u32_t)p[3] << 24);
+}
+
+u32_t cpu_save_snapshot(u8_t* buf) {
+    u8_t* p = buf;
+    u8_t triggered = 0;
+
+    *p++ = pc & 0xFF;
+    *p++ = (pc >> 8) & 0x1F;
+    *p++ = x & 0xFF;
+    *p++ = (x >> 8) & 0xF;
+    *p++ = y & 0xFF;
+    *p++ = (y >> 8) & 0xF;
+    *p++ = a & 0xF;
+    *p++ = b & 0xF;
+    *p++ = np & 0x1F;
+    *p++ = sp;
+    *p++ = flags & 0xF;
+
+    p = put_u32(p, tick_counter);
+    p = put_u32(p, clk_timer_timestamp);
+    p = put_u32(p, prog_timer_timestamp);
+    *p++ = prog_timer_enabled & 0x1;
+    *p++ = prog_timer_data;
+    *p++ = prog_timer_rld;
+    p = put_u32(p, call_depth);
+
+    for(u8_t i = 0; i < INT_SLOT_NUM; i++) {
+        *p++ = (interrupts[i].factor_flag_reg & 0xF) | ((interrupts[i].mask_reg & 0xF) << 4);
+        triggered |= (interrupts[i].triggered & 0x1) << i;
+    }
+    *p++ = triggered;
+
+    for(u8_t i = 0; i < sizeof(snapshot_mem_locs) / sizeof(snapshot_mem_locs[0]); i++) {
+        u12_t end = snapshot_mem_locs[i].addr + snapshot_mem_locs[i].size;
+
+        for(u12_t n = snapshot_mem_locs[i].addr; n < end; n += 2) {
+            *p++ = GET_MEMORY(memory, n) | (GET_MEMORY(memory, n + 1) << 4);
+        }
+    }
+
+    return p - buf;
+}
+
+bool_t cpu_load_snapshot(const u8_t* buf, u32_t size) {
+    const u8_t* p = buf;
+    u8_t triggered;
+
+    if(size < CPU_SNAPSHOT_SIZE) {
+        return 0;
+    }
+
+    pc = p[0] | ((p[1] & 0x1F) << 8);
+    x = p[2] | ((p[3] & 0xF) << 8);
+    y = p[4] | ((p[5] & 0xF) << 8);
+    a = p[6] & 0xF;
+    b = p[7] & 0xF;
+    np = p[8] & 0x1F;
+    sp = p[9];
+    flags = p[10] & 0xF;
+    p += 11;
+
+    tick_counter = get_u32(p);
+    clk_timer_timestamp = get_u32(p + 4);
+    prog_timer_timestamp = get_u32(p + 8);
+    p += 12;
+    prog_timer_enabled = *p++ & 0x1;
+    prog_timer_data = *p++;
+    prog_timer_rld = *p++;
+    call_depth = get_u32(p);
+    p += 4;
+
+    triggered = p[INT_SLOT_NUM];
+    for(u8_t i = 0; i < INT_SLOT_NUM; i++) {
+        interrupts[i].factor_flag_reg = p[i] & 0xF;
+        interrupts[i].mask_reg = (p[i] >> 4) & 0xF;
+        interrupts[i].triggered = (triggered >> i) & 0x1;
+    }
+    p += INT_SLOT_NUM + 1;
+
+    for(u8_t i = 0; i < sizeof(snapshot_mem_locs) / sizeof(snapshot_mem_locs[0]); i++) {
+        u12_t end = snapshot_mem_locs[i].addr + snapshot_mem_locs[i].size;
+
+        for(u12_t n = snapshot_mem_locs[i].addr; n < end; n += 2) {
+            SET_MEMORY(memory, n, *p & 0xF);
+            SET_MEMORY(memory, n + 1, (*p >> 4) & 0xF);
+            p++;
+        }
+    }
+
+    /* Push the restored display and buzzer state to the HAL */
+    cpu_refresh_hw();
+    cpu_sync_ref_timestamp();
+
+    return 1;
+}
+
 bool_t cpu_init(const u12_t* program, breakpoint_t* breakpoints, u32_t freq) {
     g_program = program;
     g_breakpoints = breakpoints;
     ts_freq = freq;
 
+    build_op_table();
     cpu_reset();
 
     return 0;
@@ -1950,13 +2104,9 @@ int cpu_step(void) {
     op = g_program[pc];
 
     /* Lookup the OP code */
-    for(i = 0; ops[i].log != NULL; i++) {
-        if((op & ops[i].mask) == ops[i].code) {
-            break;
-        }
-    }
+    i = op_table[op & 0xFFF];
 
-    if(ops[i].log == NULL) {
+    if(i == OP_UNKNOWN) {
         g_hal->log(LOG_ERROR, "Unknown op-code 0x%X (pc = 0x%04X)\n", op, pc);
         return 1;
     }
@@ -207,6 +207,23 @@ void cpu_refresh_hw(void);
 
 void cpu_reset(void);
 
+/* Turbo mode: run without waiting for the real time and without display,
+ * sound and log callbacks. cpu_refresh_hw() brings the HAL up to date when
+ * leaving it.
+ */
+void cpu_set_turbo(bool_t turbo);
+bool_t cpu_get_turbo(void);
+
+/* Snapshot: registers, timers, interrupts and all the memory (nibbles packed
+ * two per byte) in a flat little endian buffer of CPU_SNAPSHOT_SIZE bytes
+ */
+#define CPU_SNAPSHOT_MEM_SIZE \
+    ((MEM_RAM_SIZE + MEM_DISPLAY1_SIZE + MEM_DISPLAY2_SIZE + MEM_IO_SIZE) / 2)
+#define CPU_SNAPSHOT_SIZE (30 + INT_SLOT_NUM + 1 + CPU_SNAPSHOT_MEM_SIZE)
+
+u32_t cpu_save_snapshot(u8_t* buf);
+bool_t cpu_load_snapshot(const u8_t* buf, u32_t size);
+
 bool_t cpu_init(const u12_t* program, breakpoint_t* breakpoints, u32_t freq);
 void cpu_release(void);
 
@@ -39,6 +39,11 @@ void hw_release(void) {
 }
 
 void hw_set_lcd_pin(u8_t seg, u8_t com, u8_t val) {
+    if(cpu_get_turbo()) {
+        /* Repainted by cpu_refresh_hw() when leaving turbo mode */
+        return;
+    }
+
     if(seg_pos[seg] < LCD_WIDTH) {
         g_hal->set_lcd_matrix(seg_pos[seg], com, val);
     } else {
@@ -82,6 +87,10 @@ void hw_set_button(button_t btn, btn_state_t state) {
 void hw_set_buzzer_freq(u4_t freq) {
     u32_t snd_freq = 0;
 
+    if(cpu_get_turbo()) {
+        return;
+    }
+
     switch(freq) {
     case 0:
         /* 4096.0 Hz */
@@ -130,5 +139,9 @@ void hw_set_buzzer_freq(u4_t freq) {
 }
 
 void hw_enable_buzzer(bool_t en) {
+    if(cpu_get_turbo()) {
+        return;
+    }
+
     g_hal->play_frequency(en);
 }
@@ -126,3 +126,27 @@ void tamalib_mainloop(void) {
         }
     }
 }
+
+u32_t tamalib_fast_forward(u32_t ticks) {
+    state_t* state = cpu_get_state();
+    u32_t start = *(state->tick_counter);
+    u32_t steps = 0;
+
+    cpu_set_turbo(1);
+
+    while(*(state->tick_counter) - start < ticks) {
+        steps++;
+        if(cpu_step()) {
+            /* Breakpoint */
+            break;
+        }
+    }
+
+    cpu_set_turbo(0);
+
+    /* Bring the display and buzzer up to date, and resume in real time */
+    cpu_refresh_hw();
+    cpu_sync_ref_timestamp();
+
+    return steps;
+}
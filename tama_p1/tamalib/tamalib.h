@@ -33,6 +33,11 @@
 
 #define tamalib_reset() cpu_reset()
 
+#define tamalib_set_turbo(turbo)          cpu_set_turbo(turbo)
+#define tamalib_save_snapshot(buf)        cpu_save_snapshot(buf)
+#define tamalib_load_snapshot(buf, size)  cpu_load_snapshot(buf, size)
+#define TAMALIB_SNAPSHOT_SIZE             CPU_SNAPSHOT_SIZE
+
 #define tamalib_add_bp(list, addr) cpu_add_bp(list, addr)
 #define tamalib_free_bp(list)      cpu_free_bp(list)
 
@@ -62,4 +67,10 @@ void tamalib_set_exec_mode(exec_mode_t mode);
 void tamalib_step(void);
 void tamalib_mainloop(void);
 
+/* Run the emulation for the given number of CPU ticks (32768 per second of
+ * game time) in turbo mode, as fast as possible. Returns the number of
+ * executed instructions.
+ */
+u32_t tamalib_fast_forward(u32_t ticks);
+
 #endif /* _TAMALIB_H_ */
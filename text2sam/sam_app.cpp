@@ -17,7 +17,10 @@
 
 #define SAM_SAVE_PATH    APP_DATA_PATH("message.txt")
 #define TEXT_BUFFER_SIZE 256
+#define PCM_BUFFER_SIZE  2048 // ring buffer played by DMA, ~64 ms
+#define SAM_BENCHMARK    0 // log how much faster than real time speech renders
 STM32SAM voice;
+unsigned char pcm_buffer[PCM_BUFFER_SIZE];
 
 typedef enum {
     EventTypeTick,
@@ -37,10 +40,45 @@ typedef struct {
 
 AppState* app_state;
 
+#if SAM_BENCHMARK
+static void count_samples(const unsigned char* samples, uint32_t count, void* context) {
+    UNUSED(samples);
+    *((uint32_t*)context) += count;
+}
+
+static void benchmark(char* something) {
+    // the second pass finds the phonemes in the cache
+    for(int pass = 0; pass < 2; pass++) {
+        uint32_t samples = 0;
+        voice.renderTo(pcm_buffer, PCM_BUFFER_SIZE, count_samples, &samples);
+        uint32_t start = furi_get_tick();
+        voice.say(something);
+        uint32_t elapsed = furi_get_tick() - start;
+        voice.end();
+
+        uint32_t audio_ms = samples * 1000 / voice.getSampleRate();
+        FURI_LOG_I(
+            TAG,
+            "%s: rendered %lu ms of speech (%lu samples) in %lu ms, %lu.%02lux real time",
+            pass ? "Warm" : "Cold",
+            audio_ms,
+            samples,
+            elapsed,
+            audio_ms / (elapsed ? elapsed : 1),
+            (audio_ms * 100 / (elapsed ? elapsed : 1)) % 100);
+    }
+}
+#endif
+
 static void say_something(char* something) {
+#if SAM_BENCHMARK
+    benchmark(something);
+#endif
+
     if(furi_hal_speaker_is_mine() || furi_hal_speaker_acquire(1000)) {
-        voice.begin();
+        voice.beginBuffered(pcm_buffer, PCM_BUFFER_SIZE);
         voice.say(something);
+        voice.end();
         furi_hal_speaker_release();
     }
 }
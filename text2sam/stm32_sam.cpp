@@ -2423,6 +2423,16 @@ void STM32SAM::Output8BitAry(int index, unsigned char ary[5]) {
     bufferpos += timetable[oldtimetableindex][index];
     oldtimetableindex = index;
 
+    if(ringBuffer != NULL) {
+        // output the samples up to the new position, there are 5 values for them
+        uint32_t end = ((uint64_t)bufferpos * ringStep) >> 16;
+
+        for(k = 0; ringSample < end; k++, ringSample++)
+            PutSample(ary[k < 5 ? k : 4]);
+
+        return;
+    }
+
     int sample_uS = bufferpos - bufferposOld;
 
     uint32_t f = 0;
@@ -3478,6 +3488,7 @@ void STM32SAM::SetInput(char* _input) {
 
 void STM32SAM::Init() {
     bufferpos = 0;
+    ringSample = 0;
     int i;
     SetMouthThroat();
 
@@ -3552,7 +3563,9 @@ int STM32SAM::SAMMain() {
 
     //mem[40158] = 255;
 
+    CacheStore();
     PrepareOutput();
+    FlushOutput();
 
     return 1;
 }
@@ -5261,6 +5274,15 @@ STM32SAM::STM32SAM(uint32_t STM32SAM_SPEED /* = 5 */) {
     mem59 = 0;
 
     oldtimetableindex = 0;
+
+    ringBuffer = NULL;
+    ringStarted = false;
+
+    for(int i = 0; i < STM32SAM_CACHE_ENTRIES; i++)
+        cache[i].lastUse = 0;
+
+    cacheClock = 0;
+    cachePending = -1;
 }
 
 STM32SAM::STM32SAM() {
@@ -5282,6 +5304,15 @@ STM32SAM::STM32SAM() {
     mem59 = 0;
 
     oldtimetableindex = 0;
+
+    ringBuffer = NULL;
+    ringStarted = false;
+
+    for(int i = 0; i < STM32SAM_CACHE_ENTRIES; i++)
+        cache[i].lastUse = 0;
+
+    cacheClock = 0;
+    cachePending = -1;
 }
 
 /*
@@ -5351,6 +5382,8 @@ void STM32SAM::sam(
         }
     }
 
+    if(CacheLookup(input)) return;
+
     if(!phonetic) {
         strncat(input, "[", 256);
         if(!TextToPhonemes((unsigned char*)input)) {
@@ -5402,6 +5435,8 @@ void STM32SAM::sam(
         }
     }
 
+    if(CacheLookup(input)) return;
+
     if(i < 256) {
         input[i] = phonetic ? '\x9b' : '[';
     }
@@ -5617,6 +5652,73 @@ void STM32SAM::setMouth(unsigned char _mouth /* = 128 */) {
 void STM32SAM::setThroat(unsigned char _throat /* = 128 */) {
     throat = _throat;
 }
+
+////////////////////////////////////////////////////////////////////////////////////////////
+//
+//           Phoneme cache
+//
+////////////////////////////////////////////////////////////////////////////////////////////
+
+// Says the phrase if its phonemes are cached and returns true, otherwise
+// picks the least recently used entry to be filled by CacheStore().
+bool STM32SAM::CacheLookup(const char* text) {
+    int i, j;
+    int victim = 0;
+
+    cachePending = -1;
+
+    for(i = 0; i < STM32SAM_CACHE_ENTRIES; i++) {
+        CacheEntry* e = &cache[i];
+
+        if(e->lastUse != 0 && e->phonetic == phonetic && strcmp(e->text, text) == 0) {
+            e->lastUse = ++cacheClock;
+
+            Init();
+
+            for(j = 0; j < STM32SAM_CACHE_PHONEMES; j++) {
+                phonemeindex[j] = e->index[j];
+                phonemeLength[j] = e->length[j];
+                stress[j] = e->stress[j];
+
+                if(e->index[j] == 255) break;
+            }
+
+            PrepareOutput();
+            FlushOutput();
+            return true;
+        }
+
+        if(e->lastUse < cache[victim].lastUse) victim = i;
+    }
+
+    if(STM32SAM_CACHE_ENTRIES > 0 && strlen(text) < STM32SAM_CACHE_TEXT) {
+        cachePending = victim;
+        cache[victim].lastUse = 0; // until the phonemes are stored
+        strcpy(cache[victim].text, text);
+        cache[victim].phonetic = phonetic;
+    }
+
+    return false;
+}
+
+void STM32SAM::CacheStore() {
+    if(cachePending < 0) return;
+
+    CacheEntry* e = &cache[cachePending];
+
+    cachePending = -1;
+
+    for(int i = 0; i < STM32SAM_CACHE_PHONEMES; i++) {
+        e->index[i] = phonemeindex[i];
+        e->length[i] = phonemeLength[i];
+        e->stress[i] = stress[i];
+
+        if(phonemeindex[i] == 255) {
+            e->lastUse = ++cacheClock;
+            return;
+        }
+    }
+}
 ////////////////////////////////////////////////////////////////////////////////////////////
 //
 //           Hardware
@@ -5629,6 +5731,7 @@ void STM32SAM::setThroat(unsigned char _throat /* = 128 */) {
 
 #include <math.h>
 #include <stm32wbxx_ll_tim.h>
+#include <stm32wbxx_ll_dma.h>
 
 #define FURI_HAL_SPEAKER_TIMER   TIM16
 #define FURI_HAL_SPEAKER_CHANNEL LL_TIM_CHANNEL_CH1
@@ -5703,3 +5806,160 @@ inline void STM32SAM::SetAUDIO(unsigned char main_volume) {
 
     LL_TIM_OC_SetCompareCH1(FURI_HAL_SPEAKER_TIMER, data);
 }
+
+////////////////////////////////////////////////////////////////////////////////////////////
+//
+//           Ring buffer output
+//
+////////////////////////////////////////////////////////////////////////////////////////////
+
+#define STM32SAM_DMA           DMA1, LL_DMA_CHANNEL_1
+#define STM32SAM_PWM_FREQUENCY 250000 // 64 MHz timer clock, no prescaler, 256 ticks
+
+uint32_t STM32SAM::getSampleRate(void) {
+    // Output8BitAry() waits 5 / (_STM32SAM_SPEED + 1) us per bufferpos unit
+    // and original SAM outputs a sample per 50 units
+    return (_STM32SAM_SPEED + 1) * 4000;
+}
+
+void STM32SAM::SetRing(unsigned char* buffer, uint32_t size, uint32_t rate) {
+    ringBuffer = buffer;
+    ringSize = size;
+    ringHead = 0;
+    ringSample = 0;
+    ringStarted = false;
+    ringStep = ((uint64_t)rate << 16) / ((_STM32SAM_SPEED + 1) * 200000);
+}
+
+void STM32SAM::beginBuffered(unsigned char* buffer, uint32_t size) {
+    // update event (= DMA request) every rcr + 1 PWM periods
+    uint32_t rcr = (STM32SAM_PWM_FREQUENCY + getSampleRate() / 2) / getSampleRate() - 1;
+
+    if(rcr > 255) rcr = 255;
+
+    SetRing(buffer, size, STM32SAM_PWM_FREQUENCY / (rcr + 1));
+    ringCallback = NULL;
+
+    for(int i = 0; i < 256; i++) {
+        float data = tanhf((i / 255.0f - 0.5f) * 4.0f);
+
+        data = (data + 0.5f) * 255.0f;
+        ringShape[i] = data < 0 ? 0 : (data > 255 ? 255 : (unsigned char)data);
+    }
+
+    LL_TIM_InitTypeDef TIM_InitStruct;
+    memset(&TIM_InitStruct, 0, sizeof(LL_TIM_InitTypeDef));
+    TIM_InitStruct.Prescaler = 0;
+    TIM_InitStruct.Autoreload = 255;
+    TIM_InitStruct.RepetitionCounter = rcr;
+    LL_TIM_Init(FURI_HAL_SPEAKER_TIMER, &TIM_InitStruct);
+
+    LL_TIM_OC_InitTypeDef TIM_OC_InitStruct;
+    memset(&TIM_OC_InitStruct, 0, sizeof(LL_TIM_OC_InitTypeDef));
+    TIM_OC_InitStruct.OCMode = LL_TIM_OCMODE_PWM1;
+    TIM_OC_InitStruct.OCState = LL_TIM_OCSTATE_ENABLE;
+    TIM_OC_InitStruct.CompareValue = ringShape[128];
+    LL_TIM_OC_Init(FURI_HAL_SPEAKER_TIMER, FURI_HAL_SPEAKER_CHANNEL, &TIM_OC_InitStruct);
+
+    // 8 bit samples are zero extended to the 16 bit compare register
+    LL_DMA_ConfigAddresses(
+        STM32SAM_DMA,
+        (uint32_t)buffer,
+        (uint32_t)&(FURI_HAL_SPEAKER_TIMER->CCR1),
+        LL_DMA_DIRECTION_MEMORY_TO_PERIPH);
+    LL_DMA_SetPeriphRequest(STM32SAM_DMA, LL_DMAMUX_REQ_TIM16_UP);
+    LL_DMA_SetDataTransferDirection(STM32SAM_DMA, LL_DMA_DIRECTION_MEMORY_TO_PERIPH);
+    LL_DMA_SetChannelPriorityLevel(STM32SAM_DMA, LL_DMA_PRIORITY_VERYHIGH);
+    LL_DMA_SetMode(STM32SAM_DMA, LL_DMA_MODE_CIRCULAR);
+    LL_DMA_SetPeriphIncMode(STM32SAM_DMA, LL_DMA_PERIPH_NOINCREMENT);
+    LL_DMA_SetMemoryIncMode(STM32SAM_DMA, LL_DMA_MEMORY_INCREMENT);
+    LL_DMA_SetPeriphSize(STM32SAM_DMA, LL_DMA_PDATAALIGN_HALFWORD);
+    LL_DMA_SetMemorySize(STM32SAM_DMA, LL_DMA_MDATAALIGN_BYTE);
+
+    LL_TIM_EnableAllOutputs(FURI_HAL_SPEAKER_TIMER);
+    LL_TIM_EnableCounter(FURI_HAL_SPEAKER_TIMER);
+}
+
+void STM32SAM::renderTo(
+    unsigned char* buffer,
+    uint32_t size,
+    PCMCallback callback,
+    void* context) {
+    SetRing(buffer, size, getSampleRate());
+    ringCallback = callback;
+    ringContext = context;
+}
+
+void STM32SAM::end(void) {
+    if(ringBuffer != NULL && ringCallback == NULL) {
+        LL_TIM_DisableDMAReq_UPDATE(FURI_HAL_SPEAKER_TIMER);
+        LL_DMA_DisableChannel(STM32SAM_DMA);
+    }
+
+    ringBuffer = NULL;
+    ringStarted = false;
+}
+
+void STM32SAM::PutSample(unsigned char sample) {
+    if(ringCallback != NULL) {
+        ringBuffer[ringHead++] = sample;
+
+        if(ringHead == ringSize) {
+            ringCallback(ringBuffer, ringSize, ringContext);
+            ringHead = 0;
+        }
+
+        return;
+    }
+
+    if(ringStarted) {
+        uint32_t readPos = ringSize - LL_DMA_GetDataLength(STM32SAM_DMA);
+
+        if(readPos == ringSize) readPos = 0;
+
+        if(readPos == ringHead) {
+            // full, sleep until the DMA has played a quarter of the ring
+            do {
+                furi_delay_tick(1);
+                readPos = ringSize - LL_DMA_GetDataLength(STM32SAM_DMA);
+            } while((readPos + ringSize - ringHead) % ringSize < ringSize / 4);
+        }
+    }
+
+    ringBuffer[ringHead++] = ringShape[sample];
+
+    if(ringHead == ringSize) {
+        ringHead = 0;
+
+        if(!ringStarted) {
+            LL_DMA_DisableChannel(STM32SAM_DMA);
+            LL_DMA_SetDataLength(STM32SAM_DMA, ringSize);
+            LL_DMA_EnableChannel(STM32SAM_DMA);
+            LL_TIM_EnableDMAReq_UPDATE(FURI_HAL_SPEAKER_TIMER);
+            ringStarted = true;
+        }
+    }
+}
+
+void STM32SAM::FlushOutput() {
+    if(ringBuffer == NULL) return;
+
+    if(ringCallback != NULL) {
+        if(ringHead != 0) ringCallback(ringBuffer, ringHead, ringContext);
+
+        ringHead = 0;
+        return;
+    }
+
+    if(!ringStarted && ringHead == 0) return;
+
+    // push the rest of the utterance through with a ring of silence
+    for(uint32_t i = 0; i < ringSize; i++)
+        PutSample(128);
+
+    LL_TIM_DisableDMAReq_UPDATE(FURI_HAL_SPEAKER_TIMER);
+    LL_DMA_DisableChannel(STM32SAM_DMA);
+    LL_TIM_OC_SetCompareCH1(FURI_HAL_SPEAKER_TIMER, ringShape[128]);
+    ringStarted = false;
+    ringHead = 0;
+}
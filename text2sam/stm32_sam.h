@@ -3,6 +3,15 @@
 #ifndef __STM32SAM__
 #define __STM32SAM__
 
+// Phrases whose phonemes are kept, so that saying them again skips the text
+// to phoneme rules and the parsers. Only phrases up to STM32SAM_CACHE_TEXT - 1
+// characters and STM32SAM_CACHE_PHONEMES phonemes are cached.
+#ifndef STM32SAM_CACHE_ENTRIES
+#define STM32SAM_CACHE_ENTRIES 4
+#endif
+#define STM32SAM_CACHE_TEXT     64
+#define STM32SAM_CACHE_PHONEMES 96
+
 // SAM Text-To-Speech (TTS), ported from https://github.com/s-macke/SAM
 
 class STM32SAM {
@@ -47,8 +56,27 @@ public:
     void setMouth(unsigned char _mouth = 128);
     void setThroat(unsigned char _throat = 128);
 
+    // Ring buffer output. Instead of writing every sample to the speaker
+    // timer and busy waiting in between, render 8 bit unsigned PCM into a
+    // caller supplied buffer (at least 256 bytes) that is either played by
+    // timer+DMA (beginBuffered, speaker must be acquired) or handed to a
+    // callback each time it's full (renderTo, as fast as the CPU allows).
+    // end() switches back to direct output, call begin() before using it.
+    typedef void (*PCMCallback)(const unsigned char* samples, uint32_t count, void* context);
+
+    void beginBuffered(unsigned char* buffer, uint32_t size);
+    void renderTo(unsigned char* buffer, uint32_t size, PCMCallback callback, void* context);
+    void end(void);
+    uint32_t getSampleRate(void); // of renderTo, matching the direct output speed
+
 private:
     void SetAUDIO(unsigned char main_volume);
+    void SetRing(unsigned char* buffer, uint32_t size, uint32_t rate);
+    void PutSample(unsigned char sample);
+    void FlushOutput();
+
+    bool CacheLookup(const char* text);
+    void CacheStore();
 
     void Output8BitAry(int index, unsigned char ary[5]);
     void Output8Bit(int index, unsigned char A);
@@ -91,6 +119,31 @@ private:
     unsigned char phonetic;
     unsigned char singmode;
 
+    unsigned char* ringBuffer;
+    uint32_t ringSize;
+    uint32_t ringHead;
+    uint32_t ringStep; // output samples per bufferpos unit, 16.16 fixed point
+    uint32_t ringSample; // samples output of the current utterance
+    PCMCallback ringCallback; // NULL = DMA playback
+    void* ringContext;
+    bool ringStarted;
+    unsigned char ringShape[256]; // speaker curve of SetAUDIO for DMA playback
+
+    // The synthesis tables are shared by all instances (one speaks at a
+    // time), the phoneme cache belongs to the instance.
+    struct CacheEntry {
+        char text[STM32SAM_CACHE_TEXT];
+        unsigned char phonetic;
+        uint32_t lastUse; // 0 = empty
+        unsigned char index[STM32SAM_CACHE_PHONEMES];
+        unsigned char length[STM32SAM_CACHE_PHONEMES];
+        unsigned char stress[STM32SAM_CACHE_PHONEMES];
+    };
+
+    CacheEntry cache[STM32SAM_CACHE_ENTRIES];
+    uint32_t cacheClock;
+    int cachePending; // entry to fill by the phrase being parsed, -1 = none
+
 }; // STM32SAM class
 
 #endif
@@ -44,3 +44,6 @@
 #ifndef TOTP_UI_NO_ADD_NEW_TOKEN
 #define TOTP_UI_ADD_NEW_TOKEN_ENABLED
 #endif
+
+// Enables\disables logging of token offsets index build time and worst-case navigation latency
+// #define TOTP_TOKEN_INDEX_BENCHMARK_ENABLED
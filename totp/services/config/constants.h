@@ -4,6 +4,7 @@
 #include "../../config/app/config.h"
 
 #define CONFIG_FILE_DIRECTORY_PATH EXT_PATH("apps_data/totp")
+#define CONFIG_FILE_PATH CONFIG_FILE_DIRECTORY_PATH "/totp.conf"
 #define CONFIG_FILE_HEADER "Flipper TOTP plugin config file"
 #define CONFIG_FILE_ACTUAL_VERSION (14)
 
@@ -7,7 +7,18 @@
 #include "../../types/crypto_settings.h"
 
 #define CONFIG_FILE_PART_FILE_PATH CONFIG_FILE_DIRECTORY_PATH "/totp.conf.part"
+#define CONFIG_FILE_INDEX_FILE_PATH CONFIG_FILE_DIRECTORY_PATH "/totp.conf.idx"
+#define CONFIG_FILE_INDEX_VERSION (1)
 #define STREAM_COPY_BUFFER_SIZE (128)
+#define TOKEN_OFFSETS_INITIAL_CAPACITY (16)
+#define TOKEN_START_MARKER "\n" TOTP_CONFIG_KEY_TOKEN_NAME ":"
+
+typedef struct {
+    uint32_t version;
+    uint32_t config_file_size;
+    uint32_t config_file_timestamp;
+    uint32_t count;
+} TokenOffsetsIndexHeader;
 
 struct TokenInfoIteratorContext {
     size_t total_count;
@@ -18,6 +29,25 @@ struct TokenInfoIteratorContext {
     FlipperFormat* config_file;
     CryptoSettings* crypto_settings;
     Storage* storage;
+
+    /**
+     * @brief Offset of the line feed preceding each token start, in token order
+     */
+    uint32_t* token_offsets;
+    size_t token_offsets_count;
+    size_t token_offsets_capacity;
+
+    /**
+     * @brief Config file size \c token_offsets are valid for
+     */
+    size_t indexed_file_size;
+    bool index_valid;
+
+    /**
+     * @brief Whether index file on the SD card matches \c token_offsets
+     */
+    bool index_persisted;
+    uint32_t index_persisted_timestamp;
 };
 
 static bool
@@ -38,7 +68,7 @@ static bool
             break;
         }
 
-        if(strncmp(buffer, "\n" TOTP_CONFIG_KEY_TOKEN_NAME ":", sizeof(buffer)) == 0) {
+        if(strncmp(buffer, TOKEN_START_MARKER, sizeof(buffer)) == 0) {
             found = true;
         }
     }
@@ -46,54 +76,178 @@ static bool
     return found;
 }
 
-static bool seek_to_token(size_t token_index, TokenInfoIteratorContext* context) {
-    furi_check(context != NULL && context->config_file != NULL);
-    if(token_index >= context->total_count) {
+static bool is_token_start(Stream* stream, size_t offset) {
+    char buffer[sizeof(TOKEN_START_MARKER) - 1];
+    if(!stream_seek(stream, offset, StreamOffsetFromStart) ||
+       stream_read(stream, (uint8_t*)&buffer[0], sizeof(buffer)) != sizeof(buffer) ||
+       !stream_seek(stream, offset, StreamOffsetFromStart)) {
         return false;
     }
 
+    return strncmp(buffer, TOKEN_START_MARKER, sizeof(buffer)) == 0;
+}
+
+static void token_offsets_reserve(TokenInfoIteratorContext* context, size_t capacity) {
+    if(capacity <= context->token_offsets_capacity) {
+        return;
+    }
+
+    size_t new_capacity = context->token_offsets_capacity > 0 ?
+                              context->token_offsets_capacity :
+                              TOKEN_OFFSETS_INITIAL_CAPACITY;
+    while(new_capacity < capacity) {
+        new_capacity <<= 1;
+    }
+
+    context->token_offsets = realloc(context->token_offsets, new_capacity * sizeof(uint32_t));
+    furi_check(context->token_offsets != NULL);
+    context->token_offsets_capacity = new_capacity;
+}
+
+static void token_offsets_shift(TokenInfoIteratorContext* context, size_t from_index, long delta) {
+    for(size_t i = from_index; i < context->token_offsets_count; i++) {
+        context->token_offsets[i] += delta;
+    }
+}
+
+static void token_offsets_invalidate(TokenInfoIteratorContext* context) {
+    context->index_valid = false;
+    context->index_persisted = false;
+}
+
+static void token_offsets_rebuild(TokenInfoIteratorContext* context) {
     Stream* stream = flipper_format_get_raw_stream(context->config_file);
-    long token_index_diff = (long)token_index - (long)context->last_seek_index;
-    size_t token_index_diff_weight = (size_t)labs(token_index_diff);
-    StreamDirection direction = token_index_diff >= 0 ? StreamDirectionForward :
-                                                        StreamDirectionBackward;
-    if(token_index_diff_weight > token_index || context->last_seek_offset == 0) {
-        context->last_seek_offset = 0;
-        context->last_seek_index = 0;
-        token_index_diff = token_index + 1;
-        direction = StreamDirectionForward;
-    } else if(token_index_diff_weight > (context->total_count - token_index - 1)) {
-        context->last_seek_offset = stream_size(stream);
-        context->last_seek_index = context->total_count - 1;
-        token_index_diff = -(long)(context->total_count - token_index);
-        direction = StreamDirectionBackward;
+    context->token_offsets_count = 0;
+    stream_rewind(stream);
+    while(flipper_format_seek_to_siblinig_token_start(stream, StreamDirectionForward)) {
+        token_offsets_reserve(context, context->token_offsets_count + 1);
+        context->token_offsets[context->token_offsets_count++] = stream_tell(stream);
     }
 
-    if(!stream_seek(stream, context->last_seek_offset, StreamOffsetFromStart)) {
+    context->indexed_file_size = stream_size(stream);
+    context->index_valid = true;
+    context->index_persisted = false;
+}
+
+static bool token_offsets_load(TokenInfoIteratorContext* context) {
+    uint32_t timestamp;
+    if(storage_common_timestamp(context->storage, CONFIG_FILE_PATH, &timestamp) != FSE_OK) {
         return false;
     }
 
-    if(token_index_diff != 0) {
-        long i = 0;
-        long i_inc = token_index_diff >= 0 ? 1 : -1;
-        do {
-            if(!flipper_format_seek_to_siblinig_token_start(stream, direction)) {
-                break;
-            }
+    Stream* config_stream = flipper_format_get_raw_stream(context->config_file);
+    size_t config_file_size = stream_size(config_stream);
+    Stream* index_stream = file_stream_alloc(context->storage);
+    bool result = false;
+    do {
+        if(!file_stream_open(
+               index_stream, CONFIG_FILE_INDEX_FILE_PATH, FSAM_READ, FSOM_OPEN_EXISTING)) {
+            break;
+        }
+
+        TokenOffsetsIndexHeader header;
+        if(stream_read(index_stream, (uint8_t*)&header, sizeof(header)) != sizeof(header)) {
+            break;
+        }
 
-            i += i_inc;
-        } while((i_inc > 0 && i < token_index_diff) || (i_inc < 0 && i > token_index_diff));
+        if(header.version != CONFIG_FILE_INDEX_VERSION ||
+           header.config_file_size != config_file_size ||
+           header.config_file_timestamp != timestamp ||
+           header.count > config_file_size / (sizeof(TOKEN_START_MARKER) - 1)) {
+            break;
+        }
 
-        if((i_inc > 0 && i < token_index_diff) || (i_inc < 0 && i > token_index_diff)) {
-            context->last_seek_offset = 0;
-            FURI_LOG_D(LOGGING_TAG, "Was not able to move");
-            return false;
+        token_offsets_reserve(context, header.count);
+        size_t offsets_size = header.count * sizeof(uint32_t);
+        if(stream_read(index_stream, (uint8_t*)context->token_offsets, offsets_size) !=
+           offsets_size) {
+            break;
+        }
+
+        // Cheap sanity check, every other offset is verified on access anyway
+        if(header.count > 0 &&
+           (!is_token_start(config_stream, context->token_offsets[0]) ||
+            !is_token_start(config_stream, context->token_offsets[header.count - 1]))) {
+            break;
         }
 
-        context->last_seek_offset = stream_tell(stream);
-        context->last_seek_index = token_index;
+        context->token_offsets_count = header.count;
+        context->indexed_file_size = config_file_size;
+        context->index_valid = true;
+        context->index_persisted = true;
+        context->index_persisted_timestamp = timestamp;
+        result = true;
+    } while(false);
+
+    file_stream_close(index_stream);
+    stream_free(index_stream);
+
+    return result;
+}
+
+static void token_offsets_persist(TokenInfoIteratorContext* context) {
+    FileInfo file_info;
+    uint32_t timestamp;
+    if(!context->index_valid ||
+       storage_common_stat(context->storage, CONFIG_FILE_PATH, &file_info) != FSE_OK ||
+       file_info.size != context->indexed_file_size ||
+       storage_common_timestamp(context->storage, CONFIG_FILE_PATH, &timestamp) != FSE_OK) {
+        storage_simply_remove(context->storage, CONFIG_FILE_INDEX_FILE_PATH);
+        return;
     }
 
+    if(context->index_persisted && context->index_persisted_timestamp == timestamp) {
+        return;
+    }
+
+    TokenOffsetsIndexHeader header = {
+        .version = CONFIG_FILE_INDEX_VERSION,
+        .config_file_size = context->indexed_file_size,
+        .config_file_timestamp = timestamp,
+        .count = context->token_offsets_count};
+
+    Stream* index_stream = file_stream_alloc(context->storage);
+    size_t offsets_size = context->token_offsets_count * sizeof(uint32_t);
+    if(!file_stream_open(
+           index_stream, CONFIG_FILE_INDEX_FILE_PATH, FSAM_WRITE, FSOM_CREATE_ALWAYS) ||
+       stream_write(index_stream, (const uint8_t*)&header, sizeof(header)) != sizeof(header) ||
+       stream_write(index_stream, (const uint8_t*)context->token_offsets, offsets_size) !=
+           offsets_size) {
+        file_stream_close(index_stream);
+        storage_simply_remove(context->storage, CONFIG_FILE_INDEX_FILE_PATH);
+    } else {
+        file_stream_close(index_stream);
+    }
+
+    stream_free(index_stream);
+}
+
+static bool seek_to_token(size_t token_index, TokenInfoIteratorContext* context) {
+    furi_check(context != NULL && context->config_file != NULL);
+    if(token_index >= context->total_count) {
+        return false;
+    }
+
+    Stream* stream = flipper_format_get_raw_stream(context->config_file);
+    bool found = context->index_valid && context->indexed_file_size == stream_size(stream) &&
+                 token_index < context->token_offsets_count &&
+                 is_token_start(stream, context->token_offsets[token_index]);
+    if(!found) {
+        // Config file has been changed behind the index back, so it has to be rebuilt
+        token_offsets_rebuild(context);
+        found = token_index < context->token_offsets_count &&
+                is_token_start(stream, context->token_offsets[token_index]);
+    }
+
+    if(!found) {
+        context->last_seek_offset = 0;
+        FURI_LOG_D(LOGGING_TAG, "Was not able to move");
+        return false;
+    }
+
+    context->last_seek_offset = context->token_offsets[token_index];
+    context->last_seek_index = token_index;
+
     return true;
 }
 
@@ -156,6 +310,10 @@ static bool
         return false;
     }
 
+    size_t size_before = stream_size(stream);
+    bool index_in_sync = context->index_valid && context->indexed_file_size == size_before &&
+                         context->token_offsets_count == context->total_count;
+
     FlipperFormat* temp_ff = flipper_format_file_alloc(context->storage);
     if(!flipper_format_file_open_always(temp_ff, CONFIG_FILE_PART_FILE_PATH)) {
         flipper_format_free(temp_ff);
@@ -240,6 +398,21 @@ static bool
             break;
         }
 
+        if(!index_in_sync) {
+            token_offsets_invalidate(context);
+        } else if(is_new_token) {
+            token_offsets_reserve(context, context->token_offsets_count + 1);
+            context->token_offsets[context->token_offsets_count++] = offset_start - 1;
+        } else {
+            token_offsets_shift(
+                context,
+                context->current_index + 1,
+                (long)stream_size(stream) - (long)size_before);
+        }
+
+        context->indexed_file_size = stream_size(stream);
+        context->index_persisted = false;
+
         if(is_new_token) {
             context->total_count++;
         }
@@ -247,6 +420,10 @@ static bool
         result = true;
     } while(false);
 
+    if(!result) {
+        token_offsets_invalidate(context);
+    }
+
     flipper_format_free(temp_ff);
     storage_common_remove(context->storage, CONFIG_FILE_PART_FILE_PATH);
 
@@ -257,34 +434,82 @@ static bool
     return result;
 }
 
+#ifdef TOTP_TOKEN_INDEX_BENCHMARK_ENABLED
+static void token_offsets_benchmark(TokenInfoIteratorContext* context, uint32_t open_ticks) {
+    uint32_t scan_ticks = furi_get_tick();
+    token_offsets_rebuild(context);
+    scan_ticks = furi_get_tick() - scan_ticks;
+
+    // Jumping between both ends of the list is the worst case for sibling token walking
+    uint32_t worst_ticks = 0;
+    for(size_t i = 0; i < context->total_count; i++) {
+        size_t token_index = (i & 1) ? i >> 1 : context->total_count - 1 - (i >> 1);
+        uint32_t ticks = furi_get_tick();
+        totp_token_info_iterator_go_to(context, token_index);
+        ticks = furi_get_tick() - ticks;
+        if(ticks > worst_ticks) {
+            worst_ticks = ticks;
+        }
+    }
+
+    uint32_t tick_frequency = furi_kernel_get_tick_frequency();
+    FURI_LOG_I(
+        LOGGING_TAG,
+        "Token index: %zu tokens, open %lu ms, full scan %lu ms, worst go_to %lu ms",
+        context->total_count,
+        open_ticks * 1000 / tick_frequency,
+        scan_ticks * 1000 / tick_frequency,
+        worst_ticks * 1000 / tick_frequency);
+}
+#endif
+
 TokenInfoIteratorContext* totp_token_info_iterator_alloc(
     Storage* storage,
     FlipperFormat* config_file,
     CryptoSettings* crypto_settings) {
-    Stream* stream = flipper_format_get_raw_stream(config_file);
-    stream_rewind(stream);
-    size_t tokens_count = 0;
-    while(true) {
-        if(!flipper_format_seek_to_siblinig_token_start(stream, StreamDirectionForward)) {
-            break;
-        }
-
-        tokens_count++;
-    }
-
     TokenInfoIteratorContext* context = malloc(sizeof(TokenInfoIteratorContext));
     furi_check(context != NULL);
 
-    context->total_count = tokens_count;
+    context->current_index = 0;
+    context->last_seek_offset = 0;
+    context->last_seek_index = 0;
     context->current_token = token_info_alloc();
     context->config_file = config_file;
     context->crypto_settings = crypto_settings;
     context->storage = storage;
+    context->token_offsets = NULL;
+    context->token_offsets_count = 0;
+    context->token_offsets_capacity = 0;
+    context->index_valid = false;
+    context->index_persisted = false;
+
+#ifdef TOTP_TOKEN_INDEX_BENCHMARK_ENABLED
+    uint32_t open_ticks = furi_get_tick();
+#endif
+    if(!token_offsets_load(context)) {
+        token_offsets_rebuild(context);
+    }
+#ifdef TOTP_TOKEN_INDEX_BENCHMARK_ENABLED
+    open_ticks = furi_get_tick() - open_ticks;
+#endif
+
+    context->total_count = context->token_offsets_count;
+
+#ifdef TOTP_TOKEN_INDEX_BENCHMARK_ENABLED
+    token_offsets_benchmark(context, open_ticks);
+    context->current_index = 0;
+#endif
+
     return context;
 }
 
 void totp_token_info_iterator_free(TokenInfoIteratorContext* context) {
     if(context == NULL) return;
+    token_offsets_persist(context);
+    if(context->token_offsets != NULL) {
+        free(context->token_offsets);
+    }
+
     token_info_free(context->current_token);
     free(context);
 }
@@ -309,11 +534,31 @@ bool totp_token_info_iterator_remove_current_token_info(TokenInfoIteratorContext
         return false;
     }
 
+    size_t size_before = stream_size(stream);
+    bool index_in_sync = context->index_valid && context->indexed_file_size == size_before &&
+                         context->token_offsets_count == context->total_count;
+
     if(!stream_seek(stream, begin_offset, StreamOffsetFromStart) ||
        !stream_delete(stream, end_offset - begin_offset)) {
+        token_offsets_invalidate(context);
         return false;
     }
 
+    if(index_in_sync) {
+        size_t next_index = context->current_index + 1;
+        memmove(
+            &context->token_offsets[context->current_index],
+            &context->token_offsets[next_index],
+            (context->token_offsets_count - next_index) * sizeof(uint32_t));
+        context->token_offsets_count--;
+        token_offsets_shift(
+            context, context->current_index, -(long)(end_offset - begin_offset));
+        context->indexed_file_size = stream_size(stream);
+        context->index_persisted = false;
+    } else {
+        token_offsets_invalidate(context);
+    }
+
     context->total_count--;
     if(context->current_index >= context->total_count) {
         context->current_index = context->total_count - 1;
@@ -374,6 +619,7 @@ bool totp_token_info_iterator_move_current_token_info(
             break;
         }
 
+        token_offsets_invalidate(context);
         if(!stream_delete(stream, moving_size)) {
             break;
         }
@@ -394,6 +640,7 @@ bool totp_token_info_iterator_move_current_token_info(
     stream_free(temp_stream);
     storage_common_remove(context->storage, CONFIG_FILE_PART_FILE_PATH);
 
+    token_offsets_invalidate(context);
     context->last_seek_offset = 0;
     context->last_seek_index = 0;
 